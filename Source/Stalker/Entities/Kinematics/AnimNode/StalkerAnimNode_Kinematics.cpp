@@ -3,9 +3,12 @@
 #include "Resources/SkeletonMesh/StalkerKinematicsData.h"
 #include "Resources/SkeletonMesh/StalkerKinematicsAnimData.h"
 
+DECLARE_CYCLE_STAT(TEXT("XRay ~ Kinematics FX"), STAT_XRayEngineKinematicsFX, STATGROUP_XRayEngine);
+
 FStalkerAnimNode_Kinematics::FStalkerAnimNode_Kinematics()
 {
 	AnimMode = EStalkerKinematicsAnimMode::Base;
+	ExtractRootMotion = false;
 }
 
 void FStalkerAnimNode_Kinematics::SetAnimMode(EStalkerKinematicsAnimMode NewMode)
@@ -23,22 +26,63 @@ void FStalkerAnimNode_Kinematics::CacheBones_AnyThread(const FAnimationCacheBone
 	if (IsValid(Owner) && Owner->KinematicsData)
 	{
 		const FBoneContainer& BoneContainer = Context.AnimInstanceProxy->GetRequiredBones();
-		Bones.Empty(Owner->Bones.Num());
-		Bones.AddDefaulted(Owner->Bones.Num());
-		for (int32 i = 0; i < Owner->Bones.Num(); i++)
+		Bones.Empty(Owner->SharedData->Bones.Num());
+		Bones.AddDefaulted(Owner->SharedData->Bones.Num());
+		for (int32 i = 0; i < Owner->SharedData->Bones.Num(); i++)
 		{
-			Bones[i] = FBoneReference(FName(Owner->BonesID2Name[i].c_str()));
+			Bones[i] = FBoneReference(FName(Owner->SharedData->BonesID2Name[i].c_str()));
 			Bones[i].Initialize(BoneContainer);
 		}
+		PartsPose.Empty(Owner->SharedData->BonesParts.Num());
+		BonesPartPoseIndex.Empty(Bones.Num());
+		BonesPartPoseIndex.Init(FCompactPoseBoneIndex(INDEX_NONE), Bones.Num());
+		FXBonesTotalWeights.Empty(Bones.Num());
+		FXBonesTotalWeights.Init(-1.f, Bones.Num());
 		if(Owner->KinematicsData->Anims.Num())
 		{
-			for (int32 PartID = 0; PartID < Owner->BonesParts.Num(); PartID++)
+			for (int32 PartID = 0; PartID < Owner->SharedData->BonesParts.Num(); PartID++)
 			{
-				for (FName BoneName: Owner->BonesParts[PartID].Bones)
+				for (FName BoneName: Owner->SharedData->BonesParts[PartID].Bones)
 				{
 					BonesParts.Add(BoneName, PartID);
 				}
 			}
+
+			const FReferenceSkeleton& RefSkeleton = BoneContainer.GetReferenceSkeleton();
+			TArray<TArray<FBoneIndexType>, TInlineAllocator<4>> RequiredBonesOfPart;
+			RequiredBonesOfPart.SetNum(Owner->SharedData->BonesParts.Num());
+			for (int32 BoneID = 0; BoneID < Bones.Num(); BoneID++)
+			{
+				const int32* PartID = BonesParts.Find(Bones[BoneID].BoneName);
+				if (PartID == nullptr || !Bones[BoneID].IsValidToEvaluate(BoneContainer))
+				{
+					continue;
+				}
+				for (int32 MeshBoneIndex = Bones[BoneID].BoneIndex; MeshBoneIndex != INDEX_NONE; MeshBoneIndex = RefSkeleton.GetParentIndex(MeshBoneIndex))
+				{
+					RequiredBonesOfPart[*PartID].AddUnique(FBoneIndexType(MeshBoneIndex));
+				}
+			}
+
+			PartsPose.SetNum(Owner->SharedData->BonesParts.Num());
+			for (int32 PartID = 0; PartID < PartsPose.Num(); PartID++)
+			{
+				RequiredBonesOfPart[PartID].Sort();
+				PartsPose[PartID].BoneContainer.SetUseRAWData(BoneContainer.ShouldUseRawData());
+				PartsPose[PartID].BoneContainer.SetDisableRetargeting(BoneContainer.GetDisableRetargeting());
+				PartsPose[PartID].BoneContainer.InitializeTo(RequiredBonesOfPart[PartID], FCurveEvaluationOption(false), *BoneContainer.GetAsset());
+			}
+			for (int32 BoneID = 0; BoneID < Bones.Num(); BoneID++)
+			{
+				const int32* PartID = BonesParts.Find(Bones[BoneID].BoneName);
+				if (PartID == nullptr || !Bones[BoneID].IsValidToEvaluate(BoneContainer))
+				{
+					continue;
+				}
+				const FMeshPoseBoneIndex MeshBoneIndex(Bones[BoneID].BoneIndex);
+				BonesPartPoseIndex[BoneID] = PartsPose[*PartID].BoneContainer.MakeCompactPoseIndex(MeshBoneIndex);
+				PartsPose[*PartID].OutputBones.Emplace(BonesPartPoseIndex[BoneID], BoneContainer.MakeCompactPoseIndex(MeshBoneIndex));
+			}
 		}
 	}
 
@@ -62,33 +106,42 @@ void FStalkerAnimNode_Kinematics::Evaluate_AnyThread(FPoseContext& Output)
 		return;
 	}
 	TempBoneTransforms.Empty(Bones.Num());
+	ExtractRootMotion = Output.AnimInstanceProxy->ShouldExtractRootMotion();
 	//check(IsInGameThread());
 
 	if (AnimMode == EStalkerKinematicsAnimMode::GetBoneInMotionBlend)
 	{
-		Evaluate_Blend(Output, *GetBoneInMotionBlend);
+		FAnimationPoseData OutAnimationPoseData(Output);
+		Evaluate_Blend(OutAnimationPoseData, *GetBoneInMotionBlend);
 		return;
 	}
 
-	const bool bInGameThread = IsInGameThread();
 	const FBoneContainer& BoneContainer = Output.AnimInstanceProxy->GetRequiredBones();
 
-	TArray<FPoseContext, TInlineAllocator<4>> PosesOfPart;
 	if(Owner->KinematicsData->Anims.Num())
 	{
 		check(BonesParts.Num());
+		check(PartsPose.Num() == Owner->SharedData->BonesParts.Num());
 
 		Output.ResetToRefPose();
-		for (int32 PartID = 0; PartID < Owner->BonesParts.Num(); PartID++)
-		{
-			PosesOfPart.Add(Output);
-			Evaluate_PartID(PosesOfPart.Last(), PartID);
-		}
-		for (int32 BoneID = 0; BoneID < Bones.Num(); BoneID++)
+		for (int32 PartID = 0; PartID < PartsPose.Num(); PartID++)
 		{
-			const FCompactPoseBoneIndex BoneIndex = Bones[BoneID].GetCompactPoseIndex(BoneContainer);
-			int32 PartID = BonesParts[Bones[BoneID].BoneName];
-			Output.Pose[BoneIndex] = PosesOfPart[PartID].Pose[BoneIndex];
+			const FStalkerKinematicsPartPose& PartPose = PartsPose[PartID];
+			if (PartPose.OutputBones.Num() == 0)
+			{
+				continue;
+			}
+			FCompactPose PoseOfPart;
+			FBlendedCurve CurveOfPart;
+			UE::Anim::FStackAttributeContainer AttributesOfPart;
+			PoseOfPart.SetBoneContainer(&PartPose.BoneContainer);
+			CurveOfPart.InitFrom(PartPose.BoneContainer);
+			FAnimationPoseData PartAnimationPoseData(PoseOfPart, CurveOfPart, AttributesOfPart);
+			Evaluate_PartID(PartAnimationPoseData, PartID);
+			for (const TPair<FCompactPoseBoneIndex, FCompactPoseBoneIndex>& Bone : PartPose.OutputBones)
+			{
+				Output.Pose[Bone.Value] = PoseOfPart[Bone.Key];
+			}
 		}
 	}
 	else
@@ -109,15 +162,19 @@ void FStalkerAnimNode_Kinematics::Evaluate_AnyThread(FPoseContext& Output)
 			FCompactPoseBoneIndex CompactPoseBoneToModify = Bones[BoneID].GetCompactPoseIndex(BoneContainer);
 			int32 ParentId = INDEX_NONE;
 			
-			if (Owner->Bones[BoneID].ParentID != BI_NONE)
+			if (Owner->SharedData->Bones[BoneID].ParentID != BI_NONE)
 			{
-				ParentId = Owner->Bones[BoneID].ParentID;
+				ParentId = Owner->SharedData->Bones[BoneID].ParentID;
 			}
 			check(ParentId < BoneID);
 
 			FTransform BoneTM;
 			BoneTM = Output.Pose[CompactPoseBoneToModify];
-			if (!Owner->LL_GetBoneVisible(u16(BoneID)))
+			if (AnimMode == EStalkerKinematicsAnimMode::GetAnimPose && !GetAnimPosBones[BoneID])
+			{
+				TempBoneTransforms.Add(BoneTM);
+			}
+			else if (!Owner->LL_GetBoneVisible(u16(BoneID)))
 			{
 				BoneTM.SetScale3D(FVector(0,0,0));
 				Output.Pose[CompactPoseBoneToModify] = BoneTM;
@@ -132,8 +189,11 @@ void FStalkerAnimNode_Kinematics::Evaluate_AnyThread(FPoseContext& Output)
 				if (BoneInstance.callback_overwrite())
 				{
 					if (BoneInstance.callback() && (AnimMode != EStalkerKinematicsAnimMode::GetAnimPose || !GetAnimPosIgnoreCallbacks))
+					{
 						BoneInstance.callback()(&BoneInstance);
-
+						if (AnimMode == EStalkerKinematicsAnimMode::Base)
+							BoneInstance.CallbackEvaluated = true;
+					}
 				}
 				else
 				{
@@ -147,6 +207,8 @@ void FStalkerAnimNode_Kinematics::Evaluate_AnyThread(FPoseContext& Output)
 					if (BoneInstance.callback() && (AnimMode != EStalkerKinematicsAnimMode::GetAnimPose || !GetAnimPosIgnoreCallbacks))
 					{
 						BoneInstance.callback()(&BoneInstance);
+						if (AnimMode == EStalkerKinematicsAnimMode::Base)
+							BoneInstance.CallbackEvaluated = true;
 					}
 				}
 				
@@ -180,11 +242,11 @@ void FStalkerAnimNode_Kinematics::GatherDebugData(FNodeDebugData& DebugData)
 }
 
 
-void FStalkerAnimNode_Kinematics::Evaluate_PartID(FPoseContext& Output, int32 PartID)
+void FStalkerAnimNode_Kinematics::Evaluate_PartID(FAnimationPoseData& Output, int32 PartID)
 {
+	Output.GetPose().ResetToRefPose();
 	if (Owner->BlendsCycles[PartID].Num() == 0)
 	{
-		Output.ResetToRefPose();
 		return;
 	}
 	const bool bInGameThread = IsInGameThread();
@@ -198,7 +260,7 @@ void FStalkerAnimNode_Kinematics::Evaluate_PartID(FPoseContext& Output, int32 Pa
 	int32 MaxAddChannel = 0;
 	for (int32 BlendID = 0; BlendID < Owner->BlendsCycles[PartID].Num(); BlendID++)
 	{
-		CBlend& Blend = *Owner->BlendsCycles[PartID][BlendID];
+		CBlend& Blend = Owner->GetBlend(Owner->BlendsCycles[PartID][BlendID]);
 		checkSlow(Blend.channel < 4);
 
 		if (bInGameThread && AnimMode == EStalkerKinematicsAnimMode::GetAnimPose)
@@ -223,7 +285,7 @@ void FStalkerAnimNode_Kinematics::Evaluate_PartID(FPoseContext& Output, int32 Pa
 					Min = BlendOfChannal[Blend.channel][i]->blendAmount;
 				}
 			}
-			BlendOfChannal[Blend.channel].RemoveAt(IDToRemove);
+			BlendOfChannal[Blend.channel].RemoveAt(IDToRemove, 1, false);
 		}
 		if (Blend.channel > 1)
 			MaxAddChannel = FMath::Max(MaxAddChannel, int32(Blend.channel-1));
@@ -231,10 +293,10 @@ void FStalkerAnimNode_Kinematics::Evaluate_PartID(FPoseContext& Output, int32 Pa
 			MaxBlendChannel = FMath::Max(MaxBlendChannel,int32(Blend.channel+1));
 
 	
-		BlendOfChannal[Blend.channel].Add(Owner->BlendsCycles[PartID][BlendID]);
+		BlendOfChannal[Blend.channel].Add(&Blend);
 	}
 
-	FAnimationPoseData OutAnimationPoseData(Output);
+	const FBoneContainer& BoneContainer = Output.GetPose().GetBoneContainer();
 	float   TotalWeights = 0;
 	if (MaxBlendChannel)
 	{
@@ -245,17 +307,15 @@ void FStalkerAnimNode_Kinematics::Evaluate_PartID(FPoseContext& Output, int32 Pa
 		for (int32 i = 0; i < MaxBlendChannel; ++i)
 		{
 			PosesToEvaluate.Add(i);
-			FPoseContext EvaluateContext(Output);
-			float   TotalWeightsForFX = Evaluate_Channal(EvaluateContext, i);
+			FilteredPoses[i].SetBoneContainer(&BoneContainer);
+			FilteredCurve[i].InitFrom(BoneContainer);
+			FAnimationPoseData EvaluateAnimationPoseData(FilteredPoses[i], FilteredCurve[i], FilteredAttributes[i]);
+			float   TotalWeightsForFX = Evaluate_Channal(EvaluateAnimationPoseData, i);
 
 			if (i == 0)
 			{
-				Evaluate_FX(EvaluateContext, PartID, TotalWeightsForFX);
+				Evaluate_FX(EvaluateAnimationPoseData, PartID, TotalWeightsForFX);
 			}
-
-			FilteredPoses[i].MoveBonesFrom(EvaluateContext.Pose);
-			FilteredCurve[i].MoveFrom(EvaluateContext.Curve);
-			FilteredAttributes[i].MoveFrom(EvaluateContext.CustomAttributes);
 		}
 		float SumWeight = Owner->ChannelsFactor[0];
 		TotalWeights = Owner->ChannelsFactor[0];
@@ -277,7 +337,7 @@ void FStalkerAnimNode_Kinematics::Evaluate_PartID(FPoseContext& Output, int32 Pa
 				BlendWeights[i] *= ReciprocalSum;
 			}
 		}
-		FAnimationRuntime::BlendPosesTogether(FilteredPoses, FilteredCurve, FilteredAttributes, BlendWeights, PosesToEvaluate, OutAnimationPoseData);
+		FAnimationRuntime::BlendPosesTogether(FilteredPoses, FilteredCurve, FilteredAttributes, BlendWeights, PosesToEvaluate, Output);
 	}
 
 	if (MaxAddChannel)
@@ -287,28 +347,30 @@ void FStalkerAnimNode_Kinematics::Evaluate_PartID(FPoseContext& Output, int32 Pa
 		FilteredAttributes.SetNum(MaxAddChannel, false);
 		for (int32 i = 0; i < MaxAddChannel; ++i)
 		{
-			FPoseContext EvaluateContext(Output,true);
-			Evaluate_Channal(EvaluateContext, i + 2);
-			FilteredPoses[i].MoveBonesFrom(EvaluateContext.Pose);
-			FilteredCurve[i].MoveFrom(EvaluateContext.Curve);
-			FilteredAttributes[i].MoveFrom(EvaluateContext.CustomAttributes);
+			FilteredPoses[i].SetBoneContainer(&BoneContainer);
+			FilteredCurve[i].InitFrom(BoneContainer);
+			FAnimationPoseData EvaluateAnimationPoseData(FilteredPoses[i], FilteredCurve[i], FilteredAttributes[i]);
+			Evaluate_Channal(EvaluateAnimationPoseData, i + 2);
 		}
 		for (int32 i = 0; i < MaxAddChannel; i++)
 		{
 			const FAnimationPoseData AdditiveAnimationPoseData(FilteredPoses[i], FilteredCurve[i], FilteredAttributes[i]);
-			FAnimationRuntime::AccumulateAdditivePose(OutAnimationPoseData, AdditiveAnimationPoseData, Owner->ChannelsFactor[i + 2], AAT_LocalSpaceBase);
-			Output.Pose.NormalizeRotations();
+			FAnimationRuntime::AccumulateAdditivePose(Output, AdditiveAnimationPoseData, Owner->ChannelsFactor[i + 2], AAT_LocalSpaceBase);
+			Output.GetPose().NormalizeRotations();
 		}
 	}
 
 }
 
-float FStalkerAnimNode_Kinematics::Evaluate_Channal(FPoseContext& Output, int32 Channal)
+float FStalkerAnimNode_Kinematics::Evaluate_Channal(FAnimationPoseData& Output, int32 Channal)
 {	
 	if (BlendOfChannal[Channal].Num() == 0)
 	{
-		Output.ResetToRefPose();
-		BlendOfChannal[Channal].Empty(BlendOfChannal[Channal].Num());
+		if (Channal > 1)
+			Output.GetPose().ResetToAdditiveIdentity();
+		else
+			Output.GetPose().ResetToRefPose();
+		BlendOfChannal[Channal].Reset();
 		return 0;
 	}
 	TArray<int32, TInlineAllocator<16>> PosesToEvaluate;
@@ -322,16 +384,14 @@ float FStalkerAnimNode_Kinematics::Evaluate_Channal(FPoseContext& Output, int32
 	FilteredAttributes.SetNum(BlendOfChannal[Channal].Num(), false);
 	BlendWeights.Add( BlendOfChannal[Channal][0]->blendAmount);
 
+	const FBoneContainer& BoneContainer = Output.GetPose().GetBoneContainer();
 	for (int32 i = 0; i < BlendOfChannal[Channal].Num(); ++i)
 	{
 		PosesToEvaluate.Add(i);
-
-		FPoseContext EvaluateContext(Output);
-		Evaluate_Blend(EvaluateContext, *BlendOfChannal[Channal][i]);
-
-		FilteredPoses[i].MoveBonesFrom(EvaluateContext.Pose);
-		FilteredCurve[i].MoveFrom(EvaluateContext.Curve);
-		FilteredAttributes[i].MoveFrom(EvaluateContext.CustomAttributes);
+		FilteredPoses[i].SetBoneContainer(&BoneContainer);
+		FilteredCurve[i].InitFrom(BoneContainer);
+		FAnimationPoseData EvaluateAnimationPoseData(FilteredPoses[i], FilteredCurve[i], FilteredAttributes[i]);
+		Evaluate_Blend(EvaluateAnimationPoseData, *BlendOfChannal[Channal][i]);
 	}
 
 	float   TotalWeights = BlendOfChannal[Channal][0]->blendAmount;
@@ -357,66 +417,55 @@ float FStalkerAnimNode_Kinematics::Evaluate_Channal(FPoseContext& Output, int32
 		}
 	}
 
-	BlendOfChannal[Channal].Empty(BlendOfChannal[Channal].Num());
-	FAnimationPoseData OutAnimationPoseData(Output);
-	FAnimationRuntime::BlendPosesTogether(FilteredPoses, FilteredCurve, FilteredAttributes, BlendWeights, PosesToEvaluate, OutAnimationPoseData);
+	BlendOfChannal[Channal].Reset();
+	FAnimationRuntime::BlendPosesTogether(FilteredPoses, FilteredCurve, FilteredAttributes, BlendWeights, PosesToEvaluate, Output);
 	return TotalWeights;
 }
 
-void FStalkerAnimNode_Kinematics::Evaluate_FX(FPoseContext& Output, int32 PartID, float TotalWeights)
+void FStalkerAnimNode_Kinematics::Evaluate_FX(FAnimationPoseData& Output, int32 PartID, float TotalWeights)
 {
-	TArray<int32, TInlineAllocator<16>> PosesToEvaluate;
-	TArray<FCompactPose, TInlineAllocator<16>> FilteredPoses;
-	TArray<FBlendedCurve, TInlineAllocator<16>> FilteredCurve;
-	TArray<UE::Anim::FStackAttributeContainer, TInlineAllocator<16>> FilteredAttributes;
-
-	const FBoneContainer& BoneContainer = Output.AnimInstanceProxy->GetRequiredBones();
-
-	FilteredPoses.SetNum(Owner->BlendsFX[PartID].Num(), false);
-	FilteredCurve.SetNum(Owner->BlendsFX[PartID].Num(), false);
-	FilteredAttributes.SetNum(Owner->BlendsFX[PartID].Num(), false);
+	SCOPE_CYCLE_COUNTER(STAT_XRayEngineKinematicsFX);
+	FCompactPose& Pose = Output.GetPose();
+	const FBoneContainer& BoneContainer = Pose.GetBoneContainer();
 
 	for (int32 i = 0; i < Owner->BlendsFX[PartID].Num(); ++i)
 	{
-		PosesToEvaluate.Add(i);
-
-		FPoseContext EvaluateContext(Output);
-		Evaluate_Blend(EvaluateContext, *Owner->BlendsFX[PartID][i]);
-
-		FilteredPoses[i].MoveBonesFrom(EvaluateContext.Pose);
-		FilteredCurve[i].MoveFrom(EvaluateContext.Curve);
-		FilteredAttributes[i].MoveFrom(EvaluateContext.CustomAttributes);
-	}
-
-	TMap<u16,float> BoneTotalWeights;
-	for (int32 i = 0; i < Owner->BlendsFX[PartID].Num(); ++i)
-	{
-		float*Weights = BoneTotalWeights.Find(Owner->BlendsFX[PartID][i]->bone_or_part);
-		if (Weights == nullptr)
+		CBlend& Blend = Owner->GetBlend(Owner->BlendsFX[PartID][i]);
+		float& Weights = FXBonesTotalWeights[Blend.bone_or_part];
+		if (Weights < 0)
 		{
-			Weights = &BoneTotalWeights.Add(Owner->BlendsFX[PartID][i]->bone_or_part,TotalWeights);
+			Weights = TotalWeights;
+			FXBones.Add(Blend.bone_or_part);
 		}
-		*Weights += Owner->BlendsFX[PartID][i]->blendAmount;
+		Weights += Blend.blendAmount;
 
-		FCompactPoseBoneIndex CompactPoseBoneToModify = Bones[Owner->BlendsFX[PartID][i]->bone_or_part].GetCompactPoseIndex(BoneContainer);
+		FCompactPoseBoneIndex CompactPoseBoneToModify = BonesPartPoseIndex[Blend.bone_or_part];
+		if (!CompactPoseBoneToModify.IsValid())
+			continue;
 		float BlendWeights=0;
 		if (!FMath::IsNearlyZero(TotalWeights))
-			BlendWeights =FMath::Clamp(Owner->BlendsFX[PartID][i]->blendAmount / *Weights,0,1.f);
+			BlendWeights =FMath::Clamp(Blend.blendAmount / Weights,0,1.f);
 
-		FTransform CurrentTransform =  Output.Pose[CompactPoseBoneToModify];
-		Output.Pose[CompactPoseBoneToModify].Blend(CurrentTransform, FilteredPoses[i][CompactPoseBoneToModify], BlendWeights);
+		FTransform BlendTransform;
+		Evaluate_BoneInBlend(BlendTransform, BoneContainer, CompactPoseBoneToModify, Blend);
+		FTransform CurrentTransform =  Pose[CompactPoseBoneToModify];
+		Pose[CompactPoseBoneToModify].Blend(CurrentTransform, BlendTransform, BlendWeights);
 	}
 
+	for (u16 BoneID : FXBones)
+	{
+		FXBonesTotalWeights[BoneID] = -1.f;
+	}
+	FXBones.Reset();
 }
 
-void FStalkerAnimNode_Kinematics::Evaluate_Blend(FPoseContext& Output, CBlend& AnimBlend)
+void FStalkerAnimNode_Kinematics::Evaluate_Blend(FAnimationPoseData& Output, CBlend& AnimBlend)
 {
 	checkSlow(AnimBlend.motionID.valid());
-	FAnimationPoseData AnimationPoseData(Output);
 	FDeltaTimeRecord DeltaTimeRecord;
 	bool NeedAdditive = AnimBlend.channel>1;
-	UAnimSequence* Anim = Owner->Anims[AnimBlend.motionID.val].Amim;
-	Anim->GetAnimationPose(AnimationPoseData, FAnimExtractContext(AnimBlend.timeCurrent, Output.AnimInstanceProxy->ShouldExtractRootMotion(), DeltaTimeRecord, false));
+	UAnimSequence* Anim = Owner->SharedData->Anims[AnimBlend.motionID.val].Amim;
+	Anim->GetAnimationPose(Output, FAnimExtractContext(AnimBlend.timeCurrent, ExtractRootMotion, DeltaTimeRecord, false));
 	if (Anim->IsValidAdditive() != NeedAdditive)
 	{
 		FString Name;
@@ -424,3 +473,27 @@ void FStalkerAnimNode_Kinematics::Evaluate_Blend(FPoseContext& Output, CBlend& A
 		UE_LOG(LogStalker,Error,TEXT("AnimSequence %s need %s be Additive"),*Name, NeedAdditive?TEXT(""): TEXT("not"));
 	}
 }
+
+void FStalkerAnimNode_Kinematics::Evaluate_BoneInBlend(FTransform& OutTransform, const FBoneContainer& BoneContainer, FCompactPoseBoneIndex BoneIndex, CBlend& AnimBlend)
+{
+	checkSlow(AnimBlend.motionID.valid());
+	UAnimSequence* Anim = Owner->SharedData->Anims[AnimBlend.motionID.val].Amim;
+	const int32 SkeletonBoneIndex = BoneContainer.GetSkeletonIndex(BoneIndex);
+	const USkeleton* Skeleton = BoneContainer.GetSkeletonAsset();
+	// Additive sequences, root motion and retargeted bones need the whole extraction of GetAnimationPose,
+	// GetBoneTransform returns the raw track of the sequence's own skeleton
+	const bool NeedRetarget = SkeletonBoneIndex != INDEX_NONE && Skeleton && Skeleton->GetBoneTranslationRetargetingMode(SkeletonBoneIndex, BoneContainer.GetDisableRetargeting()) != EBoneTranslationRetargetingMode::Animation;
+	if (Anim->IsValidAdditive() || BoneIndex.IsRootBone() || SkeletonBoneIndex == INDEX_NONE || Anim->GetSkeleton() != Skeleton || NeedRetarget)
+	{
+		FCompactPose Pose;
+		FBlendedCurve Curve;
+		UE::Anim::FStackAttributeContainer Attributes;
+		Pose.SetBoneContainer(&BoneContainer);
+		Curve.InitFrom(BoneContainer);
+		FAnimationPoseData AnimationPoseData(Pose, Curve, Attributes);
+		Evaluate_Blend(AnimationPoseData, AnimBlend);
+		OutTransform = Pose[BoneIndex];
+		return;
+	}
+	Anim->GetBoneTransform(OutTransform, FSkeletonPoseBoneIndex(SkeletonBoneIndex), AnimBlend.timeCurrent, BoneContainer.ShouldUseRawData());
+}
@@ -7,6 +7,15 @@ enum class EStalkerKinematicsAnimMode
 	GetAnimPose,
 	GetBoneInMotionBlend,
 };
+
+// Bones of one part with the ancestors they need, blends of the part are sampled only for them
+struct FStalkerKinematicsPartPose
+{
+	FBoneContainer												BoneContainer;
+	// Part compact pose index and output compact pose index of every bone owned by the part
+	TArray<TPair<FCompactPoseBoneIndex, FCompactPoseBoneIndex>>	OutputBones;
+};
+
 USTRUCT(BlueprintInternalUseOnly)
 struct STALKER_API FStalkerAnimNode_Kinematics : public FAnimNode_Base
 {
@@ -24,6 +33,8 @@ public:
 
 	bool										GetAnimPosIgnoreCallbacks;
 	u8											GetAnimPosChannelMask;
+	// Bones whose instances GetAnimPose evaluates, the others keep their current transform
+	TBitArray<>									GetAnimPosBones;
 
 	CBlend*										GetBoneInMotionBlend;
 private:
@@ -34,12 +45,20 @@ private:
 
 	TArray<FBoneReference>						Bones;
 	TMap<FName,int32>							BonesParts;
+	TArray<FStalkerKinematicsPartPose>			PartsPose;
+	// Compact pose index of every bone in the pose of its part
+	TArray<FCompactPoseBoneIndex>				BonesPartPoseIndex;
+	// Total weight of FX blends per bone, negative for bones not driven in the current evaluation
+	TArray<float>								FXBonesTotalWeights;
+	TArray<u16, TInlineAllocator<16>>			FXBones;
+	bool										ExtractRootMotion;
 
-	TArray<TSharedPtr<CBlend>>					BlendOfChannal[4];
+	TArray<CBlend*, TFixedAllocator<16>>		BlendOfChannal[4];
 
-	void Evaluate_PartID						(FPoseContext& Output, int32 PartID);
-	float Evaluate_Channal						(FPoseContext& Output,  int32 Channal);
-	void Evaluate_FX							(FPoseContext& Output, int32 PartID,float TotalWeights);
-	void Evaluate_Blend							(FPoseContext& Output, CBlend&AnimBlend);
+	void Evaluate_PartID						(FAnimationPoseData& Output, int32 PartID);
+	float Evaluate_Channal						(FAnimationPoseData& Output,  int32 Channal);
+	void Evaluate_FX							(FAnimationPoseData& Output, int32 PartID,float TotalWeights);
+	void Evaluate_Blend							(FAnimationPoseData& Output, CBlend&AnimBlend);
+	void Evaluate_BoneInBlend					(FTransform& OutTransform, const FBoneContainer& BoneContainer, FCompactPoseBoneIndex BoneIndex, CBlend& AnimBlend);
 	TArray<FTransform>							TempBoneTransforms;
 };
\ No newline at end of file
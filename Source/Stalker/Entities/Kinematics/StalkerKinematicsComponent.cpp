@@ -6,6 +6,7 @@
 #include "AnimInstance/StalkerKinematicsAnimInstanceProxy.h"
 #include "Kernel/StalkerEngineManager.h"
 #include "Resources/StalkerResourcesManager.h"
+#include "Kernel/Unreal/GameSettings/StalkerGameSettings.h"
 THIRD_PARTY_INCLUDES_START
 #include "XrRender/Public/RenderVisual.h"
 #include "XrEngine/IRenderable.h"
@@ -14,6 +15,8 @@ THIRD_PARTY_INCLUDES_START
 THIRD_PARTY_INCLUDES_END
 
 DECLARE_CYCLE_STAT(TEXT("XRay ~ Kinematics Frame"), STAT_XRayEngineKinematics, STATGROUP_XRayEngine);
+// Frames a game side pose read keeps a hidden pose evaluated
+const uint64 PoseReadGraceFrames = 30;
 UStalkerKinematicsComponent::UStalkerKinematicsComponent()
 {
 	BlendDestroyCallback = nullptr;
@@ -23,6 +26,8 @@ UStalkerKinematicsComponent::UStalkerKinematicsComponent()
 	SetAnimationMode(EAnimationMode::Type::AnimationBlueprint);
 	AnimClass = UStalkerKinematicsAnimInstance_Default::StaticClass();
 	SkipDeltaTime = 0;
+	SharedData = FStalkerKinematicsSharedData::GetEmpty();
+	ResetBlends();
 #if WITH_EDITORONLY_DATA
 	bIsErrorMesh = false;
 #endif
@@ -34,30 +39,17 @@ void UStalkerKinematicsComponent::Initilize(class UStalkerKinematicsData* InKine
 	{
 		ClearAnimScriptInstance();
 	
-		for (TArray <TSharedPtr<CBlend>>& InBlendsCycles : BlendsCycles)
-		{
-			InBlendsCycles.Empty();
-		}
-		for (TArray <TSharedPtr<CBlend>>& InBlendsFX : BlendsFX)
-		{
-			InBlendsFX.Empty();
-		}
+		ResetBlends();
 	
-		Anims.Empty();
 		SkipDeltaTime = 0;
 		BonesInstance.Empty();
-		Bones.Empty();
-		BonesName2ID.Empty();
-		BonesID2Name.Empty();
+		BoneCallbackCount = 0;
+		bBoneCallbacksDirty = false;
+		PoseReadFrame = MAX_uint64;
+		BonesObb.Empty();
+		SharedData = FStalkerKinematicsSharedData::GetEmpty();
 		VisData.clear();
-		BlendsPool.Empty();
-		UserData.Reset();
 		SelfBonesVisible.zero();
-		AnimsDef.Empty();
-		AnimsName2ID.Empty();
-		BonesPartsName2ID.Empty();
-		BonesPartsBoneID2ID.Empty();
-		BonesParts.Empty();
 		DataName = "";
 #if WITH_EDITORONLY_DATA
 		bIsErrorMesh = false;
@@ -81,76 +73,39 @@ void UStalkerKinematicsComponent::Initilize(class UStalkerKinematicsData* InKine
 #if WITH_EDITORONLY_DATA
 	bIsErrorMesh =  InKinematicsData->GetPathName() == TEXT("/Game/Base/Meshes/Error_KinematicsData.Error_KinematicsData");
 #endif
+	SharedData = KinematicsData->GetSharedData();
+	InitilizeBones();
+	SetSkeletalMesh(KinematicsData->Mesh);
+	{
+		FBox Box = KinematicsData->Mesh->GetBounds().GetBox();
+
+		VisData.box.invalidate();
+		VisData.box.modify(StalkerMath::UnrealLocationToXRay(Box.Min));
+		VisData.box.modify(StalkerMath::UnrealLocationToXRay(Box.Max));
+		Fvector Center;
+		VisData.box.getcenter(Center);
+		VisData.sphere.set(Center, VisData.box.getradius());
+	}
+	SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	FString InDataName;
+	InKinematicsData->GetName(InDataName);
+	DataName = TCHAR_TO_ANSI(*InDataName);
+	TickAnimation(0,false);
+}
+
+void UStalkerKinematicsComponent::InitilizeBones()
+{
 	for (float& Factor : ChannelsFactor)
 	{
 		Factor = 0;
 	}
 	ChannelsFactor[0] = 1;
 
-	KinematicsData->BuildBones(Bones);
+	const TArray<StalkerKinematicsBone>& Bones = SharedData->Bones;
 	BonesInstance.AddDefaulted(Bones.Num());
-	if (KinematicsData->UserData.Len()&&FApp::IsGame())
-	{
-		TArray<char> UserDataMemory;
-		UserDataMemory.Append(TCHAR_TO_ANSI(*KinematicsData->UserData), KinematicsData->UserData.Len());
-		IReader Reader(UserDataMemory.GetData(), UserDataMemory.Num());
-		UserData = MakeShared<CInifile>(&Reader, FS.get_path("$game_config$")->m_Path);
-	}
-	
-	for(StalkerKinematicsBone&Bone: Bones)
-	{
-		BonesName2ID.Add(Bone.GetName(), Bone.SelfID);
-		BonesID2Name.Add(Bone.SelfID,Bone.GetName());
-	}
 	for(u16 i =0;i<LL_BoneCount();i++)
 		SelfBonesVisible.set(i,true);
 
-	u32 BonesPartID = 0;
-	if (KinematicsData->Anims.Num())
-	{
-		for (auto& [Name, BonesPart] : KinematicsData->Anims[0]->BonesParts)
-		{
-			if(BonesPart.Bones.Num() == 0)continue;
-			BonesPartsName2ID.Add(TCHAR_TO_ANSI(*Name.ToString().ToLower()), BonesPartID);
-			BonesParts.Add(BonesPart);
-			BonesPartID++;
-		}
-	}
-	int32 BonesPartsID = 0;
-	for (FStalkerKinematicsAnimsBonesPart& BonesPart : BonesParts)
-	{
-		for (FName& BoneOfPart : BonesPart.Bones)
-		{
-			shared_str BoneName = TCHAR_TO_ANSI(*BoneOfPart.ToString().ToLower());
-			BonesPartsBoneID2ID.Add(BonesName2ID[BoneName], BonesPartsID);
-		}
-		BonesPartsID++;
-	}
-	u32 AnimID = 0;
-	for (int32 i = 0; i < KinematicsData->Anims.Num(); i++)
-	{
-		for (auto& [Name,AnimData ]: KinematicsData->Anims[i]->Anims)
-		{
-			if (!IsValid(AnimData.Amim))
-			{
-				checkSlow(false);
-				continue;
-			}
-			if (!AnimData.Amim->GetSkeleton()->IsCompatible(KinematicsData->Mesh->GetSkeleton()))
-			{
-				checkSlow(false);
-				continue;
-			}
-			AnimsName2ID.Add(TCHAR_TO_ANSI(*Name.ToString().ToLower()),AnimID);
-			Anims.Add(AnimData);
-			AnimID++;
-			AnimsDef.AddDefaulted();
-			CMotionDef& MotionDef =  AnimsDef.Last();
-			AnimData.BuildToLegacy(MotionDef,BonesName2ID,BonesPartsName2ID);
-			MotionDef.speed = MotionDef.Quantize(AnimData.Amim->RateScale);
-		}
-	
-	}
 	LL_SetChannelFactor(0, 1);
 	LL_SetChannelFactor(1, 1);
 	LL_SetChannelFactor(2, 1);
@@ -165,21 +120,43 @@ void UStalkerKinematicsComponent::Initilize(class UStalkerKinematicsData* InKine
 		}
 		BonesInstance[i].Transform.mul_43(Parent,Bones[i].get_bind_transform());
 	}
-	SetSkeletalMesh(KinematicsData->Mesh);
-	{
-		FBox Box = KinematicsData->Mesh->GetBounds().GetBox();
+}
 
-		VisData.box.invalidate();
-		VisData.box.modify(StalkerMath::UnrealLocationToXRay(Box.Min));
-		VisData.box.modify(StalkerMath::UnrealLocationToXRay(Box.Max));
-		Fvector Center;
-		VisData.box.getcenter(Center);
-		VisData.sphere.set(Center, VisData.box.getradius());
+bool UStalkerKinematicsComponent::IsReusable() const
+{
+	return XRayParent == nullptr && !IsRegistered() && GetOwner() == nullptr && GetOuter() == GetTransientPackage();
+}
+
+void UStalkerKinematicsComponent::ResetForReuse()
+{
+	check(IsReusable());
+	ClearAnimScriptInstance();
+	if (KinematicsAnimInstanceForCompute)
+	{
+		KinematicsAnimInstanceForCompute->MarkAsGarbage();
 	}
-	SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	FString InDataName;
-	InKinematicsData->GetName(InDataName);
-	DataName = TCHAR_TO_ANSI(*InDataName);
+	KinematicsAnimInstanceForCompute = nullptr;
+	if (bHiddenPoseSkipped)
+	{
+		VisibilityBasedAnimTickOption = SkippedVisibilityBasedAnimTickOption;
+		bHiddenPoseSkipped = false;
+	}
+	ResetBlends();
+	BlendDestroyCallback = nullptr;
+	UpdateTracksCallback = nullptr;
+	MyUpdateCallback = nullptr;
+	UpdateCallbackParam = nullptr;
+	SkipDeltaTime = 0;
+	BonesInstance.Reset();
+	BoneCallbackCount = 0;
+	bBoneCallbacksDirty = false;
+	PoseReadFrame = MAX_uint64;
+	BonesObb.Reset();
+	SelfBonesVisible.zero();
+	InitilizeBones();
+	SetRelativeTransform(FTransform::Identity);
+	SetOwnerNoSee(false);
+	SetOnlyOwnerSee(false);
 	TickAnimation(0,false);
 }
 
@@ -210,7 +187,7 @@ void UStalkerKinematicsComponent::BlendSetup(CBlend& Blend, u32 PartID, u8 Chann
 	Blend.speed = Speed;
 	Blend.motionID = InMotionID;
 	Blend.timeCurrent = 0;
-	Blend.timeTotal = Anims[InMotionID.val].Amim->GetPlayLength();
+	Blend.timeTotal = SharedData->Anims[InMotionID.val].Amim->GetPlayLength();
 	Blend.bone_or_part = PartID;
 	Blend.stop_at_end = NoLoop;
 	Blend.playing = TRUE;
@@ -232,7 +209,7 @@ void UStalkerKinematicsComponent::FXBlendSetup(CBlend& Blend, MotionID InMotionI
 	Blend.speed = Speed;
 	Blend.motionID = InMotionID;
 	Blend.timeCurrent = 0;
-	Blend.timeTotal = Anims[InMotionID.val].Amim->GetPlayLength();
+	Blend.timeTotal = SharedData->Anims[InMotionID.val].Amim->GetPlayLength();
 	Blend.bone_or_part = Bone;
 
 	Blend.playing = TRUE;
@@ -246,18 +223,34 @@ void UStalkerKinematicsComponent::FXBlendSetup(CBlend& Blend, MotionID InMotionI
 	Blend.fall_at_end = FALSE;
 }
 
-TSharedPtr<CBlend> UStalkerKinematicsComponent::CreateBlend()
+int32 UStalkerKinematicsComponent::CreateBlend()
 {
-	if (BlendsPool.Num())
+	if (BlendsFree.Num() == 0)
 	{
-		return BlendsPool.Pop();
+		UE_LOG(LogStalker, Warning, TEXT("Kinematics %s ran out of blends, the animation is skipped"), ANSI_TO_TCHAR(DataName.c_str()));
+		return INDEX_NONE;
 	}
-	return MakeShared<CBlend>();
+	return BlendsFree.Pop(false);
+}
+
+void UStalkerKinematicsComponent::DestroyBlend(u16 Handle)
+{
+	BlendsFree.Add(Handle);
 }
 
-void UStalkerKinematicsComponent::DestroyBlend(TSharedPtr<CBlend>& Blend)
+void UStalkerKinematicsComponent::ResetBlends()
 {
-	BlendsPool.Add(Blend);
+	for (int32 PartID = 0; PartID < MAX_PARTS; PartID++)
+	{
+		BlendsCycles[PartID].Reset();
+		BlendsFX[PartID].Reset();
+	}
+	BlendsFree.Reset();
+	for (int32 Handle = MAX_BLENDED_POOL - 1; Handle >= 0; Handle--)
+	{
+		BlendsPool[Handle].set_free_state();
+		BlendsFree.Add(u16(Handle));
+	}
 }
 
 void UStalkerKinematicsComponent::SetOwnerNoSee(bool Enable)
@@ -296,6 +289,14 @@ void UStalkerKinematicsComponent::Detach()
 		DetachFromComponent(DetachmentTransformRules);
 		UnregisterComponent();
 	}
+	if (AActor* Owner = GetOwner())
+	{
+		if (Owner->GetRootComponent() == this)
+		{
+			Owner->SetRootComponent(nullptr);
+		}
+		Owner->RemoveInstanceComponent(this);
+	}
 
 	GStalkerEngineManager->GetResourcesManager()->RegisterKinematics(this);
 }
@@ -331,7 +332,7 @@ float UStalkerKinematicsComponent::LL_GetMotionTime(MotionID id)
 {
 	if (id.valid())
 	{
-		return Anims[id.val].Amim->GetPlayLength() / Anims[id.val].Amim->RateScale;
+		return SharedData->Anims[id.val].Amim->GetPlayLength() / SharedData->Anims[id.val].Amim->RateScale;
 	}
 	return 0;
 }
@@ -366,7 +367,7 @@ u32 UStalkerKinematicsComponent::LL_PartBlendsCount(u32 bone_part_id)
 CBlend* UStalkerKinematicsComponent::LL_PartBlend(u32 bone_part_id, u32 ID)
 {
 	checkSlow(bone_part_id < 4);
-	return BlendsCycles[bone_part_id][ID].Get();
+	return &GetBlend(BlendsCycles[bone_part_id][ID]);
 }
 
 void UStalkerKinematicsComponent::GetBoneInMotion(Fmatrix& OutPosition, u16 BoneID, CBlend* InBlend)
@@ -375,9 +376,9 @@ void UStalkerKinematicsComponent::GetBoneInMotion(Fmatrix& OutPosition, u16 Bone
 #if WITH_EDITOR
 	for (int32 BonesPartID = 0; BonesPartID < 4&&!Result; BonesPartID++)
 	{
-		for (TSharedPtr<CBlend>& Blend : BlendsCycles[BonesPartID])
+		for (u16 Handle : BlendsCycles[BonesPartID])
 		{
-			if (Blend.Get() == InBlend)
+			if (&GetBlend(Handle) == InBlend)
 			{
 				Result = true;
 				break;
@@ -397,17 +398,13 @@ void UStalkerKinematicsComponent::GetBoneInMotion(Fmatrix& OutPosition, u16 Bone
 	FBlendedHeapCurve   OutCurve;
 	FVector				OutRootBoneTranslation;
 
-	if (!IsValid(KinematicsAnimInstanceForCompute))
-	{
-		KinematicsAnimInstanceForCompute = NewObject< UStalkerKinematicsAnimInstance_Default>(this, TEXT("KinematicsAnimInstance"), RF_Transient);
-		KinematicsAnimInstanceForCompute->InitializeAnimation();
-	}
-	KinematicsAnimInstanceForCompute->GetProxy().GetKinematicsRootNode().SetAnimMode(EStalkerKinematicsAnimMode::GetBoneInMotionBlend);
-	KinematicsAnimInstanceForCompute->GetProxy().GetKinematicsRootNode().GetBoneInMotionBlend = InBlend;
+	UStalkerKinematicsAnimInstance_Default* ComputeAnimInstance = GetKinematicsAnimInstanceForCompute();
+	ComputeAnimInstance->GetProxy().GetKinematicsRootNode().SetAnimMode(EStalkerKinematicsAnimMode::GetBoneInMotionBlend);
+	ComputeAnimInstance->GetProxy().GetKinematicsRootNode().GetBoneInMotionBlend = InBlend;
 
-	BonesTransform.AddDefaulted(Bones.Num());
+	BonesTransform.AddDefaulted(SharedData->Bones.Num());
 
-	PerformAnimationProcessing(SkeletalMesh, KinematicsAnimInstanceForCompute,true, BonesTransform, OutBoneSpaceTransforms, OutRootBoneTranslation, OutCurve);
+	PerformAnimationProcessing(SkeletalMesh, ComputeAnimInstance,true, BonesTransform, OutBoneSpaceTransforms, OutRootBoneTranslation, OutCurve);
 
 	OutPosition.rotation(StalkerMath::UnrealQuatToXRay(BonesTransform[BoneID].GetRotation()));
 	OutPosition.translate_over(StalkerMath::UnrealLocationToXRay(BonesTransform[BoneID].GetTranslation()));
@@ -419,11 +416,11 @@ void UStalkerKinematicsComponent::LL_IterateBlends(IterateBlendsCallback& callba
 	{
 		for (int32 i = 0; i < BlendsCycles[PartID].Num();i++)
 		{
-			callback(*BlendsCycles[PartID][i]);
+			callback(GetBlend(BlendsCycles[PartID][i]));
 		}
 		for (int32 i = 0; i < BlendsFX[PartID].Num(); i++)
 		{
-			callback(*BlendsFX[PartID][i]);
+			callback(GetBlend(BlendsFX[PartID][i]));
 		}
 	}
 
@@ -435,7 +432,7 @@ CMotionDef* UStalkerKinematicsComponent::LL_GetMotionDef(MotionID id)
 {
 	if (id.valid())
 	{
-		return &AnimsDef[id.val];
+		return &SharedData->AnimsDef[id.val];
 	}
 	return nullptr;
 }
@@ -464,7 +461,7 @@ IUpdateTracksCallback* UStalkerKinematicsComponent::GetUpdateTracksCalback()
 MotionID UStalkerKinematicsComponent::LL_MotionID(LPCSTR B)
 {
 	MotionID ResultMotionID;
-	u32*ID =  AnimsName2ID.Find(B);
+	u32*ID =  SharedData->AnimsName2ID.Find(B);
 	if (ID)
 	{
 		ResultMotionID.val = *ID;
@@ -474,7 +471,7 @@ MotionID UStalkerKinematicsComponent::LL_MotionID(LPCSTR B)
 
 u16 UStalkerKinematicsComponent::LL_PartID(LPCSTR B)
 {
-	u32* ID = BonesPartsName2ID.Find(B);
+	u32* ID = SharedData->BonesPartsName2ID.Find(B);
 	if (ID)
 	{
 		return static_cast<u16>( *ID);
@@ -484,7 +481,7 @@ u16 UStalkerKinematicsComponent::LL_PartID(LPCSTR B)
 
 u32 UStalkerKinematicsComponent::BonesPartsCount() const
 {
-	return BonesParts.Num();
+	return SharedData->BonesParts.Num();
 }
 
 CBlend* UStalkerKinematicsComponent::LL_PlayCycle(u16 BonesPartID, MotionID InMotionID, BOOL bMixing, float blendAccrue, float blendFalloff, float Speed, BOOL noloop, PlayCallback Callback, LPVOID CallbackParam, u8 channel /*= 0*/)
@@ -507,15 +504,16 @@ CBlend* UStalkerKinematicsComponent::LL_PlayCycle(u16 BonesPartID, MotionID InMo
 	{
 		if (bMixing)	
 		{
-			for (TSharedPtr<CBlend>&Blend: BlendsCycles[BonesPartID])
+			for (u16 Handle: BlendsCycles[BonesPartID])
 			{
-				if (Blend->channel != channel)
+				CBlend& Blend = GetBlend(Handle);
+				if (Blend.channel != channel)
 				{
 					continue;
 				}
-				Blend->set_falloff_state();
-				Blend->blendFalloff = blendFalloff;
-				if (Blend->stop_at_end) Blend->stop_at_end_callback = FALSE;		// callback   !
+				Blend.set_falloff_state();
+				Blend.blendFalloff = blendFalloff;
+				if (Blend.stop_at_end) Blend.stop_at_end_callback = FALSE;		// callback   !
 			}
 		}
 		else			
@@ -523,15 +521,20 @@ CBlend* UStalkerKinematicsComponent::LL_PlayCycle(u16 BonesPartID, MotionID InMo
 			LL_CloseCycle(BonesPartID, 1 << channel);
 		}
 	}
-	BlendsCycles[BonesPartID].Add(CreateBlend());
-	BlendSetup(*BlendsCycles[BonesPartID].Last(), BonesPartID, channel, InMotionID, bMixing, blendAccrue, Speed, noloop, Callback, CallbackParam);
-	return		BlendsCycles[BonesPartID].Last().Get();
+	const int32 Handle = CreateBlend();
+	if (Handle == INDEX_NONE)
+	{
+		return 0;
+	}
+	BlendsCycles[BonesPartID].Add(u16(Handle));
+	BlendSetup(GetBlend(BlendsCycles[BonesPartID].Last()), BonesPartID, channel, InMotionID, bMixing, blendAccrue, Speed, noloop, Callback, CallbackParam);
+	return		&GetBlend(BlendsCycles[BonesPartID].Last());
 }
 
 CBlend* UStalkerKinematicsComponent::LL_PlayCycle(u16 BonesPartID, MotionID InMotionID, BOOL bMixIn, PlayCallback Callback, LPVOID CallbackParam, u8 channel /*= 0*/)
 {
 	checkSlow(InMotionID.valid());
-	CMotionDef&MotionDef = AnimsDef[InMotionID.val];
+	CMotionDef&MotionDef = SharedData->AnimsDef[InMotionID.val];
 	return LL_PlayCycle(BonesPartID, InMotionID, bMixIn, MotionDef.Accrue(), MotionDef.Falloff(), MotionDef.Speed(), MotionDef.StopAtEnd(),Callback, CallbackParam, channel);
 }
 
@@ -539,13 +542,14 @@ void UStalkerKinematicsComponent::LL_CloseCycle(u16 BonePartID, u8 mask_channel
 {
 	for (int32 i = 0; i < BlendsCycles[BonePartID].Num();)
 	{
-		if (mask_channel & (1 << BlendsCycles[BonePartID][i]->channel))
+		CBlend& Blend = GetBlend(BlendsCycles[BonePartID][i]);
+		if (mask_channel & (1 << Blend.channel))
 		{
 			if (GetBlendDestroyCallback())
-				GetBlendDestroyCallback()->BlendDestroy(*BlendsCycles[BonePartID][i].Get());
-			BlendsCycles[BonePartID][i]->set_free_state();
+				GetBlendDestroyCallback()->BlendDestroy(Blend);
+			Blend.set_free_state();
 			DestroyBlend(BlendsCycles[BonePartID][i]);
-			BlendsCycles[BonePartID].RemoveAt(i);
+			BlendsCycles[BonePartID].RemoveAt(i, 1, false);
 		}
 		else
 		{
@@ -571,19 +575,20 @@ void UStalkerKinematicsComponent::LL_UpdateTracks(float Delta, bool b_force, boo
 	{
 		for (int32 i = 0; i < BlendsCycles[PartID].Num();)
 		{
-			if (!b_force && BlendsCycles[PartID][i]->dwFrame == Device->dwFrame)
+			CBlend& Blend = GetBlend(BlendsCycles[PartID][i]);
+			if (!b_force && Blend.dwFrame == Device->dwFrame)
 			{
 				i++;
 				continue;
 			}
-			BlendsCycles[PartID][i]->dwFrame = Device->dwFrame;
-			if (BlendsCycles[PartID][i]->update(Delta, BlendsCycles[PartID][i]->Callback) && !leave_blends)
+			Blend.dwFrame = Device->dwFrame;
+			if (Blend.update(Delta, Blend.Callback) && !leave_blends)
 			{
 				if (GetBlendDestroyCallback())
-					GetBlendDestroyCallback()->BlendDestroy(*BlendsCycles[PartID][i].Get());
-				BlendsCycles[PartID][i]->set_free_state();
+					GetBlendDestroyCallback()->BlendDestroy(Blend);
+				Blend.set_free_state();
 				DestroyBlend(BlendsCycles[PartID][i]);
-				BlendsCycles[PartID].RemoveAt(i);
+				BlendsCycles[PartID].RemoveAt(i, 1, false);
 			}
 			else
 			{
@@ -592,7 +597,7 @@ void UStalkerKinematicsComponent::LL_UpdateTracks(float Delta, bool b_force, boo
 		}
 		for (int32 i = 0; i < BlendsFX[PartID].Num();)
 		{
-			CBlend& B = *BlendsFX[PartID][i];
+			CBlend& B = GetBlend(BlendsFX[PartID][i]);
 			if (!B.stop_at_end_callback)
 			{
 				B.playing = FALSE;
@@ -620,7 +625,7 @@ void UStalkerKinematicsComponent::LL_UpdateTracks(float Delta, bool b_force, boo
 				{
 					B.set_free_state();
 					DestroyBlend(BlendsFX[PartID][i]);
-					BlendsFX[PartID].RemoveAt(i);
+					BlendsFX[PartID].RemoveAt(i, 1, false);
 				}
 				else
 				{
@@ -669,10 +674,10 @@ MotionID UStalkerKinematicsComponent::ID_Cycle_Safe(shared_str Name)
 	}
 #endif
 	MotionID ResultMotionID;
-	u32* ID = AnimsName2ID.Find(Name);
+	u32* ID = SharedData->AnimsName2ID.Find(Name);
 	if (ID)
 	{
-		if (Anims[*ID].Flags & int32(EStalkerKinematicsAnimFlags::FX))
+		if (SharedData->Anims[*ID].Flags & int32(EStalkerKinematicsAnimFlags::FX))
 		{
 			return ResultMotionID;
 		}
@@ -689,7 +694,7 @@ CBlend* UStalkerKinematicsComponent::PlayCycle(LPCSTR Name, BOOL bMixIn /*= TRUE
 CBlend* UStalkerKinematicsComponent::PlayCycle(MotionID InMotionID, BOOL bMixIn /*= TRUE*/, PlayCallback Callback /*= 0*/, LPVOID CallbackParam /*= 0*/, u8 channel /*= 0*/)
 {
 	checkSlow(InMotionID.valid());
-	CMotionDef& MotionDef = AnimsDef[InMotionID.val];
+	CMotionDef& MotionDef = SharedData->AnimsDef[InMotionID.val];
 	return LL_PlayCycle(MotionDef.bone_or_part, InMotionID, bMixIn, MotionDef.Accrue(), MotionDef.Falloff(), MotionDef.Speed(), MotionDef.StopAtEnd(), Callback, CallbackParam, channel);
 }
 
@@ -705,7 +710,7 @@ void UStalkerKinematicsComponent::EditorPlay(MotionID InMotionID, bool InLoop)
 		InitilizeEditor();
 	}
 	checkSlow(InMotionID.valid());
-	CMotionDef& MotionDef = AnimsDef[InMotionID.val];
+	CMotionDef& MotionDef = SharedData->AnimsDef[InMotionID.val];
 	LL_PlayCycle(MotionDef.bone_or_part, InMotionID, FALSE, MotionDef.Accrue(), MotionDef.Falloff(), MotionDef.Speed(), !InLoop, nullptr, nullptr, 0);
 }
 #endif
@@ -727,10 +732,10 @@ MotionID UStalkerKinematicsComponent::ID_FX_Safe(LPCSTR Name)
 	}
 #endif
 	MotionID ResultMotionID;
-	u32* ID = AnimsName2ID.Find(Name);
+	u32* ID = SharedData->AnimsName2ID.Find(Name);
 	if (ID)
 	{
-		if (!(Anims[*ID].Flags & int32(EStalkerKinematicsAnimFlags::FX)))
+		if (!(SharedData->Anims[*ID].Flags & int32(EStalkerKinematicsAnimFlags::FX)))
 		{
 			return ResultMotionID;
 		}
@@ -748,15 +753,20 @@ CBlend* UStalkerKinematicsComponent::PlayFX(LPCSTR Name, float PowerScale)
 CBlend* UStalkerKinematicsComponent::PlayFX(MotionID InMotionID, float PowerScale)
 {
 	if (!InMotionID.valid())	return 0;
-	CMotionDef& MotionDef = AnimsDef[InMotionID.val];
+	CMotionDef& MotionDef = SharedData->AnimsDef[InMotionID.val];
 	
 	u16 BoneID  = MotionDef.bone_or_part;
 	if (BI_NONE == BoneID)		BoneID = 0;
-	u32 BonesPartID = BonesPartsBoneID2ID[BoneID];
+	u32 BonesPartID = SharedData->BonesPartsBoneID2ID[BoneID];
 	if (BlendsFX[BonesPartID].Num() >= MAX_BLENDED) return 0;
-	BlendsFX[BonesPartID].Add(CreateBlend());
-	FXBlendSetup(*BlendsFX[BonesPartID].Last(), InMotionID, MotionDef.Accrue(), MotionDef.Falloff(), MotionDef.Power(), MotionDef.Speed(), BoneID);
-	return BlendsFX[BonesPartID].Last().Get();
+	const int32 Handle = CreateBlend();
+	if (Handle == INDEX_NONE)
+	{
+		return 0;
+	}
+	BlendsFX[BonesPartID].Add(u16(Handle));
+	FXBlendSetup(GetBlend(BlendsFX[BonesPartID].Last()), InMotionID, MotionDef.Accrue(), MotionDef.Falloff(), MotionDef.Power(), MotionDef.Speed(), BoneID);
+	return &GetBlend(BlendsFX[BonesPartID].Last());
 }
 
 float UStalkerKinematicsComponent::get_animation_length(MotionID InMotionID)
@@ -772,7 +782,7 @@ vis_data& _BCL UStalkerKinematicsComponent::getVisData()
 
 u32 UStalkerKinematicsComponent::getType()
 {
-	return Anims.Num() ? MT_SKELETON_ANIM : MT_SKELETON_RIGID;
+	return SharedData->Anims.Num() ? MT_SKELETON_ANIM : MT_SKELETON_RIGID;
 }
 
 IKinematics* _BCL UStalkerKinematicsComponent::dcast_PKinematics()
@@ -787,102 +797,227 @@ void UStalkerKinematicsComponent::Bone_Calculate(const IBoneData* bd, const Fmat
 
 void UStalkerKinematicsComponent::Bone_GetAnimPos(Fmatrix& pos, u16 id, u8 channel_mask, bool ignore_callbacks)
 {
-	pos = LL_GetTransform(id);
+	TArray<u16, TInlineAllocator<32>> Chain;
+	u32 PartsMask = 0;
+	for (u16 BoneID = id; BoneID != BI_NONE; BoneID = SharedData->Bones[BoneID].ParentID)
+	{
+		Chain.Add(BoneID);
+		// Bones outside every part are driven by no blend
+		if (const u32* PartID = SharedData->BonesPartsBoneID2ID.Find(BoneID))
+		{
+			PartsMask |= 1 << *PartID;
+		}
+	}
+
+	// The evaluated pose is exact only if no blend of the chain parts plays on a masked out channel
+	for (int32 PartID = 0; PartID < MAX_PARTS; PartID++)
+	{
+		if (!(PartsMask & (1 << PartID)))
+		{
+			continue;
+		}
+		for (u16 Handle : BlendsCycles[PartID])
+		{
+			if (!(channel_mask & (1 << GetBlend(Handle).channel)))
+			{
+				Bone_GetAnimPosMasked(pos, id, channel_mask, ignore_callbacks);
+				return;
+			}
+		}
+	}
+
 	if (!ignore_callbacks)
 	{
-		for (int32 BoneID = 0; BoneID < Bones.Num(); BoneID++)
+		for (int32 i = Chain.Num() - 1; i >= 0; i--)
 		{
-			if (LL_GetBoneVisible(u16(BoneID)))
+			StalkerKinematicsBoneInstance& BoneInstance = BonesInstance[Chain[i]];
+			if (BoneInstance.callback() && BoneInstance.CallbackFrame != Device->dwFrame && LL_GetBoneVisible(Chain[i]))
 			{
-				StalkerKinematicsBoneInstance& BoneInstance = BonesInstance[BoneID];
-				if (BoneInstance.callback_overwrite())
-				{
-					if (BoneInstance.callback())
-						BoneInstance.callback()(&BoneInstance);
-				}
-				else
-				{
-					if (BoneInstance.callback())
-					{
-						BoneInstance.callback()(&BoneInstance);
-					}
-				}
+				BoneInstance.callback()(&BoneInstance);
+				BoneInstance.CallbackFrame = Device->dwFrame;
 			}
 		}
 	}
-	/*TArray<FTransform>	BonesTransform;
+	pos = LL_GetTransform(id);
+}
+
+void UStalkerKinematicsComponent::Bone_GetAnimPosMasked(Fmatrix& pos, u16 id, u8 channel_mask, bool ignore_callbacks)
+{
+	TArray<FTransform>	BonesTransform;
 	TArray<FTransform>	OutBoneSpaceTransforms;
 	FBlendedHeapCurve   OutCurve;
 	FVector				OutRootBoneTranslation;
-	KinematicsAnimInstanceForCompute->GetProxy().GetKinematicsRootNode().SetAnimMode(EStalkerKinematicsAnimMode::GetAnimPose);
-	KinematicsAnimInstanceForCompute->GetProxy().GetKinematicsRootNode().GetAnimPosIgnoreCallbacks = ignore_callbacks;
-	KinematicsAnimInstanceForCompute->GetProxy().GetKinematicsRootNode().GetAnimPosChannelMask = channel_mask;
-
-	BonesTransform.AddDefaulted(Bones.Num());
-
-	MeshComponent->PerformAnimationProcessing(MeshComponent->SkeletalMesh, KinematicsAnimInstanceForCompute,true, BonesTransform, OutBoneSpaceTransforms, OutRootBoneTranslation, OutCurve);
 
-	pos.rotation(StalkerMath::UnrealQuatToXRay(BonesTransform[id].GetRotation()));
-	pos.translate_over(StalkerMath::UnrealLocationToXRay(BonesTransform[id].GetTranslation()));*/
-}
+	// Evaluation writes the instances of the chain up to id, the current pose stays visible to everyone else
+	UStalkerKinematicsAnimInstance_Default* ComputeAnimInstance = GetKinematicsAnimInstanceForCompute();
+	FStalkerAnimNode_Kinematics& KinematicsNode = ComputeAnimInstance->GetProxy().GetKinematicsRootNode();
+	KinematicsNode.GetAnimPosBones.Init(false, BonesInstance.Num());
+	TArray<TPair<Fmatrix, bool>, TInlineAllocator<32>> SavedChain;
+	for (u16 BoneID = id; BoneID != BI_NONE; BoneID = SharedData->Bones[BoneID].ParentID)
+	{
+		KinematicsNode.GetAnimPosBones[BoneID] = true;
+		SavedChain.Emplace(BonesInstance[BoneID].Transform, BonesInstance[BoneID].bUpdated);
+	}
 
-bool UStalkerKinematicsComponent::PickBone(const Fmatrix& parent_xform, pick_result& r, float dist, const Fvector& start, const Fvector& dir, u16 bone_id)
-{
-	//  !!!!
-	return false;
-	//FCollisionQueryParams CollisionQueryParams;
-	//FCollisionResponseParams CollisionResponseParams = FCollisionResponseParams::DefaultResponseParam;
-	//CollisionResponseParams.CollisionResponse.SetAllChannels(ECR_Overlap);
+	KinematicsNode.SetAnimMode(EStalkerKinematicsAnimMode::GetAnimPose);
+	KinematicsNode.GetAnimPosIgnoreCallbacks = ignore_callbacks;
+	KinematicsNode.GetAnimPosChannelMask = channel_mask;
 
-	//Fvector InStartLocation = start;
-	//Fvector InStartRotation = dir;
+	BonesTransform.AddDefaulted(SharedData->Bones.Num());
 
-	////Fmatrix P;	P.invert(parent_xform);
-	////P.transform_tiny(InStartLocation, start);
+	PerformAnimationProcessing(SkeletalMesh, ComputeAnimInstance, true, BonesTransform, OutBoneSpaceTransforms, OutRootBoneTranslation, OutCurve);
 
-	//FName BoneName = Bones[bone_id].GetName().c_str();
-	//FHitResult HitResult;
-	//if (GetWorld()->LineTraceSingleByChannel(HitResult, FVector(StalkerMath::XRayLocationToUnreal(InStartLocation)), FVector(StalkerMath::XRayLocationToUnreal(InStartLocation)) + FVector(-InStartRotation.x, InStartRotation.z, InStartRotation.y) * (dist * 100.f), ECC_WorldDynamic, CollisionQueryParams, CollisionResponseParams))
-	//{
-	//	if (HitResult.GetActor() == this&& HitResult.BoneName == BoneName)
-	//	{
-	//	//	DrawDebugLine(GetWorld(), FVector(StalkerMath::XRayLocationToUnreal(InStartLocation)), FVector(StalkerMath::XRayLocationToUnreal(InStartLocation)) + FVector(-InStartRotation.x, InStartRotation.z, InStartRotation.y) * (dist * 100.f), FColor::Green, false, 10000.f);
-	//		//DrawDebugSphere(GetWorld(), FVector(StalkerMath::XRayLocationToUnreal(InStartLocation)), 1000, 0, FColor::Green, false, 1000);
+	pos.rotation(StalkerMath::UnrealQuatToXRay(BonesTransform[id].GetRotation()));
+	pos.translate_over(StalkerMath::UnrealLocationToXRay(BonesTransform[id].GetTranslation()));
 
-	//		r.dist = HitResult.Distance /100.f;
-	//		r.normal = Fvector().set(- HitResult.Normal.X, HitResult.Normal.Z, HitResult.Normal.Y);
-	//		return true;
-	//	}
-	//}
-	////DrawDebugLine(GetWorld(), FVector(StalkerMath::XRayLocationToUnreal(InStartLocation)), FVector(StalkerMath::XRayLocationToUnreal(InStartLocation)) + FVector(-InStartRotation.x, InStartRotation.z, InStartRotation.y) * (dist * 100.f), FColor::Red, false, 10000.f);
-	////DrawDebugSphere(GetWorld(), FVector(StalkerMath::XRayLocationToUnreal(InStartLocation)), 1000, 0, FColor::Red, false, 1000);
+	int32 SavedIndex = 0;
+	for (u16 BoneID = id; BoneID != BI_NONE; BoneID = SharedData->Bones[BoneID].ParentID)
+	{
+		BonesInstance[BoneID].Transform = SavedChain[SavedIndex].Key;
+		BonesInstance[BoneID].bUpdated = SavedChain[SavedIndex].Value;
+		SavedIndex++;
+	}
+}
 
-	return false;
+UStalkerKinematicsAnimInstance_Default* UStalkerKinematicsComponent::GetKinematicsAnimInstanceForCompute()
+{
+	if (!IsValid(KinematicsAnimInstanceForCompute))
+	{
+		KinematicsAnimInstanceForCompute = NewObject< UStalkerKinematicsAnimInstance_Default>(this, TEXT("KinematicsAnimInstance"), RF_Transient);
+		KinematicsAnimInstanceForCompute->InitializeAnimation();
+	}
+	return KinematicsAnimInstanceForCompute;
 }
 
-void UStalkerKinematicsComponent::EnumBoneVertices(SEnumVerticesCallback& C, u16 bone_id)
+bool UStalkerKinematicsComponent::PickBone(const Fmatrix& parent_xform, pick_result& r, float dist, const Fvector& start, const Fvector& dir, u16 bone_id)
 {
-	FSkeletalMeshRenderData* RenderResource = KinematicsData->Mesh->GetResourceForRendering();
-	FStaticMeshVertexBuffers* StaticVertexBuffers = &RenderResource->LODRenderData[0].StaticVertexBuffers;
-	FPositionVertexBuffer* PositionVertexBuffer = &StaticVertexBuffers->PositionVertexBuffer;
-	FSkinWeightVertexBuffer* SkinWeightVertexBuffer = RenderResource->LODRenderData[0].GetSkinWeightVertexBuffer();
-	for (uint32 i = 0; SkinWeightVertexBuffer->GetNumVertices() > i; i++)
+	if (bone_id >= SharedData->Bones.Num())
 	{
-		FSkinWeightInfo SkinWeightInfo = SkinWeightVertexBuffer->GetVertexSkinWeights(i);
-	
-		for (int32 a = 0;12 > a; a++)
+		return false;
+	}
+	SharedData->BuildBonesGeometryOnce();
+	Fmatrix BoneXForm;
+	BoneXForm.mul_43(parent_xform, BonesInstance[bone_id].GetTransform());
+	// Meshes cooked without CPU access have no triangles at all
+	if (SharedData->BonesPickTree.Num() == 0)
+	{
+		return PickBoneBox(BoneXForm, r, dist, start, dir, bone_id);
+	}
+	if (SharedData->BonesPickTree[bone_id].IsEmpty())
+	{
+		return false;
+	}
+	const FStalkerKinematicsBonePickTree& PickTree = SharedData->BonesPickTree[bone_id];
+
+	// Triangles are kept in bone space, so the ray goes there instead of skinning them
+	Fmatrix InvBoneXForm;
+	InvBoneXForm.invert(BoneXForm);
+	Fvector S, D;
+	InvBoneXForm.transform_tiny(S, start);
+	InvBoneXForm.transform_dir(D, dir);
+
+	float Range = dist;
+	u32 Triangle;
+	if (!PickTree.Pick(S, D, Range, Triangle))
+	{
+		return false;
+	}
+	const Fvector* TriangleVertices = PickTree.GetTriangle(Triangle);
+	for (int32 i = 0; i < 3; i++)
+	{
+		BoneXForm.transform_tiny(r.tri[i], TriangleVertices[i]);
+	}
+	r.normal.mknormal(r.tri[0], r.tri[1], r.tri[2]);
+	r.dist = Range;
+	return true;
+}
+
+bool UStalkerKinematicsComponent::PickBoneBox(const Fmatrix& BoneXForm, pick_result& r, float dist, const Fvector& start, const Fvector& dir, u16 bone_id)
+{
+	const Fobb& Box = SharedData->Bones[bone_id].Obb;
+	Fmatrix BoxXForm;
+	Box.xform_get(BoxXForm);
+	Fmatrix WorldXForm;
+	WorldXForm.mul_43(BoneXForm, BoxXForm);
+	Fmatrix InvWorldXForm;
+	InvWorldXForm.invert(WorldXForm);
+	Fvector S, D;
+	InvWorldXForm.transform_tiny(S, start);
+	InvWorldXForm.transform_dir(D, dir);
+
+	// Slab test, the entered face gives the hit triangle and normal
+	const Fvector& HalfSize = Box.m_halfsize;
+	float Near = 0.f;
+	float Far = dist;
+	int32 Axis = -1;
+	float Side = 0.f;
+	for (int32 i = 0; i < 3; i++)
+	{
+		if (_abs(D[i]) < EPS)
 		{
-			if (SkinWeightInfo.InfluenceWeights[a]>30)
+			if (_abs(S[i]) > HalfSize[i])
 			{
-				if (SkinWeightInfo.InfluenceBones[a] == bone_id)
-				{
-					FVector3f InVertex = PositionVertexBuffer->VertexPosition(i);
-					C(StalkerMath::UnrealLocationToXRay(InVertex));
-				}
+				return false;
 			}
+			continue;
+		}
+		float T0 = (-HalfSize[i] - S[i]) / D[i];
+		float T1 = (HalfSize[i] - S[i]) / D[i];
+		float FaceSide = -1.f;
+		if (T0 > T1)
+		{
+			Swap(T0, T1);
+			FaceSide = 1.f;
+		}
+		if (T0 > Near)
+		{
+			Near = T0;
+			Axis = i;
+			Side = FaceSide;
 		}
+		Far = _min(Far, T1);
+		if (Near > Far)
+		{
+			return false;
+		}
+	}
+	// Rays starting inside the box do not hit it, like the triangle pick
+	if (Axis == -1)
+	{
+		return false;
 	}
 
+	const int32 U = (Axis + 1) % 3;
+	const int32 V = (Axis + 2) % 3;
+	const float Corners[3][2] = { { -1.f, -1.f }, { 1.f, -1.f }, { 1.f, 1.f } };
+	for (int32 i = 0; i < 3; i++)
+	{
+		Fvector Corner;
+		Corner[Axis] = HalfSize[Axis] * Side;
+		Corner[U] = HalfSize[U] * Corners[i][0];
+		Corner[V] = HalfSize[V] * Corners[i][1];
+		WorldXForm.transform_tiny(r.tri[i], Corner);
+	}
+	Fvector Normal;
+	Normal.set(0, 0, 0);
+	Normal[Axis] = Side;
+	WorldXForm.transform_dir(r.normal, Normal);
+	r.normal.normalize();
+	r.dist = Near;
+	return true;
+}
+
+void UStalkerKinematicsComponent::EnumBoneVertices(SEnumVerticesCallback& C, u16 bone_id)
+{
+	SharedData->BuildBonesGeometryOnce();
+	if (bone_id + 1 >= SharedData->BonesVerticesOffset.Num())
+	{
+		return;
+	}
+	for (int32 i = SharedData->BonesVerticesOffset[bone_id]; i < SharedData->BonesVerticesOffset[bone_id + 1]; i++)
+	{
+		C(SharedData->BonesVertices[i]);
+	}
 }
 
 u16 UStalkerKinematicsComponent::LL_BoneID(LPCSTR B)
@@ -893,7 +1028,7 @@ u16 UStalkerKinematicsComponent::LL_BoneID(LPCSTR B)
 		return 0;
 	}
 #endif
-	u16 *ID = BonesName2ID.Find(B);
+	u16 *ID = SharedData->BonesName2ID.Find(B);
 	return ID?*ID:BI_NONE;
 }
 
@@ -905,34 +1040,36 @@ u16 UStalkerKinematicsComponent::LL_BoneID(const shared_str& B)
 		return 0;
 	}
 #endif
-	u16* ID = BonesName2ID.Find(B);
+	u16* ID = SharedData->BonesName2ID.Find(B);
 	return ID ? *ID : BI_NONE;
 }
 
 LPCSTR UStalkerKinematicsComponent::LL_BoneName_dbg(u16 ID)
 {
-	shared_str* Name = BonesID2Name.Find(ID);
+	shared_str* Name = SharedData->BonesID2Name.Find(ID);
 	return Name ? Name->c_str() : "";
 }
 
 CInifile* UStalkerKinematicsComponent::LL_UserData()
 {
-	return UserData.Get();
+	return SharedData->GetUserData();
 }
 
 IBoneInstance& UStalkerKinematicsComponent::LL_GetBoneInstance(u16 bone_id)
 {
+	bBoneCallbacksDirty = true;
+	NotePoseRead();
 	return BonesInstance[bone_id];
 }
 
 const IBoneData& UStalkerKinematicsComponent::GetBoneData(u16 bone_id) const
 {
-	return Bones[bone_id];
+	return SharedData->Bones[bone_id];
 }
 
 u16 UStalkerKinematicsComponent::LL_BoneCount() const
 {
-	return Bones.Num();
+	return SharedData->Bones.Num();
 }
 
 u16 UStalkerKinematicsComponent::LL_VisibleBoneCount()
@@ -953,11 +1090,13 @@ u16 UStalkerKinematicsComponent::LL_VisibleBoneCount()
 
 const Fmatrix& UStalkerKinematicsComponent::LL_GetTransform(u16 bone_id) const
 {
+	NotePoseRead();
 	return BonesInstance[bone_id].GetTransform();
 }
 
 const Fmatrix& UStalkerKinematicsComponent::LL_GetTransform_R(u16 bone_id)
 {
+	NotePoseRead();
 	return BonesInstance[bone_id].GetTransform();
 }
 
@@ -971,7 +1110,16 @@ void UStalkerKinematicsComponent::LL_SetTransform(u16 bone_id, const Fmatrix& Ma
 
 Fobb& UStalkerKinematicsComponent::LL_GetBox(u16 bone_id)
 {
-	return Bones[bone_id].Obb;
+	if (BonesObb.Num() == 0)
+	{
+		const TArray<StalkerKinematicsBone>& Bones = SharedData->Bones;
+		BonesObb.SetNumUninitialized(Bones.Num());
+		for (int32 i = 0; i < Bones.Num(); i++)
+		{
+			BonesObb[i] = Bones[i].Obb;
+		}
+	}
+	return BonesObb[bone_id];
 }
 
 const Fbox& UStalkerKinematicsComponent::GetBox() const
@@ -982,7 +1130,7 @@ const Fbox& UStalkerKinematicsComponent::GetBox() const
 void UStalkerKinematicsComponent::LL_GetBindTransform(xr_vector<Fmatrix>& matrices)
 {
 	matrices.clear();
-	for (IBoneData &BoneData : Bones)
+	for (IBoneData &BoneData : SharedData->Bones)
 	{
 		matrices.push_back(BoneData.get_bind_transform());
 	}
@@ -1024,22 +1172,16 @@ void UStalkerKinematicsComponent::CalculateBones(BOOL bForceExact /*= FALSE*/)
 {
 	if (bForceExact)
 	{
-		for (int32 BoneID = 0; BoneID < Bones.Num(); BoneID++)
+		NotePoseRead();
+		for (int32 BoneID = 0; BoneID < SharedData->Bones.Num(); BoneID++)
 		{
 			if (LL_GetBoneVisible(u16(BoneID)))
 			{
 				StalkerKinematicsBoneInstance& BoneInstance = BonesInstance[BoneID];
-				if (BoneInstance.callback_overwrite())
-				{
-					if (BoneInstance.callback())
-						BoneInstance.callback()(&BoneInstance);
-				}
-				else
+				if (BoneInstance.callback())
 				{
-					if (BoneInstance.callback())
-					{
-						BoneInstance.callback()(&BoneInstance);
-					}
+					BoneInstance.callback()(&BoneInstance);
+					BoneInstance.CallbackFrame = Device->dwFrame;
 				}
 			}
 		}
@@ -1050,7 +1192,10 @@ void UStalkerKinematicsComponent::CalculateBones(BOOL bForceExact /*= FALSE*/)
 
 void UStalkerKinematicsComponent::CalculateBones_Invalidate()
 {
-
+	for (StalkerKinematicsBoneInstance& BoneInstance : BonesInstance)
+	{
+		BoneInstance.CallbackFrame = u32(-1);
+	}
 }
 
 void UStalkerKinematicsComponent::Callback(UpdateCallback C, void* Param)
@@ -1086,7 +1231,7 @@ IRenderVisual* UStalkerKinematicsComponent::dcast_RenderVisual()
 
 IKinematicsAnimated* UStalkerKinematicsComponent::dcast_PKinematicsAnimated()
 {
-	return  Anims.Num() ? this : nullptr;
+	return  SharedData->Anims.Num() ? this : nullptr;
 }
 
 void UStalkerKinematicsComponent::DebugRender(Fmatrix& XFORM)
@@ -1105,9 +1250,26 @@ void UStalkerKinematicsComponent::TickComponent(float DeltaTime, enum ELevelTick
 {
 	SCOPE_CYCLE_COUNTER(STAT_XRayEngineKinematics);
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	TickTracks(DeltaTime);
+	UpdateHiddenPoseSkip();
+}
 
+void UStalkerKinematicsComponent::FinalizeBoneTransform()
+{
+	Super::FinalizeBoneTransform();
+	// Runs on the game thread once the evaluation task has completed, so the flags it set are visible here
+	for (StalkerKinematicsBoneInstance& BoneInstance : BonesInstance)
+	{
+		if (BoneInstance.CallbackEvaluated)
+		{
+			BoneInstance.CallbackEvaluated = false;
+			BoneInstance.CallbackFrame = Device->dwFrame;
+		}
+	}
+}
 
-
+void UStalkerKinematicsComponent::TickTracks(float DeltaTime)
+{
 	if (GetUpdateTracksCalback())
 	{
 		SkipDeltaTime += DeltaTime;
@@ -1125,5 +1287,64 @@ false
 	SkipDeltaTime = 0;
 
 	if (MyUpdateCallback)	MyUpdateCallback(this);
+}
 
+void UStalkerKinematicsComponent::UpdateHiddenPoseSkip()
+{
+	const bool NeedSkip = GetDefault<UStalkerGameSettings>()->SkipHiddenKinematicsPose && !HasPoseConsumers();
+	if (NeedSkip == bHiddenPoseSkipped)
+	{
+		return;
+	}
+	if (NeedSkip)
+	{
+		SkippedVisibilityBasedAnimTickOption = VisibilityBasedAnimTickOption;
+		VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+	}
+	else
+	{
+		VisibilityBasedAnimTickOption = SkippedVisibilityBasedAnimTickOption;
+	}
+	bHiddenPoseSkipped = NeedSkip;
+}
+
+bool UStalkerKinematicsComponent::HasPoseConsumers()
+{
+	if (MyUpdateCallback)
+	{
+		return true;
+	}
+	// a pose read by the game is likely to be read again in the next frames
+	if (PoseReadFrame != MAX_uint64 && GFrameCounter - PoseReadFrame <= PoseReadGraceFrames)
+	{
+		return true;
+	}
+	if (bBoneCallbacksDirty)
+	{
+		BoneCallbackCount = 0;
+		for (StalkerKinematicsBoneInstance& BoneInstance : BonesInstance)
+		{
+			BoneCallbackCount += BoneInstance.callback() ? 1 : 0;
+		}
+		bBoneCallbacksDirty = false;
+	}
+	return BoneCallbackCount != 0;
+}
+
+void UStalkerKinematicsComponent::NotePoseRead() const
+{
+	PoseReadFrame = GFrameCounter;
+	if (bHiddenPoseSkipped && IsInGameThread())
+	{
+		// the pose is as old as the skip, a read is the first sign that it is needed again
+		const_cast<UStalkerKinematicsComponent*>(this)->WakeSkippedPose();
+	}
+}
+
+void UStalkerKinematicsComponent::WakeSkippedPose()
+{
+	VisibilityBasedAnimTickOption = SkippedVisibilityBasedAnimTickOption;
+	bHiddenPoseSkipped = false;
+	TickAnimation(0, false);
+	RefreshBoneTransforms();
 }
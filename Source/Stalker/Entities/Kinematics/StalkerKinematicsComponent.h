@@ -3,6 +3,7 @@
 #include "Resources/SkeletonMesh/StalkerKinematicsBoneInstance.h"
 #include "Resources/SkeletonMesh/StalkerKinematicsAnimData.h"
 #include "Resources/SkeletonMesh/StalkerKinematicsAnimsData.h"
+#include "Resources/SkeletonMesh/StalkerKinematicsSharedData.h"
 THIRD_PARTY_INCLUDES_START
 #include "XrRender/Public/animation_blend.h"
 #include "XrEngine/vis_common.h"
@@ -21,6 +22,10 @@ public:
 #if WITH_EDITOR
 	void											InitilizeEditor						();
 #endif
+	// Back to the state Initilize left it in, for handing out again with the same data
+	void											ResetForReuse						();
+	// Detached from any actor and not locked by an xray object
+	bool											IsReusable							() const;
 	void											PostLoad							() override;
 	void											BeginDestroy						() override;
 	void											Lock								(void* Parent) override;
@@ -33,6 +38,12 @@ public:
 
 
 	void											TickComponent						(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	void											FinalizeBoneTransform				() override;
+	void											TickTracks							(float DeltaTime);
+	// Bone or update callbacks and game side pose reads need the evaluated pose even when the mesh is not rendered
+	bool											HasPoseConsumers					();
+	// Applies SkipHiddenKinematicsPose, the visibility tick option it replaced is put back once the pose is needed again
+	void											UpdateHiddenPoseSkip				();
 
 //IKinematics
 	void											Bone_Calculate						(const IBoneData* bd, const Fmatrix* parent) override;
@@ -138,15 +149,13 @@ public:
 	UPROPERTY()
 	class UStalkerKinematicsData*					KinematicsData;
 
-	TArray<StalkerKinematicsBone>					Bones;
-	TMap<u16, shared_str>							BonesID2Name;
+	TSharedPtr<class FStalkerKinematicsSharedData>	SharedData;
 
-	TArray<FStalkerKinematicsAnimData>				Anims;
-	TArray <TSharedPtr<CBlend>>						BlendsCycles[4];
-	TArray<TSharedPtr<CBlend>>						BlendsFX[4];
+	inline CBlend&									GetBlend							(u16 Handle) { return BlendsPool[Handle]; }
 
-
-	TArray< FStalkerKinematicsAnimsBonesPart>		BonesParts;
+	// Handles into BlendsPool, kept in play order
+	TArray<u16, TFixedAllocator<MAX_BLENDED_POOL>>	BlendsCycles[MAX_PARTS];
+	TArray<u16, TFixedAllocator<MAX_BLENDED>>		BlendsFX[MAX_PARTS];
 
 	float											ChannelsFactor[4];
 
@@ -154,23 +163,32 @@ public:
 	TArray<StalkerKinematicsBoneInstance>			BonesInstance;
 
 private:	
+	friend class FStalkerKinematicsReuseTest;
+	friend class FStalkerKinematicsHiddenPoseSkipTest;
+	void											InitilizeBones						();
 	void											BlendSetup							(CBlend& Blend, u32 PartID, u8 Channel, MotionID InMotionID, bool  IsMixing, float BlendAccrue,  float Speed, bool NoLoop, PlayCallback Callback, LPVOID CallbackParam);
 	void											FXBlendSetup						(CBlend& Blend, MotionID InMotionID, float BlendAccrue, float BlendFalloff, float Power, float Speed, u16 Bone);
-	TSharedPtr<CBlend>								CreateBlend							();
-	void											DestroyBlend						(TSharedPtr<CBlend>& Blend);
-
-	TArray <TSharedPtr<CBlend>>						BlendsPool;
+	// INDEX_NONE once the pool is exhausted
+	int32											CreateBlend							();
+	void											DestroyBlend						(u16 Handle);
+	void											ResetBlends							();
+	// Bone_GetAnimPos for channel masks that differ from the evaluated pose
+	void											Bone_GetAnimPosMasked				(Fmatrix& pos, u16 id, u8 channel_mask, bool ignore_callbacks);
+	class UStalkerKinematicsAnimInstance_Default*	GetKinematicsAnimInstanceForCompute	();
+	// Records a game side read of the pose, a skipped pose is evaluated before it is handed out
+	void											NotePoseRead						() const;
+	void											WakeSkippedPose						();
+	// PickBone against the bone box, for meshes without CPU geometry
+	bool											PickBoneBox							(const Fmatrix& BoneXForm, pick_result& r, float dist, const Fvector& start, const Fvector& dir, u16 bone_id);
+
+	// Played blends never move, so CBlend pointers given out stay valid until the blend is freed
+	CBlend											BlendsPool[MAX_BLENDED_POOL];
+	TArray<u16, TFixedAllocator<MAX_BLENDED_POOL>>	BlendsFree;
 
 	vis_data										VisData;
-    TSharedPtr<CInifile>							UserData;
-	TMap<shared_str, u16>							BonesName2ID;
 	BonesVisible									SelfBonesVisible;
-
-	TArray<CMotionDef>								AnimsDef;
-	TMap<shared_str, u32>							AnimsName2ID;
-
-	TMap<shared_str, u32>							BonesPartsName2ID;
-	TMap<u32, u32>									BonesPartsBoneID2ID;
+	// Copied from SharedData on the first LL_GetBox, callers may write through the returned reference
+	TArray<Fobb>									BonesObb;
 	shared_str										DataName;
 
 
@@ -186,6 +204,13 @@ private:
 	UPROPERTY(Transient)
 	float											SkipDeltaTime;
 
+	EVisibilityBasedAnimTickOption					SkippedVisibilityBasedAnimTickOption;
+	bool											bHiddenPoseSkipped = false;
+	// Bone callbacks are set through the instances LL_GetBoneInstance hands out, so they are recounted only after that
+	int32											BoneCallbackCount = 0;
+	bool											bBoneCallbacksDirty = false;
+	mutable uint64									PoseReadFrame = MAX_uint64;
+
 	UPROPERTY(Transient)
 	class UStalkerKinematicsAnimInstance_Default*	KinematicsAnimInstanceForCompute;
 #if WITH_EDITORONLY_DATA
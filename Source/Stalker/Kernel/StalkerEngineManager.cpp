@@ -248,6 +248,7 @@ void FStalkerEngineManager::ReInitialized(EStalkerGame Game)
 		FSName = TEXT("fsgame");
 	}
 	CurrentGame = Game;
+	ResourcesManager->ResetResolvedPaths();
 	switch (Game)
 	{
 	case EStalkerGame::CS:
@@ -305,10 +306,15 @@ void FStalkerEngineManager::LoadDefaultWorld()
 	WorldStatus = EStalkerWorldStatus::None;
 	CurrentWorldPath.Reset();
 	CurrentWorldName.Empty();
+	GetResourcesManager()->ResetResolvedPaths();
 }
 
 bool FStalkerEngineManager::LoadWorld(FString LevelName)
 {
+	GetResourcesManager()->FlushPrefetchedKinematics();
+	GetResourcesManager()->TrimKinematicsPool();
+	// level meshes resolve against the current world name
+	GetResourcesManager()->ResetResolvedPaths();
 	CurrentWorldName.Empty();
 	CurrentWorldPath.Reset();
 	UWorld* CurrentWorld = GWorld;
@@ -338,6 +344,7 @@ bool FStalkerEngineManager::LoadWorld(FString LevelName)
 			WorldStatus = EStalkerWorldStatus::Failure;
 			return false;
 		}
+		GetResourcesManager()->PrefetchKinematics(LevelInfo->Visuals);
 		return true;
 	}
 	const ETravelType TravelType = TRAVEL_Absolute;
@@ -355,6 +362,8 @@ bool FStalkerEngineManager::LoadWorld(FString LevelName)
 	WorldStatus = EStalkerWorldStatus::Loading;
 	CurrentWorldPath = LevelInfo->Map;
 	CurrentWorldName = LevelInfo->Name;
+	// visuals stream in while the map travels, spawns then find them loaded
+	GetResourcesManager()->PrefetchKinematics(LevelInfo->Visuals);
 	GEngine->SetClientTravel(CurrentWorld, *Cmd, TravelType);
 	return true;
 }
@@ -425,6 +434,8 @@ void FStalkerEngineManager::OnViewportResized(FViewport* InViewport, uint32)
 
 void FStalkerEngineManager::OnEndPlayMap()
 {
+	GetResourcesManager()->FlushPrefetchedKinematics();
+	GetResourcesManager()->TrimKinematicsPool();
 #if WITH_EDITOR
 	ReInitialized(GetDefault<UStalkerGameSettings>()->EditorStartupGame);
 #endif
@@ -30,6 +30,14 @@ public:
 	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Editor")
 	EStalkerGame EditorStartupGame;
 
+	// Kinematics without bone or update callbacks evaluate their pose only while rendered
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Kinematics")
+	bool SkipHiddenKinematicsPose = false;
+
+	// Destroyed kinematics components kept per kinematics data for reuse, dropped on level load and memory trim
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Kinematics")
+	int32 KinematicsPoolSize = 8;
+
 
 #if WITH_EDITORONLY_DATA
 	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Game",meta = (DisplayName = "Levels Of Shadow of Chernobyl"))
@@ -55,6 +63,9 @@ public:
 	bool	IgnoreIncludeInBuildSpawn = false;
 	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Play In Editor")
 	bool	VerifySpaceRestrictorBorders = true;
+	// Base of the per zone random streams that pick artefact spawn positions
+	UPROPERTY(Config, EditAnywhere, BlueprintReadOnly, Category = "Play In Editor")
+	int32	ArtefactSpawnSeed		= 0;
 #endif
 #if WITH_EDITOR
 	const TMap<FName, FStalkerLevelInfo> & GetCurrentLevels() const;
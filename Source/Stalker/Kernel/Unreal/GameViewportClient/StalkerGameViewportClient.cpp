@@ -10,6 +10,7 @@ THIRD_PARTY_INCLUDES_START
 THIRD_PARTY_INCLUDES_END
 #include "Kernel/StalkerEngineManager.h"
 #include "Kernel/XRay/Core/XRayInput.h"
+#include "Kernel/XRay/Core/XRayDevice.h"
 #include "Kernel/XRay/Render/Resources/SkeletonMesh/XRaySkeletonMeshManager.h"
 #include "../GameMode/StalkerGameMode.h"
 #include "../WorldSettings/StalkerWorldSettings.h"
@@ -154,10 +155,7 @@ void UStalkerGameViewportClient::Tick(float DeltaTime)
 		GXRaySkeletonMeshManager->Flush();
 		{
 			SCOPE_CYCLE_COUNTER(STAT_XRayEngineMTFrame);
-			for (u32 pit = 0; pit < Device->seqParallel.size(); pit++)
-				Device->seqParallel[pit]();
-			Device->seqParallel.clear();
-			Device->seqFrameMT.Process(rp_Frame);
+			static_cast<XRayDevice*>(Device)->ProcessParallel();
 		}
 	}
 }
@@ -29,6 +29,9 @@ public:
 	float						AIMapCanDOWN = 400.f;
 	UPROPERTY(EditAnywhere, Category = "Stalker|Editor")
 	float						AIMapTestHeight = 150.f;
+	// Generates in parallel against a baked triangle snapshot, node positions can differ from world traces in the last bits
+	UPROPERTY(EditAnywhere, Category = "Stalker|Editor")
+	bool						AIMapGenerateFromCollisionSnapshot = false;
 	UPROPERTY()
 	bool						NeedRebuildSpawn = true;
 #endif
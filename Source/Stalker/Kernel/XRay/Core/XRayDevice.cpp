@@ -2,6 +2,9 @@
 THIRD_PARTY_INCLUDES_START
 #include "XrEngine/IGame_Persistent.h"
 THIRD_PARTY_INCLUDES_END
+DECLARE_CYCLE_STAT(TEXT("XRay ~ Parallel Job"), STAT_XRayEngineParallelJob, STATGROUP_XRayEngine);
+DECLARE_CYCLE_STAT(TEXT("XRay ~ MT Frame Job"), STAT_XRayEngineMTFrameJob, STATGROUP_XRayEngine);
+DECLARE_DWORD_COUNTER_STAT(TEXT("XRay ~ Parallel Jobs"), STAT_XRayEngineParallelJobs, STATGROUP_XRayEngine);
 
 XRayDevice::XRayDevice()
 {
@@ -108,11 +111,61 @@ CStatsPhysics* _BCL XRayDevice::StatPhysics()
 
 void _BCL XRayDevice::AddSeqFrame(pureFrame* f, bool mt)
 {
-	seqFrameMT.Add(f, REG_PRIORITY_LOW);
+	FScopeLock Lock(&FrameMTSection);
+	if (mt)
+	{
+		FrameMT.AddUnique(f);
+	}
+	else
+	{
+		seqFrame.Add(f, REG_PRIORITY_LOW);
+	}
 }
 
 void _BCL XRayDevice::RemoveSeqFrame(pureFrame* f)
 {
+	FScopeLock Lock(&FrameMTSection);
+	const int32 Index = FrameMT.Find(f);
+	if (Index != INDEX_NONE)
+	{
+		FrameMT[Index] = nullptr;
+	}
+	seqFrame.Remove(f);
 	seqFrameMT.Remove(f);
 }
 
+void XRayDevice::ProcessParallel()
+{
+	// Jobs queue more jobs into seqParallel while it is walked, so it is drained by index on this thread only
+	for (u32 pit = 0; pit < seqParallel.size(); pit++)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_XRayEngineParallelJob);
+		seqParallel[pit]();
+	}
+	INC_DWORD_STAT_BY(STAT_XRayEngineParallelJobs, seqParallel.size());
+	seqParallel.clear();
+
+	// MT frame callbacks consume what the parallel jobs produced and run one after another behind them, as they did on the old secondary thread
+	{
+		FScopeLock Lock(&FrameMTSection);
+		FrameMT.Remove(nullptr);
+	}
+	for (int32 i = 0; ; i++)
+	{
+		pureFrame* Frame;
+		{
+			FScopeLock Lock(&FrameMTSection);
+			if (i >= FrameMT.Num())
+			{
+				break;
+			}
+			Frame = FrameMT[i];
+		}
+		if (Frame)
+		{
+			SCOPE_CYCLE_COUNTER(STAT_XRayEngineMTFrameJob);
+			Frame->OnFrame();
+		}
+	}
+	seqFrameMT.Process(rp_Frame);
+}
@@ -16,8 +16,11 @@ public:
 	CStatsPhysics*		StatPhysics() override;
 	void				AddSeqFrame(pureFrame* f, bool mt) override;
 	void				RemoveSeqFrame(pureFrame* f) override;
+	void				ProcessParallel	();
 private:
 	bool				IsTimerPaused;
 	int32				SndEmitters = -1;
+	TArray<pureFrame*>	FrameMT;
+	FCriticalSection	FrameMTSection;
 
 };
\ No newline at end of file
@@ -283,6 +283,7 @@ void XRayRenderInterface::model_Logging(BOOL bEnable)
 
 void XRayRenderInterface::models_Prefetch()
 {
+	GStalkerEngineManager->GetResourcesManager()->PrefetchLevelKinematics(GStalkerEngineManager->GetCurrentWorldName());
 }
 
 void XRayRenderInterface::models_Clear(BOOL b_complete)
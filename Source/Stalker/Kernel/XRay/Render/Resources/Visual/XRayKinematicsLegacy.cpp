@@ -381,11 +381,23 @@ void	XRayKinematicsLegacy::IBoneInstances_Create()
 	bone_instances.AddDefaulted(size);
 	for (size_t i = 0; i < size; i++)
 		bone_instances[i].construct();
+
+	bone_boxes.SetNum(size);
+	for (size_t i = 0; i < size; i++)
+	{
+		const Fobb& obb = (*bones)[i]->obb;
+		Fmatrix& M = bone_boxes[i];
+		obb.xform_get(M);
+		M.i.mul(obb.m_halfsize.x);
+		M.j.mul(obb.m_halfsize.y);
+		M.k.mul(obb.m_halfsize.z);
+	}
 }
 
 void	XRayKinematicsLegacy::IBoneInstances_Destroy()
 {
 	bone_instances.Empty();
+	bone_boxes.Empty();
 }
 
 
@@ -419,6 +431,7 @@ XRayKinematicsLegacy::XRayKinematicsLegacy()
 {
 	UnrealParent = nullptr;
 	Update_Callback = 0;
+	Update_Visibox = FALSE;
 #ifdef DEBUG
 	dbg_single_use_marker = FALSE;
 #endif
@@ -600,55 +613,53 @@ void XRayKinematicsLegacy::CalculateBones(BOOL bForceExact)
 		// mark
 		UCalc_Visibox = -(::Random.randI(psSkeletonUpdate - 1));
 
-		// the update itself
-		Fbox	Box; Box.invalidate();
-		for (u32 b = 0; b < bones->size(); b++)
-		{
-			if (!LL_GetBoneVisible(u16(b)))		continue;
-			Fobb& obb = (*bones)[b]->obb;
-			Fmatrix  Mbone = bone_instances[b].GetTransform();
-			Fmatrix		Mbox;	obb.xform_get(Mbox);
-			Fmatrix		X;		X.mul_43(Mbone, Mbox);
-			Fvector& S = obb.m_halfsize;
-
-			Fvector			P, A;
-			A.set(-S.x, -S.y, -S.z); X.transform_tiny(P, A); Box.modify(P);
-			A.set(-S.x, -S.y, S.z); X.transform_tiny(P, A); Box.modify(P);
-			A.set(S.x, -S.y, S.z); X.transform_tiny(P, A); Box.modify(P);
-			A.set(S.x, -S.y, -S.z); X.transform_tiny(P, A); Box.modify(P);
-			A.set(-S.x, S.y, -S.z); X.transform_tiny(P, A); Box.modify(P);
-			A.set(-S.x, S.y, S.z); X.transform_tiny(P, A); Box.modify(P);
-			A.set(S.x, S.y, S.z); X.transform_tiny(P, A); Box.modify(P);
-			A.set(S.x, S.y, -S.z); X.transform_tiny(P, A); Box.modify(P);
-		}
-		if (bones->size())
-		{
-			// previous frame we have updated box - update sphere
-			VisData.box.min = (Box.min);
-			VisData.box.max = (Box.max);
-			VisData.box.getsphere(VisData.sphere.P, VisData.sphere.R);
-		}
-#ifdef DEBUG
-		// Validate
-		VERIFY3(_valid(Vis.box.min) && _valid(Vis.box.max), "Invalid bones-xform in model", DebugName.c_str());
-		if (Vis.sphere.R > 1000.f)
-		{
-			for (u16 ii = 0; ii < LL_BoneCount(); ++ii) {
-				Fmatrix tr;
-				tr = LL_GetTransform(ii);
-				Log("bone ", LL_BoneName_dbg(ii));
-				Log("bone_matrix", tr);
-			}
-			Log("end-------");
-		}
-		VERIFY3(Vis.sphere.R < 1000.f, "Invalid bones-xform in model", DebugName.c_str());
-#endif
+		// the boxes are rebuilt on demand, see Visibox_Update
+		Visibox_Invalidate();
 	}
 
 	//
 	if (Update_Callback)	Update_Callback(this);
 }
 
+void XRayKinematicsLegacy::Visibox_Update()
+{
+	if (!Update_Visibox)
+		return;
+	Update_Visibox = FALSE;
+
+	Fbox	Box; Box.invalidate();
+	for (u32 b = 0; b < bones->size(); b++)
+	{
+		if (!LL_GetBoneVisible(u16(b)))		continue;
+		Fmatrix		X;		X.mul_43(bone_instances[b].GetTransform(), bone_boxes[b]);
+		Visibox_Modify(Box, X);
+	}
+	if (bones->size())
+	{
+		VisData.box.min = (Box.min);
+		VisData.box.max = (Box.max);
+		VisData.box.getsphere(VisData.sphere.P, VisData.sphere.R);
+	}
+#ifdef DEBUG
+	// Validate
+	VERIFY3(_valid(VisData.box.min) && _valid(VisData.box.max), "Invalid bones-xform in model", DebugName.c_str());
+	VERIFY3(VisData.sphere.R < 1000.f, "Invalid bones-xform in model", DebugName.c_str());
+#endif
+}
+
+void XRayKinematicsLegacy::Visibox_Modify(Fbox& Box, const Fmatrix& X)
+{
+	// world aabb of the bone obb: center is the translation, extent is the abs-sum of the scaled axes
+	Fvector		E;
+	E.x = _abs(X.i.x) + _abs(X.j.x) + _abs(X.k.x);
+	E.y = _abs(X.i.y) + _abs(X.j.y) + _abs(X.k.y);
+	E.z = _abs(X.i.z) + _abs(X.j.z) + _abs(X.k.z);
+
+	Fvector		P;
+	P.sub(X.c, E);	Box.modify(P);
+	P.add(X.c, E);	Box.modify(P);
+}
+
 void XRayKinematicsLegacy::CalculateBones_Invalidate()
 {
 	UCalc_Time = 0x0;
@@ -29,6 +29,9 @@ public:
 	BonesVisible					bonesvisible;
 	IC void						Visibility_Invalidate() { Update_Visibility = TRUE; };
 	void						Visibility_Update();
+	IC void						Visibox_Invalidate() { Update_Visibox = TRUE; };
+	void						Visibox_Update();
+	static void					Visibox_Modify(Fbox& Box, const Fmatrix& X);
 	virtual void				IBoneInstances_Create();
 	virtual void				IBoneInstances_Destroy();
 
@@ -121,7 +124,8 @@ public:
 		check(bone_id < LL_BoneCount());
 		return (*bones)[bone_id]->obb;
 	}
-	virtual const Fbox& GetBox() const { return VisData.box; }
+	virtual const Fbox& GetBox() const { const_cast<XRayKinematicsLegacy*>(this)->Visibox_Update(); return VisData.box; }
+	vis_data& getVisData() override { Visibox_Update(); return VisData; }
 
 	virtual void LL_GetBindTransform(xr_vector<Fmatrix>& matrices);
 	virtual int  LL_GetBoneGroups(xr_vector<xr_vector<u16>>& groups);
@@ -167,6 +171,7 @@ public:
 	XRaySkeletonVisual *m_lod;
 
 	TArray<XRayBoneInstanceLegacy> bone_instances; // bone instances
+	TArray<Fmatrix> bone_boxes;					   // bone obb transforms in bone space, with halfsize folded into the axes
 protected:
 	//SkeletonWMVec				wallmarks;
 	u32 wm_frame;
@@ -183,6 +188,7 @@ protected:
 	accel *bone_map_P; // bones  associations	(shared)	- sorted by name-pointer
 
 	BOOL Update_Visibility;
+	BOOL Update_Visibox;
 	u32 UCalc_Time;
 	s32 UCalc_Visibox;
 
@@ -4,6 +4,9 @@
 
 UStalkerAIMap::UStalkerAIMap()
 {
+#if WITH_EDITORONLY_DATA
+	NodesIndex.Reset(Nodes, NodeSize);
+#endif
 }
 
 void UStalkerAIMap::Serialize(FArchive& Ar)
@@ -13,9 +16,9 @@ void UStalkerAIMap::Serialize(FArchive& Ar)
 	{
 		int32 CurrentVersion = Version;
 		Ar << CurrentVersion;
-		check(CurrentVersion >= 0&& CurrentVersion <= 1);
+		check(CurrentVersion >= 0&& CurrentVersion <= Version);
 
-		if (CurrentVersion == 1)
+		if (CurrentVersion >= 1)
 		{
 			Ar << LevelGraphHeader.count << LevelGraphHeader.size << LevelGraphHeader.size_y << static_cast<hdrNODES&>(LevelGraphHeader).version;
 			if (LevelGraphHeader.count)
@@ -32,12 +35,9 @@ void UStalkerAIMap::Serialize(FArchive& Ar)
 			if (Ar.IsLoading())
 			{
 				LevelGraphVertices.Empty(Count);
-				LevelGraphVertices.AddDefaulted(Count);
-			}
-			for (CVertex& Node : LevelGraphVertices)
-			{
-				Ar.Serialize(&Node,sizeof(CVertex));
+				LevelGraphVertices.SetNumUninitialized(Count);
 			}
+			Ar.Serialize(LevelGraphVertices.GetData(), Count * sizeof(CVertex));
 			if (Ar.IsLoading())
 			{
 				RefreshAIMapMetadata();
@@ -57,21 +57,16 @@ void UStalkerAIMap::Serialize(FArchive& Ar)
 			{
 				bool SavedNeedRebuild = NeedRebuild;
 				ClearNodes();
-				Nodes.Empty(Count);
-				Nodes.AddDefaulted(Count);
-				for (FStalkerAIMapNode*& Node : Nodes)
-				{
-					Node = new FStalkerAIMapNode;
-				}
+				Nodes.SetNum(Count);
 				NeedRebuild			= SavedNeedRebuild;
 			}
-			if (Ar.IsSaving())
+			if (CurrentVersion >= 2)
 			{
-				CalculateIndex();
+				Nodes.SerializeBulk(Ar, CompressNodePositions);
 			}
-			for (FStalkerAIMapNode* Node : Nodes)
+			else
 			{
-				Node->Serialize(Ar, this);
+				Nodes.SerializeLegacy(Ar);
 			}
 			if (Ar.IsLoading())
 			{
@@ -125,65 +120,23 @@ void UStalkerAIMap::InvalidAIMap()
 	Modify();
 }
 
-void UStalkerAIMap::AutoLink(FStalkerAIMapNode* Node)
+void UStalkerAIMap::AutoLink(int32 Node, float MaxDown, float MaxUp)
 {
-	FVector3f Position = Node->Position;
-	FStalkerAIMapNode* LeftNode = FindNode(Position + FVector3f(NodeSize, 0, 0));
-	FStalkerAIMapNode* ForwardNode = FindNode(Position + FVector3f(0, NodeSize, 0));
-	FStalkerAIMapNode* RightNode = FindNode(Position + FVector3f(-NodeSize, 0, 0));
-	FStalkerAIMapNode* BackwardNode = FindNode(Position + FVector3f(0, -NodeSize, 0));
-	if (LeftNode == Node)
-	{
-		LeftNode = nullptr;
-	}
-
-	if (ForwardNode == Node)
-	{
-		ForwardNode = nullptr;
-	}
-
-	if (RightNode == Node)
+	int32 Neighbours[4];
+	NodesIndex.FindNeighbours(Nodes.Positions[Node], MaxDown, MaxUp, Neighbours);
+	FStalkerAIMapNodeLinks& Links = Nodes.Links[Node];
+	for (int32 Link = 0; Link < 4; Link++)
 	{
-		RightNode = nullptr;
-	}
-
-	if (BackwardNode == Node)
-	{
-		BackwardNode = nullptr;
-	}
-
-
-	if (LeftNode)
-	{
-		if (LeftNode->NodeRight == nullptr)
+		const int32 Neighbour = Neighbours[Link];
+		if (Neighbour == INDEX_NONE || Neighbour == Node)
 		{
-			Node->NodeLeft = LeftNode;
-			LeftNode->NodeRight = Node;
+			continue;
 		}
-	}
-	if (RightNode)
-	{
-		if (RightNode->NodeLeft == nullptr)
+		const int32 BackLink = (Link + 2) % 4;
+		if (Nodes.Links[Neighbour][BackLink] == INDEX_NONE)
 		{
-			Node->NodeRight = RightNode;
-			RightNode->NodeLeft = Node;
-		}
-
-	}
-	if (BackwardNode)
-	{
-		if (BackwardNode->NodeForward == nullptr)
-		{
-			Node->NodeBackward = BackwardNode;
-			BackwardNode->NodeForward = Node;
-		}
-	}
-	if (ForwardNode)
-	{
-		if (ForwardNode->NodeBackward == nullptr)
-		{
-			Node->NodeForward = ForwardNode;
-			ForwardNode->NodeBackward = Node;
+			Links[Link] = Neighbour;
+			Nodes.Links[Neighbour][BackLink] = Node;
 		}
 	}
 }
@@ -205,380 +158,197 @@ void UStalkerAIMap::ClearAIMap()
 void UStalkerAIMap::CalculateAABB(const FBox3f& NewAABB)
 {
 	AABB = NewAABB;
-	for (FStalkerAIMapNode* Node : Nodes)
+	for (const FVector3f& Position : Nodes.Positions)
 	{
-		AABB += Node->Position + FVector3f(NodeSize * 0.5f, NodeSize * 0.5f, 2.f);
-		AABB += Node->Position + FVector3f(-NodeSize * 0.5f, -NodeSize * 0.5f, -2.f);
-	}
-	if (AABB.GetSize().X <= NodesHashSize * NodeSize)
-	{
-		AABB.Max.X += NodesHashSize * NodeSize;
-
-	}
-	if (AABB.GetSize().Y <= NodesHashSize * NodeSize)
-	{
-		AABB.Max.Y += NodesHashSize * NodeSize;
-
+		AABB += Position + FVector3f(NodeSize * 0.5f, NodeSize * 0.5f, 2.f);
+		AABB += Position + FVector3f(-NodeSize * 0.5f, -NodeSize * 0.5f, -2.f);
 	}
 }
 
 void UStalkerAIMap::HashFill(const FBox3f& NewAABB)
 {
-	HashClear();
 	CalculateAABB(NewAABB);
-	for (FStalkerAIMapNode* Node : Nodes)
-	{
-		TArray<FStalkerAIMapNode*>* NodesHashList = GetEditorHashMap(Node->Position);
-		bool* NodesHashSelect = GetEditorHashSelected(Node->Position);
-		check(NodesHashList);
-		check(NodesHashSelect);
-		NodesHashList->Add(Node);
-		*NodesHashSelect |= EnumHasAnyFlags(Node->Flags, EStalkerAIMapNodeFlags::Selected);
-	}
+	NodesIndex.Build(Nodes, NodeSize);
+	RefreshHashSelected();
 }
 
 void UStalkerAIMap::HashClear()
 {
-	for (int32 x = 0; x <= NodesHashSize; x++)
-	{
-		for (int32 y = 0; y <= NodesHashSize; y++)
-		{
-			NodesHash[x][y].Reset(0);
-			NodesHashSelected[x][y] = false;
-		}
-	}
-
+	NodesIndex.Reset(Nodes, NodeSize);
+	NumSelected = 0;
 }
 
-void UStalkerAIMap::RemoveSelect()
+void UStalkerAIMap::RemoveNode(int32 Node)
 {
 	NeedRebuild = true;
-	for (FStalkerAIMapNode* Node : Nodes)
+	if (Nodes.IsSelected(Node))
 	{
-		if (EnumHasAnyFlags(Node->Flags, EStalkerAIMapNodeFlags::Selected))
-		{
-			TArray<FStalkerAIMapNode*>* NodesHashList = GetEditorHashMap(Node->Position);
-			if (NodesHashList)NodesHashList->Remove(Node);
-		}
+		NumSelected--;
 	}
-	for (int32 i = 0; i < Nodes.Num(); i++)
+	ReplaceLinks(Node, INDEX_NONE);
+	NodesIndex.Remove(Node);
+	const int32 Last = Nodes.Num() - 1;
+	if (Last != Node)
 	{
-		FStalkerAIMapNode* Node = Nodes[i];
-		for (int32 link = 0; link < 4; link++)
-		{
-			if (Node->Nodes[link] && EnumHasAnyFlags(Node->Nodes[link]->Flags, EStalkerAIMapNodeFlags::Selected))
-			{
-				Node->Nodes[link] = nullptr;
-			}
-		}
+		ReplaceLinks(Last, Node);
 	}
-	for (int32 i = 0; i < Nodes.Num(); i++)
+	if (Nodes.RemoveAtSwap(Node) != INDEX_NONE)
 	{
-		FStalkerAIMapNode* Node = Nodes[i];
-		if (EnumHasAnyFlags(Node->Flags, EStalkerAIMapNodeFlags::Selected))
-		{
-			Nodes.Remove(Node);
-			delete Node;
-			i = 0;
-		}
+		NodesIndex.Move(Last, Node);
 	}
-	HashFill();
 }
 
-TArray<FStalkerAIMapNode*>* UStalkerAIMap::GetEditorHashMap(const FVector3f& InPosition)
+void UStalkerAIMap::RemoveSelect()
 {
-	if (!AABB.IsValid)
+	NeedRebuild = true;
+	if (!NumSelected)
 	{
-		return nullptr;
+		return;
 	}
-	FVector3f	VMscale, Scale, Position = FVector3f(FMath::Floor(InPosition.X / NodeSize) * NodeSize, FMath::Floor(InPosition.Y / NodeSize) * NodeSize, InPosition.Z);
-
-	VMscale.Set(AABB.Max.X - AABB.Min.X, AABB.Max.Y - AABB.Min.Y, AABB.Max.Z - AABB.Min.Z);
-	Scale.Set(float(NodesHashSize), float(NodesHashSize), 0);
-	Scale /= VMscale;
-
-	int32 ix = VMscale.X == 0 ? 0 : static_cast<int32>(FMath::Floor((Position.X - AABB.Min.X) * Scale.X));
-	int32 iy = VMscale.Y == 0 ? 0 : static_cast<int32>(FMath::Floor((Position.Y - AABB.Min.Y) * Scale.Y));
-
-	return (ix <= NodesHashSize && ix >= 0 && iy <= NodesHashSize && iy >= 0) ? &NodesHash[ix][iy] : 0;
-}
-
-bool* UStalkerAIMap::GetEditorHashSelected(const FVector3f& InPosition)
-{
-	if (!AABB.IsValid)
+	for (int32 Node = Nodes.Num() - 1; Node >= 0 && NumSelected; Node--)
 	{
-		return nullptr;
+		if (Nodes.IsSelected(Node))
+		{
+			RemoveNode(Node);
+		}
 	}
-	FVector3f	VMscale, Scale, Position = FVector3f(FMath::Floor(InPosition.X / NodeSize) * NodeSize, FMath::Floor(InPosition.Y / NodeSize) * NodeSize, InPosition.Z);
-
-	VMscale.Set(AABB.Max.X - AABB.Min.X, AABB.Max.Y - AABB.Min.Y, AABB.Max.Z - AABB.Min.Z);
-	Scale.Set(float(NodesHashSize), float(NodesHashSize), 0);
-	Scale /= VMscale;
-
-	int32 ix = VMscale.X == 0 ? 0 : static_cast<int32>(FMath::Floor((Position.X - AABB.Min.X) * Scale.X));
-	int32 iy = VMscale.Y == 0 ? 0 : static_cast<int32>(FMath::Floor((Position.Y - AABB.Min.Y) * Scale.Y));
+	NumSelected = 0;
+	CalculateAABB();
+}
 
-	return (ix <= NodesHashSize && ix >= 0 && iy <= NodesHashSize && iy >= 0) ? &NodesHashSelected[ix][iy] : 0;
+void UStalkerAIMap::SetNodeHeight(int32 Node, float Z)
+{
+	NeedRebuild = true;
+	NodesIndex.Remove(Node);
+	FVector3f& Position = Nodes.Positions[Node];
+	Position.Z = Z;
+	NodesIndex.Add(Node);
+	AABB += Position + FVector3f(0, 0, 2.f);
+	AABB += Position + FVector3f(0, 0, -2.f);
 }
 
 int32 UStalkerAIMap::GetCountSelected()
 {
-	int32 Counter = 0;
-	for (int32 x = 0; x <= NodesHashSize; x++)
-	{
-		for (int32 y = 0; y <= NodesHashSize; y++)
-		{
-			if (NodesHashSelected[x][y])
-			{
-				for (FStalkerAIMapNode* Node : NodesHash[x][y])
-				{
-					if (EnumHasAnyFlags(Node->Flags, EStalkerAIMapNodeFlags::Selected))
-					{
-						Counter++;
-					}
-				}
-			}
-		
-		}
-	}
-	return Counter;
+	return NumSelected;
 }
 
 bool UStalkerAIMap::HasSelected()
 {
-	for (int32 x = 0; x <= NodesHashSize; x++)
-	{
-		for (int32 y = 0; y <= NodesHashSize; y++)
-		{
-			if (NodesHashSelected[x][y])
-			{
-				return true;
-			}
-		}
-	}
-	return false;
+	return NumSelected > 0;
 }
 
 void UStalkerAIMap::RefreshHashSelected()
 {
-	for (int32 x = 0; x <= NodesHashSize; x++)
+	NumSelected = 0;
+	for (EStalkerAIMapNodeFlags Flags : Nodes.Flags)
 	{
-		for (int32 y = 0; y <= NodesHashSize; y++)
+		if (EnumHasAnyFlags(Flags, EStalkerAIMapNodeFlags::Selected))
 		{
-			NodesHashSelected[x][y] = false;
-			for (FStalkerAIMapNode* Node : NodesHash[x][y])
-			{
-				NodesHashSelected[x][y] |= EnumHasAnyFlags(Node->Flags, EStalkerAIMapNodeFlags::Selected);
-			}
+			NumSelected++;
 		}
 	}
 }
 
-void UStalkerAIMap::SelectNode(FStalkerAIMapNode* Node)
+void UStalkerAIMap::SelectNode(int32 Node)
 {
-	bool*Select = GetEditorHashSelected(Node->Position);
-	check(Select);
-	*Select = true;
-	Node->Flags |= EStalkerAIMapNodeFlags::Selected;
-
+	if (!Nodes.IsSelected(Node))
+	{
+		Nodes.Flags[Node] |= EStalkerAIMapNodeFlags::Selected;
+		NumSelected++;
+	}
 }
 
-void UStalkerAIMap::UnSelectNode(FStalkerAIMapNode* InNode)
+void UStalkerAIMap::UnSelectNode(int32 Node)
 {
-	EnumRemoveFlags(InNode->Flags, EStalkerAIMapNodeFlags::Selected);
-	TArray<FStalkerAIMapNode*>* NodesHashList = GetEditorHashMap(InNode->Position);
-	check(NodesHashList);
-	bool* Select = GetEditorHashSelected(InNode->Position);
-	check(Select);
-	*Select = false;
-	for (FStalkerAIMapNode* Node : *NodesHashList)
+	if (Nodes.IsSelected(Node))
 	{
-		*Select |= EnumHasAnyFlags(Node->Flags, EStalkerAIMapNodeFlags::Selected);
+		EnumRemoveFlags(Nodes.Flags[Node], EStalkerAIMapNodeFlags::Selected);
+		NumSelected--;
 	}
 }
 
 void UStalkerAIMap::ClearSelected()
 {
-	for (int32 x = 0; x <= NodesHashSize; x++)
+	if (!NumSelected)
 	{
-		for (int32 y = 0; y <= NodesHashSize; y++)
-		{
-			if (NodesHashSelected[x][y])
-			{
-				for (FStalkerAIMapNode* Node : NodesHash[x][y])
-				{
-					EnumRemoveFlags(Node->Flags, EStalkerAIMapNodeFlags::Selected);
-				}
-			}
-		}
+		return;
+	}
+	for (EStalkerAIMapNodeFlags& Flags : Nodes.Flags)
+	{
+		EnumRemoveFlags(Flags, EStalkerAIMapNodeFlags::Selected);
 	}
+	NumSelected = 0;
 }
 
-void UStalkerAIMap::GetSelectedNodes(TArray<FStalkerAIMapNode*>& Result)
+void UStalkerAIMap::GetSelectedNodes(TArray<int32>& Result)
 {
-	for (int32 x = 0; x <= NodesHashSize; x++)
+	if (!NumSelected)
 	{
-		for (int32 y = 0; y <= NodesHashSize; y++)
+		return;
+	}
+	Result.Reserve(Result.Num() + NumSelected);
+	for (int32 Node = 0; Node < Nodes.Num(); Node++)
+	{
+		if (Nodes.IsSelected(Node))
 		{
-			if (NodesHashSelected[x][y])
-			{
-				for (FStalkerAIMapNode* Node : NodesHash[x][y])
-				{
-					if (EnumHasAnyFlags(Node->Flags, EStalkerAIMapNodeFlags::Selected))
-					{
-						Result.Add(Node);
-					}
-				}
-			}
+			Result.Add(Node);
 		}
 	}
 }
 
-bool UStalkerAIMap::GetFirstSelectedNode(FStalkerAIMapNode*& Result)
+bool UStalkerAIMap::GetFirstSelectedNode(int32& Result)
 {
-	for (int32 x = 0; x <= NodesHashSize; x++)
+	if (!NumSelected)
 	{
-		for (int32 y = 0; y <= NodesHashSize; y++)
+		return false;
+	}
+	for (int32 Node = 0; Node < Nodes.Num(); Node++)
+	{
+		if (Nodes.IsSelected(Node))
 		{
-			if (NodesHashSelected[x][y])
-			{
-				for (FStalkerAIMapNode* Node : NodesHash[x][y])
-				{
-					if (EnumHasAnyFlags(Node->Flags, EStalkerAIMapNodeFlags::Selected))
-					{
-						Result = Node;
-						return true;
-					}
-				}
-			}
+			Result = Node;
+			return true;
 		}
 	}
 	return false;
 }
 
-FStalkerAIMapNode* UStalkerAIMap::FindOrCreateNode(const FVector3f& InPosition, float ErrorToleranceForZ, bool NotFind, bool bAutoLink)
+int32 UStalkerAIMap::FindOrCreateNode(const FVector3f& InPosition, float ErrorToleranceForZ, bool NotFind)
 {
 	FVector3f Position = FVector3f(FMath::Floor(InPosition.X / NodeSize) * NodeSize, FMath::Floor(InPosition.Y / NodeSize) * NodeSize, InPosition.Z);
-	TArray<FStalkerAIMapNode*>* NodesHashList = GetEditorHashMap(InPosition);
-	if (NodesHashList)
+	const int32 Result = NodesIndex.FindNearest(InPosition, ErrorToleranceForZ, ErrorToleranceForZ);
+	if (Result != INDEX_NONE)
 	{
-		FStalkerAIMapNode* Result = nullptr;
-		for (FStalkerAIMapNode* Node : *NodesHashList)
+		if (NotFind)
 		{
-			if (FMath::IsNearlyEqual(Node->Position.X, Position.X, 1.f) &&
-				FMath::IsNearlyEqual(Node->Position.Y, Position.Y, 1.f) &&
-				FMath::IsNearlyEqual(Node->Position.Z, Position.Z, ErrorToleranceForZ))
-			{
-				if (Result)
-				{
-					if (FMath::Abs(InPosition.Z - Result->Position.Z) > FMath::Abs(InPosition.Z - Node->Position.Z))
-					{
-						Result = Node;
-					}
-				}
-				else
-				{
-					Result = Node;
-				}
-			}
-		}
-		if (Result)
-		{
-			if (NotFind)
-			{
-				return nullptr;
-			}
-			return Result;
+			return INDEX_NONE;
 		}
+		return Result;
 	}
 
 	NeedRebuild = true;
-	Nodes.Add(new FStalkerAIMapNode);
-	Nodes.Last()->Position = Position;
-	Nodes.Last()->Plane = FPlane4f(Position, FVector3f(0, 0, 1));
-	if (!NodesHashList)
-	{
-		HashFill();
-	}
-	else
-	{
-		NodesHashList->Add(Nodes.Last());
-	}
-	if (bAutoLink)
-	{
-		AutoLink(Nodes.Last());
-	}
-	return Nodes.Last();
+	const int32 Node = Nodes.Add(Position, FPlane4f(Position, FVector3f(0, 0, 1)));
+	NodesIndex.Add(Node);
+	AABB += Position + FVector3f(NodeSize * 0.5f, NodeSize * 0.5f, 2.f);
+	AABB += Position + FVector3f(-NodeSize * 0.5f, -NodeSize * 0.5f, -2.f);
+	return Node;
 }
 
-FStalkerAIMapNode* UStalkerAIMap::FindNode(const FVector3f& InPosition, float ErrorToleranceForZ)
+int32 UStalkerAIMap::FindNode(const FVector3f& InPosition, float ErrorToleranceForZ)
 {
-	TArray<FStalkerAIMapNode*>* NodesHashList = GetEditorHashMap(InPosition);
-	if (NodesHashList)
-	{
-		FVector3f Position = FVector3f(FMath::Floor(InPosition.X / NodeSize) * NodeSize, FMath::Floor(InPosition.Y / NodeSize) * NodeSize, InPosition.Z);
-		FStalkerAIMapNode* Result = nullptr;
-		for (FStalkerAIMapNode* Node : *NodesHashList)
-		{
-			if (FMath::IsNearlyEqual(Node->Position.X, Position.X, 1.f) &&
-				FMath::IsNearlyEqual(Node->Position.Y, Position.Y, 1.f) &&
-				FMath::IsNearlyEqual(Node->Position.Z, Position.Z, ErrorToleranceForZ))
-			{
-				if (Result)
-				{
-					if (FMath::Abs(InPosition.Z - Result->Position.Z) > FMath::Abs(InPosition.Z - Node->Position.Z))
-					{
-						Result = Node;
-					}
-				}
-				else
-				{
-					Result = Node;
-				}
-			}
-		}
-		return Result;
-	}
-	return nullptr;
+	return NodesIndex.FindNearest(InPosition, ErrorToleranceForZ, ErrorToleranceForZ);
 }
 
 
-FStalkerAIMapNode* UStalkerAIMap::FindNeighbour(FStalkerAIMapNode* Node, int32 ID)
+int32 UStalkerAIMap::FindNeighbour(int32 Node, int32 ID, float MaxDown, float MaxUp)
 {
-	FVector3f Position = Node->Position;
-	if (ID == 0)
+	if (ID < 0 || ID > 3)
 	{
-		FStalkerAIMapNode* LeftNode = FindNode(Position + FVector3f(NodeSize, 0, 0));
-		return LeftNode == Node ? nullptr : LeftNode;
-
-	}
-	else if (ID == 1)
-	{
-		FStalkerAIMapNode* ForwardNode = FindNode(Position + FVector3f(0, NodeSize, 0));
-		return ForwardNode == Node ? nullptr : ForwardNode;
-	}
-	else if (ID == 2)
-	{
-		FStalkerAIMapNode* RightNode = FindNode(Position + FVector3f(-NodeSize, 0, 0));
-		return RightNode == Node ? nullptr : RightNode;
-	}
-	else if (ID == 3)
-	{
-
-		FStalkerAIMapNode* BackwardNode = FindNode(Position + FVector3f(0, -NodeSize, 0));
-		return BackwardNode == Node ? nullptr : BackwardNode;
+		return INDEX_NONE;
 	}
-	return nullptr;
-}
-
-void UStalkerAIMap::CalculateIndex()
-{
-	int32 Index = 0;
-	for (FStalkerAIMapNode* Node : Nodes)
-	{
-		Node->Index = Index++;
-	}
-
+	int32 Neighbours[4];
+	NodesIndex.FindNeighbours(Nodes.Positions[Node], MaxDown, MaxUp, Neighbours);
+	return Neighbours[ID] == Node ? INDEX_NONE : Neighbours[ID];
 }
 
 
@@ -592,10 +362,31 @@ void UStalkerAIMap::PostEditUndo()
 void UStalkerAIMap::ClearNodes()
 {
 	NeedRebuild = true;
-	for (FStalkerAIMapNode* Node : Nodes)
+	Nodes.Reset();
+}
+
+void UStalkerAIMap::ReplaceLinks(int32 From, int32 To)
+{
+	// Links only ever join nodes of adjacent cells, so referrers are found through the index
+	TArray<int32, TInlineAllocator<16>> Referrers;
+	NodesIndex.GetAdjacentNodes(Nodes.Positions[From], Referrers);
+	for (int32 Link = 0; Link < 4; Link++)
 	{
-		delete Node;
+		if (Nodes.Links[From][Link] != INDEX_NONE)
+		{
+			Referrers.AddUnique(Nodes.Links[From][Link]);
+		}
+	}
+	for (int32 Referrer : Referrers)
+	{
+		FStalkerAIMapNodeLinks& Links = Nodes.Links[Referrer];
+		for (int32 Link = 0; Link < 4; Link++)
+		{
+			if (Links[Link] == From)
+			{
+				Links[Link] = To;
+			}
+		}
 	}
-	Nodes.Empty();
 }
-#endif
+#endif
\ No newline at end of file
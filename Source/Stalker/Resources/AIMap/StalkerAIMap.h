@@ -1,5 +1,6 @@
 #pragma once
 #include "StalkerAIMapNode.h"
+#include "StalkerAIMapSpatialIndex.h"
 #include "StalkerAIMap.generated.h"
 
 UCLASS()
@@ -14,30 +15,30 @@ public:
 	const						CVertex* get_nodes	() const override;
 	void						RefreshAIMapMetadata();
 #if WITH_EDITORONLY_DATA
-	void						AutoLink			(FStalkerAIMapNode* Node);
+	// Links a node to the nodes around it whose height differs by at most the given step heights
+	void						AutoLink			(int32 Node, float MaxDown, float MaxUp);
 	void						BeginDestroy		() override;
 	void						InvalidAIMap		();
 	void						ClearAIMap			();
 	void						CalculateAABB		(const FBox3f& NewAABB = FBox3f(ForceInit));
 	void						HashFill			(const FBox3f& NewAABB = FBox3f(ForceInit));
 	void						HashClear			();
+	void						RemoveNode			(int32 Node);
 	void						RemoveSelect		();
-	TArray<FStalkerAIMapNode*>* GetEditorHashMap	(const FVector3f&Position);
+	void						SetNodeHeight		(int32 Node, float Z);
 
-	bool*						GetEditorHashSelected(const FVector3f&Position);
 	int32						GetCountSelected	();
 	bool						HasSelected			();
 	void						RefreshHashSelected ();
-	void						SelectNode			(FStalkerAIMapNode*Node);
-	void						UnSelectNode		(FStalkerAIMapNode*Node);
+	void						SelectNode			(int32 Node);
+	void						UnSelectNode		(int32 Node);
 	void						ClearSelected		();
-	void						GetSelectedNodes	(TArray<FStalkerAIMapNode*>&Result);
-	bool						GetFirstSelectedNode(FStalkerAIMapNode*&Result);
+	void						GetSelectedNodes	(TArray<int32>&Result);
+	bool						GetFirstSelectedNode(int32&Result);
 
-	FStalkerAIMapNode*			FindOrCreateNode	(const FVector3f&Position, float ErrorToleranceForZ = 50.f,bool NotFind = false,bool AutLink=true);
-	FStalkerAIMapNode*			FindNode			(const FVector3f&Position,float ErrorToleranceForZ = 50.f);
-	FStalkerAIMapNode*			FindNeighbour		(FStalkerAIMapNode* Node, int32 ID);
-	void						CalculateIndex		();
+	int32						FindOrCreateNode	(const FVector3f&Position, float ErrorToleranceForZ = 50.f,bool NotFind = false);
+	int32						FindNode			(const FVector3f&Position,float ErrorToleranceForZ = 50.f);
+	int32						FindNeighbour		(int32 Node, int32 ID, float MaxDown, float MaxUp);
 #endif
 	
 	UPROPERTY()
@@ -50,11 +51,12 @@ public:
 #if WITH_EDITORONLY_DATA
 	UPROPERTY()
 	float NodeSize = 70.f;
+	UPROPERTY(EditAnywhere, Category = "AIMap")
+	bool CompressNodePositions = true;
 
-	TArray<FStalkerAIMapNode*>	Nodes;
-	static const int32			NodesHashSize = 256;
-	TArray<FStalkerAIMapNode*>	NodesHash[NodesHashSize + 1][NodesHashSize + 1];
-	bool						NodesHashSelected[NodesHashSize + 1][NodesHashSize + 1];
+	FStalkerAIMapNodes			Nodes;
+	FStalkerAIMapSpatialIndex	NodesIndex;
+	int32						NumSelected = 0;
 #endif
 
 
@@ -68,6 +70,7 @@ public:
 private:
 #if WITH_EDITORONLY_DATA
 	void						ClearNodes			();
+	void						ReplaceLinks		(int32 From, int32 To);
 #endif
-	const int32					Version = 1;
+	const int32					Version = 2;
 };
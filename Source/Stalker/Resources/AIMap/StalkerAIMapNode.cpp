@@ -1,55 +1,208 @@
 #include "StalkerAIMapNode.h"
-#include "StalkerAIMap.h"
+#include "Misc/Compression.h"
 #if WITH_EDITORONLY_DATA
-FStalkerAIMapNode::FStalkerAIMapNode()
+int32 FStalkerAIMapNodes::Add(const FVector3f& Position, const FPlane4f& Plane)
 {
-	Flags = EStalkerAIMapNodeFlags::None;
-	Index = 0xFFFFFFFF;
-	NodeLeft = nullptr;
-	NodeForward = nullptr;
-	NodeRight = nullptr;
-	NodeBackward = nullptr;
+	Planes.Add(Plane);
+	Flags.Add(EStalkerAIMapNodeFlags::None);
+	Links.AddDefaulted();
+	const int32 Index = Positions.Add(Position);
+	AllocateSlot(Index);
+	return Index;
+}
 
+void FStalkerAIMapNodes::SetNum(int32 NewNum)
+{
+	for (int32 Index = Num() - 1; Index >= NewNum; Index--)
+	{
+		FreeSlot(IndexSlots[Index]);
+	}
+	IndexSlots.SetNum(FMath::Min(IndexSlots.Num(), NewNum));
+	for (int32 Index = IndexSlots.Num(); Index < NewNum; Index++)
+	{
+		AllocateSlot(Index);
+	}
+	Positions.SetNumZeroed(NewNum);
+	Planes.SetNumZeroed(NewNum);
+	Flags.SetNumZeroed(NewNum);
+	const int32 OldNum = Links.Num();
+	Links.SetNum(NewNum);
+	for (int32 i = OldNum; i < NewNum; i++)
+	{
+		Links[i] = FStalkerAIMapNodeLinks();
+	}
 }
 
-void FStalkerAIMapNode::Serialize(FArchive& Ar, UStalkerAIMap* Parent)
+void FStalkerAIMapNodes::Reset(int32 NewCapacity)
+{
+	for (int32 Slot : IndexSlots)
+	{
+		FreeSlot(Slot);
+	}
+	IndexSlots.Empty(NewCapacity);
+	Positions.Empty(NewCapacity);
+	Planes.Empty(NewCapacity);
+	Flags.Empty(NewCapacity);
+	Links.Empty(NewCapacity);
+}
+
+int32 FStalkerAIMapNodes::RemoveAtSwap(int32 Index)
+{
+	const int32 Last = Num() - 1;
+	Positions.RemoveAtSwap(Index, 1, false);
+	Planes.RemoveAtSwap(Index, 1, false);
+	Flags.RemoveAtSwap(Index, 1, false);
+	Links.RemoveAtSwap(Index, 1, false);
+	FreeSlot(IndexSlots[Index]);
+	IndexSlots.RemoveAtSwap(Index, 1, false);
+	if (Index == Last)
+	{
+		return INDEX_NONE;
+	}
+	SlotIndices[IndexSlots[Index]] = Index;
+	return Last;
+}
+
+int32 FStalkerAIMapNodes::Resolve(const FStalkerAIMapNodeHandle& Handle) const
+{
+	if (!SlotIndices.IsValidIndex(Handle.Slot) || SlotGenerations[Handle.Slot] != Handle.Generation)
+	{
+		return INDEX_NONE;
+	}
+	return SlotIndices[Handle.Slot];
+}
+
+void FStalkerAIMapNodes::AllocateSlot(int32 Index)
+{
+	int32 Slot;
+	if (FreeSlots.Num())
+	{
+		Slot = FreeSlots.Pop(false);
+	}
+	else
+	{
+		Slot = SlotIndices.Add(INDEX_NONE);
+		SlotGenerations.Add(0);
+	}
+	SlotIndices[Slot] = Index;
+	check(IndexSlots.Num() == Index);
+	IndexSlots.Add(Slot);
+}
+
+void FStalkerAIMapNodes::FreeSlot(int32 Slot)
+{
+	SlotIndices[Slot] = INDEX_NONE;
+	SlotGenerations[Slot]++;
+	FreeSlots.Add(Slot);
+}
+
+void FStalkerAIMapNodes::SerializeLegacy(FArchive& Ar)
 {
 	if (!Ar.IsLoading()&& !Ar.IsSaving())
 		return;
 
-	uint32 UnkownIndex = 0xFFFFFFFF;
-	int32 LoadVersion = Version;
-	Ar<< LoadVersion;
-	check (LoadVersion == 0);
-	Ar<< Position;
-	Ar<< Plane;
-	for (int32 i = 0; i < 4; i++)
+	const uint32 UnkownIndex = 0xFFFFFFFF;
+	for (int32 Index = 0; Index < Num(); Index++)
 	{
-
-		if (Ar.IsLoading())
+		int32 LoadVersion = 0;
+		Ar << LoadVersion;
+		check(LoadVersion == 0);
+		Ar << Positions[Index];
+		Ar << Planes[Index];
+		for (int32 i = 0; i < 4; i++)
 		{
-			uint32 NodeIndex = 0xFFFFFFFF;
-			Ar<< NodeIndex;
-			Nodes[i] = NodeIndex == UnkownIndex?nullptr : Parent->Nodes[NodeIndex];
-
+			uint32 NodeIndex = Links[Index][i] == INDEX_NONE ? UnkownIndex : static_cast<uint32>(Links[Index][i]);
+			Ar << NodeIndex;
+			if (Ar.IsLoading())
+			{
+				Links[Index][i] = NodeIndex == UnkownIndex ? INDEX_NONE : static_cast<int32>(NodeIndex);
+			}
 		}
-		else if (Ar.IsSaving())
+		if (Ar.IsLoading())
 		{
-			if (Nodes[i])
-			{
-				Ar << Nodes[i]->Index;
+			Flags[Index] = EStalkerAIMapNodeFlags::None;
+		}
+	}
+}
 
-			}
-			else
+void FStalkerAIMapNodes::SerializeBulk(FArchive& Ar, bool bCompressPositions)
+{
+	static_assert(sizeof(FStalkerAIMapNodeLinks) == sizeof(int32) * 4);
+	if (!Ar.IsLoading() && !Ar.IsSaving())
+		return;
+
+	SerializePositions(Ar, bCompressPositions);
+	Ar.Serialize(Planes.GetData(), Planes.Num() * sizeof(FPlane4f));
+	Ar.Serialize(Links.GetData(), Links.Num() * sizeof(FStalkerAIMapNodeLinks));
+	if (Ar.IsLoading())
+	{
+		FMemory::Memzero(Flags.GetData(), Flags.Num() * sizeof(EStalkerAIMapNodeFlags));
+	}
+}
+
+void FStalkerAIMapNodes::SerializePositions(FArchive& Ar, bool bCompress)
+{
+	static_assert(sizeof(FVector3f) == sizeof(uint32) * 3);
+	const int32 Count = Num();
+	const int32 StreamSize = Count * sizeof(FVector3f);
+
+	// Component planes of bit deltas between neighbouring nodes, generated nodes are spatially coherent so most deltas are small
+	TArray<uint32> Stream;
+	int32 CompressedSize = 0;
+	TArray<uint8> Compressed;
+	if (Ar.IsSaving() && bCompress && Count)
+	{
+		Stream.SetNumUninitialized(Count * 3);
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			uint32 Previous = 0;
+			for (int32 Index = 0; Index < Count; Index++)
 			{
-				Ar << UnkownIndex;
+				uint32 Bits;
+				FMemory::Memcpy(&Bits, &Positions[Index][Axis], sizeof(uint32));
+				Stream[Axis * Count + Index] = Bits - Previous;
+				Previous = Bits;
 			}
 		}
-		
+		CompressedSize = FCompression::CompressMemoryBound(NAME_LZ4, StreamSize);
+		Compressed.SetNumUninitialized(CompressedSize);
+		if (!FCompression::CompressMemory(NAME_LZ4, Compressed.GetData(), CompressedSize, Stream.GetData(), StreamSize) || CompressedSize >= StreamSize)
+		{
+			CompressedSize = 0;
+		}
 	}
-	if (Ar.IsLoading())
+
+	Ar << CompressedSize;
+	if (!CompressedSize)
+	{
+		Ar.Serialize(Positions.GetData(), StreamSize);
+		return;
+	}
+
+	if (Ar.IsSaving())
 	{
-		Flags = EStalkerAIMapNodeFlags::None;
+		Ar.Serialize(Compressed.GetData(), CompressedSize);
+		return;
+	}
+
+	Compressed.SetNumUninitialized(CompressedSize);
+	Ar.Serialize(Compressed.GetData(), CompressedSize);
+	Stream.SetNumUninitialized(Count * 3);
+	if (!FCompression::UncompressMemory(NAME_LZ4, Stream.GetData(), StreamSize, Compressed.GetData(), CompressedSize))
+	{
+		UE_LOG(LogStalker, Error, TEXT("Failed to decompress AI map node positions"));
+		Ar.SetError();
+		FMemory::Memzero(Positions.GetData(), StreamSize);
+		return;
+	}
+	for (int32 Axis = 0; Axis < 3; Axis++)
+	{
+		uint32 Bits = 0;
+		for (int32 Index = 0; Index < Count; Index++)
+		{
+			Bits += Stream[Axis * Count + Index];
+			FMemory::Memcpy(&Positions[Index][Axis], &Bits, sizeof(uint32));
+		}
 	}
 }
-#endif
\ No newline at end of file
+#endif
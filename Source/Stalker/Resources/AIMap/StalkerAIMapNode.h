@@ -1,32 +1,74 @@
 #pragma once
 #if WITH_EDITORONLY_DATA
-enum class EStalkerAIMapNodeFlags
+enum class EStalkerAIMapNodeFlags : uint8
 {
 	None = 0,
 	Selected,
 };
 ENUM_CLASS_FLAGS(EStalkerAIMapNodeFlags);
-struct STALKER_API FStalkerAIMapNode 
+
+struct STALKER_API FStalkerAIMapNode
 {
 	FPlane4f	Plane;
 	FVector3f	Position;
-	EStalkerAIMapNodeFlags		Flags;
-	
-	union 
-	{
-		struct 
-		{
-			FStalkerAIMapNode* NodeLeft;		// Left
-			FStalkerAIMapNode* NodeForward;		// Forward
-			FStalkerAIMapNode* NodeRight;		// Right
-			FStalkerAIMapNode* NodeBackward;	// Backward
-		};
-		FStalkerAIMapNode* Nodes[4];
-	};
-	FStalkerAIMapNode();
-	void Serialize(FArchive& Ar, class UStalkerAIMap* Parent);
-
-	uint32		Index;
-	int32		Version = 0;
+};
+
+// Neighbour node indices: Left (+X), Forward (+Y), Right (-X), Backward (-Y)
+struct STALKER_API FStalkerAIMapNodeLinks
+{
+	FStalkerAIMapNodeLinks() { Nodes[0] = Nodes[1] = Nodes[2] = Nodes[3] = INDEX_NONE; }
+	inline int32&	operator[]	(int32 Link)		{ return Nodes[Link]; }
+	inline int32	operator[]	(int32 Link) const	{ return Nodes[Link]; }
+
+	int32 Nodes[4];
+};
+
+// Survives the node moving to another index, resolves to INDEX_NONE once the node is removed
+struct STALKER_API FStalkerAIMapNodeHandle
+{
+	inline bool		operator==	(const FStalkerAIMapNodeHandle& Right) const { return Slot == Right.Slot && Generation == Right.Generation; }
+	inline bool		operator!=	(const FStalkerAIMapNodeHandle& Right) const { return !(*this == Right); }
+
+	int32	Slot = INDEX_NONE;
+	uint32	Generation = 0;
+};
+
+// Node storage as parallel arrays, a node is addressed by its index in them
+class STALKER_API FStalkerAIMapNodes
+{
+public:
+	int32							Add				(const FVector3f& Position, const FPlane4f& Plane);
+	void							SetNum			(int32 NewNum);
+	void							Reset			(int32 NewCapacity = 0);
+	// Moves the last node into Index and returns its previous index, references to it must be patched by the caller
+	int32							RemoveAtSwap	(int32 Index);
+	// Per node records of asset versions 0 and 1
+	void							SerializeLegacy	(FArchive& Ar);
+	// Every array as one block, positions optionally delta encoded and LZ4 compressed
+	void							SerializeBulk	(FArchive& Ar, bool bCompressPositions);
+
+	inline int32					Num				() const { return Positions.Num(); }
+	inline bool						IsValidIndex	(int32 Index) const { return Positions.IsValidIndex(Index); }
+	inline bool						IsSelected		(int32 Index) const { return EnumHasAnyFlags(Flags[Index], EStalkerAIMapNodeFlags::Selected); }
+	inline FStalkerAIMapNode		Get				(int32 Index) const { return { Planes[Index], Positions[Index] }; }
+	inline FStalkerAIMapNodeHandle	GetHandle		(int32 Index) const { return { IndexSlots[Index], SlotGenerations[IndexSlots[Index]] }; }
+	// Current index of the node, INDEX_NONE if it was removed or the nodes were reset since
+	int32							Resolve			(const FStalkerAIMapNodeHandle& Handle) const;
+
+	TArray<FVector3f>				Positions;
+	TArray<FPlane4f>				Planes;
+	TArray<EStalkerAIMapNodeFlags>	Flags;
+	TArray<FStalkerAIMapNodeLinks>	Links;
+
+private:
+	void							SerializePositions(FArchive& Ar, bool bCompress);
+	void							AllocateSlot	(int32 Index);
+	void							FreeSlot		(int32 Slot);
+
+	// Slot of every node, and per slot the node index (INDEX_NONE while free) and a generation bumped on every free
+	TArray<int32>					IndexSlots;
+	TArray<int32>					SlotIndices;
+	TArray<uint32>					SlotGenerations;
+	TArray<int32>					FreeSlots;
 };
 #endif
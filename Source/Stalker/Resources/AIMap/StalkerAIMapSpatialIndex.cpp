@@ -0,0 +1,150 @@
+#include "StalkerAIMapSpatialIndex.h"
+#include "StalkerAIMapNode.h"
+#include "Algo/BinarySearch.h"
+#if WITH_EDITORONLY_DATA
+void FStalkerAIMapSpatialIndex::Build(const FStalkerAIMapNodes& InNodes, float InCellSize)
+{
+	Reset(InNodes, InCellSize);
+	Cells.Reserve(InNodes.Num());
+	for (int32 Node = 0; Node < InNodes.Num(); Node++)
+	{
+		Cells.FindOrAdd(GetKey(InNodes.Positions[Node])).Add(Node);
+	}
+	const TArray<FVector3f>& Positions = InNodes.Positions;
+	for (auto& [Key, Cell] : Cells)
+	{
+		Cell.StableSort([&Positions](int32 Left, int32 Right) { return Positions[Left].Z < Positions[Right].Z; });
+	}
+	NumNodes = InNodes.Num();
+}
+
+void FStalkerAIMapSpatialIndex::Reset(const FStalkerAIMapNodes& InNodes, float InCellSize)
+{
+	check(InCellSize > 0);
+	Nodes = &InNodes;
+	CellSize = InCellSize;
+	Cells.Reset();
+	NumNodes = 0;
+}
+
+void FStalkerAIMapSpatialIndex::Add(int32 Node)
+{
+	const FVector3f& Position = Nodes->Positions[Node];
+	FCell& Cell = Cells.FindOrAdd(GetKey(Position));
+	int32 Index = LowerBound(Cell, Position.Z);
+	while (Index < Cell.Num() && Nodes->Positions[Cell[Index]].Z == Position.Z)
+	{
+		Index++;
+	}
+	Cell.Insert(Node, Index);
+	NumNodes++;
+}
+
+void FStalkerAIMapSpatialIndex::Remove(int32 Node)
+{
+	const FVector3f& Position = Nodes->Positions[Node];
+	const FIntPoint Key = GetKey(Position);
+	FCell* Cell = Cells.Find(Key);
+	if (!Cell)
+	{
+		return;
+	}
+	const int32 Index = FindInCell(*Cell, Node, Position.Z);
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+	Cell->RemoveAt(Index, 1, false);
+	if (Cell->Num() == 0)
+	{
+		Cells.Remove(Key);
+	}
+	NumNodes--;
+}
+
+void FStalkerAIMapSpatialIndex::Move(int32 From, int32 To)
+{
+	const FVector3f& Position = Nodes->Positions[To];
+	if (FCell* Cell = Cells.Find(GetKey(Position)))
+	{
+		const int32 Index = FindInCell(*Cell, From, Position.Z);
+		if (Index != INDEX_NONE)
+		{
+			(*Cell)[Index] = To;
+		}
+	}
+}
+
+const FStalkerAIMapSpatialIndex::FCell* FStalkerAIMapSpatialIndex::FindCell(const FVector3f& Position) const
+{
+	return Cells.Find(GetKey(Position));
+}
+
+int32 FStalkerAIMapSpatialIndex::FindNearest(const FVector3f& Position, float MaxDown, float MaxUp) const
+{
+	const FCell* Cell = Cells.Find(GetKey(Position));
+	return Cell ? FindNearestInCell(*Cell, Position.Z, MaxDown, MaxUp) : INDEX_NONE;
+}
+
+void FStalkerAIMapSpatialIndex::FindNeighbours(const FVector3f& Position, float MaxDown, float MaxUp, int32 (&OutNodes)[4]) const
+{
+	const FIntPoint Key = GetKey(Position);
+	static const FIntPoint Offsets[4] = { FIntPoint(1, 0), FIntPoint(0, 1), FIntPoint(-1, 0), FIntPoint(0, -1) };
+	for (int32 i = 0; i < 4; i++)
+	{
+		const FCell* Cell = Cells.Find(Key + Offsets[i]);
+		OutNodes[i] = Cell ? FindNearestInCell(*Cell, Position.Z, MaxDown, MaxUp) : INDEX_NONE;
+	}
+}
+
+void FStalkerAIMapSpatialIndex::GetAdjacentNodes(const FVector3f& Position, TArray<int32, TInlineAllocator<16>>& OutNodes) const
+{
+	const FIntPoint Key = GetKey(Position);
+	static const FIntPoint Offsets[4] = { FIntPoint(1, 0), FIntPoint(0, 1), FIntPoint(-1, 0), FIntPoint(0, -1) };
+	for (int32 i = 0; i < 4; i++)
+	{
+		if (const FCell* Cell = Cells.Find(Key + Offsets[i]))
+		{
+			OutNodes.Append(*Cell);
+		}
+	}
+}
+
+FIntPoint FStalkerAIMapSpatialIndex::GetKey(const FVector3f& Position) const
+{
+	// Nodes lie on multiples of the cell size, the bias keeps one that came out a rounding error short in its own cell
+	constexpr float CellBias = 1e-3f;
+	return FIntPoint(FMath::FloorToInt32(Position.X / CellSize + CellBias), FMath::FloorToInt32(Position.Y / CellSize + CellBias));
+}
+
+int32 FStalkerAIMapSpatialIndex::LowerBound(const FCell& Cell, float Z) const
+{
+	const TArray<FVector3f>& Positions = Nodes->Positions;
+	return Algo::LowerBoundBy(Cell, Z, [&Positions](int32 Node) { return Positions[Node].Z; });
+}
+
+int32 FStalkerAIMapSpatialIndex::FindInCell(const FCell& Cell, int32 Node, float Z) const
+{
+	for (int32 Index = LowerBound(Cell, Z); Index < Cell.Num(); Index++)
+	{
+		if (Cell[Index] == Node)
+		{
+			return Index;
+		}
+	}
+	return Cell.Find(Node);
+}
+
+int32 FStalkerAIMapSpatialIndex::FindNearestInCell(const FCell& Cell, float Z, float MaxDown, float MaxUp) const
+{
+	const TArray<FVector3f>& Positions = Nodes->Positions;
+	const int32 Index = LowerBound(Cell, Z);
+	const int32 Below = Index > 0 && Z - Positions[Cell[Index - 1]].Z <= MaxDown ? Cell[Index - 1] : INDEX_NONE;
+	const int32 Above = Index < Cell.Num() && Positions[Cell[Index]].Z - Z <= MaxUp ? Cell[Index] : INDEX_NONE;
+	if (Below != INDEX_NONE && Above != INDEX_NONE)
+	{
+		return Positions[Above].Z - Z < Z - Positions[Below].Z ? Above : Below;
+	}
+	return Below != INDEX_NONE ? Below : Above;
+}
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+#if WITH_EDITORONLY_DATA
+// Node indices keyed by quantized XY cell, every cell keeps its nodes sorted by height
+class STALKER_API FStalkerAIMapSpatialIndex
+{
+public:
+	typedef TArray<int32, TInlineAllocator<2>> FCell;
+
+	void						Build				(const class FStalkerAIMapNodes& InNodes, float InCellSize);
+	void						Reset				(const class FStalkerAIMapNodes& InNodes, float InCellSize);
+	void						Add					(int32 Node);
+	void						Remove				(int32 Node);
+	// Node From was moved into slot To, its position is read from To
+	void						Move				(int32 From, int32 To);
+
+	const FCell*				FindCell			(const FVector3f& Position) const;
+	int32						FindNearest			(const FVector3f& Position, float MaxDown, float MaxUp) const;
+	// Left, Forward, Right, Backward neighbours of a node lying at Position
+	void						FindNeighbours		(const FVector3f& Position, float MaxDown, float MaxUp, int32 (&OutNodes)[4]) const;
+	// All nodes of the four cells around a node lying at Position
+	void						GetAdjacentNodes	(const FVector3f& Position, TArray<int32, TInlineAllocator<16>>& OutNodes) const;
+	inline int32				Num					() const { return NumNodes; }
+
+private:
+	// Cell whose lower corner is at or below Position, a node's own position always keys its own cell
+	FIntPoint					GetKey				(const FVector3f& Position) const;
+	int32						LowerBound			(const FCell& Cell, float Z) const;
+	int32						FindInCell			(const FCell& Cell, int32 Node, float Z) const;
+	// The closest node below and the closest above are the only candidates, anything further out on either side is further from Z
+	int32						FindNearestInCell	(const FCell& Cell, float Z, float MaxDown, float MaxUp) const;
+
+	const class FStalkerAIMapNodes* Nodes = nullptr;
+	TMap<FIntPoint, FCell>		Cells;
+	float						CellSize = 70.f;
+	int32						NumNodes = 0;
+};
+#endif
@@ -3,6 +3,8 @@
 StalkerKinematicsBoneInstance::StalkerKinematicsBoneInstance()
 {
 	bUpdated = false;
+	CallbackFrame = u32(-1);
+	CallbackEvaluated = false;
 }
 
 const Fmatrix& StalkerKinematicsBoneInstance::GetTransform() const
@@ -8,4 +8,8 @@ public:
 	void SetTransform(const Fmatrix& val) override;
 	Fmatrix Transform;
 	bool bUpdated;
+	// Device frame the callback last ran in, the callback result is reused until the next frame or invalidation.
+	// Only the game thread writes it, the pose evaluation sets CallbackEvaluated and the frame is stamped after it completes
+	u32 CallbackFrame;
+	bool CallbackEvaluated;
 };
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "StalkerKinematicsBonePickTree.h"
+
+namespace
+{
+	constexpr int32 PickTreeLeafTriangles = 4;
+	constexpr int32 PickTreeMaxDepth = 64;
+
+	inline bool PickBox(const Fbox& Bounds, const Fvector& Start, const Fvector& InvDir, float Range)
+	{
+		float Near = 0;
+		float Far = Range;
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			float T0 = (Bounds.min[Axis] - Start[Axis]) * InvDir[Axis];
+			float T1 = (Bounds.max[Axis] - Start[Axis]) * InvDir[Axis];
+			if (T0 > T1)
+			{
+				Swap(T0, T1);
+			}
+			Near = FMath::Max(Near, T0);
+			Far = FMath::Min(Far, T1);
+			if (Near > Far)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+void FStalkerKinematicsBonePickTree::Build(TArray<Fvector>& InVertices)
+{
+	Nodes.Reset();
+	Vertices.Reset();
+	const int32 NumTriangles = InVertices.Num() / 3;
+	if (NumTriangles == 0)
+	{
+		return;
+	}
+
+	TArray<u32> Triangles;
+	TArray<Fvector> Centers;
+	Triangles.SetNumUninitialized(NumTriangles);
+	Centers.SetNumUninitialized(NumTriangles);
+	for (int32 Triangle = 0; Triangle < NumTriangles; Triangle++)
+	{
+		Triangles[Triangle] = Triangle;
+		Centers[Triangle].add(InVertices[Triangle * 3], InVertices[Triangle * 3 + 1]).add(InVertices[Triangle * 3 + 2]).div(3.f);
+	}
+
+	Nodes.Reserve(2 * (NumTriangles / PickTreeLeafTriangles + 1));
+	BuildNode(Triangles, Centers, InVertices, 0, NumTriangles);
+
+	Vertices.SetNumUninitialized(NumTriangles * 3);
+	for (int32 Triangle = 0; Triangle < NumTriangles; Triangle++)
+	{
+		Vertices[Triangle * 3] = InVertices[Triangles[Triangle] * 3];
+		Vertices[Triangle * 3 + 1] = InVertices[Triangles[Triangle] * 3 + 1];
+		Vertices[Triangle * 3 + 2] = InVertices[Triangles[Triangle] * 3 + 2];
+	}
+	InVertices.Empty();
+}
+
+int32 FStalkerKinematicsBonePickTree::BuildNode(TArray<u32>& Triangles, const TArray<Fvector>& Centers, const TArray<Fvector>& InVertices, int32 First, int32 Count)
+{
+	const int32 NodeIndex = Nodes.AddDefaulted();
+	Fbox Bounds;
+	Fbox CentersBounds;
+	Bounds.invalidate();
+	CentersBounds.invalidate();
+	for (int32 i = First; i < First + Count; i++)
+	{
+		Bounds.modify(InVertices[Triangles[i] * 3]);
+		Bounds.modify(InVertices[Triangles[i] * 3 + 1]);
+		Bounds.modify(InVertices[Triangles[i] * 3 + 2]);
+		CentersBounds.modify(Centers[Triangles[i]]);
+	}
+	Nodes[NodeIndex].Bounds = Bounds;
+
+	if (Count <= PickTreeLeafTriangles)
+	{
+		Nodes[NodeIndex].First = First;
+		Nodes[NodeIndex].Count = Count;
+		return NodeIndex;
+	}
+
+	Fvector Size;
+	CentersBounds.getsize(Size);
+	const int32 Axis = Size.x > Size.y ? (Size.x > Size.z ? 0 : 2) : (Size.y > Size.z ? 1 : 2);
+	const int32 Middle = First + Count / 2;
+	std::nth_element(Triangles.GetData() + First, Triangles.GetData() + Middle, Triangles.GetData() + First + Count, [&Centers, Axis](u32 Left, u32 Right)
+	{
+		return Centers[Left][Axis] < Centers[Right][Axis];
+	});
+
+	BuildNode(Triangles, Centers, InVertices, First, Middle - First);
+	const int32 SecondChild = BuildNode(Triangles, Centers, InVertices, Middle, First + Count - Middle);
+	Nodes[NodeIndex].First = SecondChild;
+	Nodes[NodeIndex].Count = 0;
+	return NodeIndex;
+}
+
+bool FStalkerKinematicsBonePickTree::Pick(const Fvector& Start, const Fvector& Dir, float& InOutRange, u32& OutTriangle) const
+{
+	if (IsEmpty())
+	{
+		return false;
+	}
+
+	Fvector InvDir;
+	for (int32 Axis = 0; Axis < 3; Axis++)
+	{
+		InvDir[Axis] = FMath::IsNearlyZero(Dir[Axis]) ? flt_max : 1.f / Dir[Axis];
+	}
+
+	bool bResult = false;
+	int32 Stack[PickTreeMaxDepth];
+	int32 StackSize = 0;
+	Stack[StackSize++] = 0;
+	while (StackSize)
+	{
+		const int32 NodeIndex = Stack[--StackSize];
+		const FNode& Node = Nodes[NodeIndex];
+		if (!PickBox(Node.Bounds, Start, InvDir, InOutRange))
+		{
+			continue;
+		}
+		if (Node.Count == 0)
+		{
+			check(StackSize + 2 <= PickTreeMaxDepth);
+			Stack[StackSize++] = Node.First;
+			Stack[StackSize++] = NodeIndex + 1;
+			continue;
+		}
+		for (u32 Triangle = Node.First; Triangle < Node.First + Node.Count; Triangle++)
+		{
+			Fvector* TriangleVertices = const_cast<Fvector*>(GetTriangle(Triangle));
+			float U, V, Range;
+			if (CDB::TestRayTri(Start, Dir, TriangleVertices, U, V, Range, false) && Range > 0 && Range < InOutRange)
+			{
+				InOutRange = Range;
+				OutTriangle = Triangle;
+				bResult = true;
+			}
+		}
+	}
+	return bResult;
+}
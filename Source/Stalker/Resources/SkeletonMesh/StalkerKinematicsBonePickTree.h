@@ -0,0 +1,27 @@
+#pragma once
+// Triangles skinned to one bone, stored in the bind space of that bone under a bounding volume hierarchy
+class STALKER_API FStalkerKinematicsBonePickTree
+{
+public:
+	// Three vertices per triangle, the array is consumed
+	void											Build					(TArray<Fvector>& InVertices);
+	// InOutRange is the maximum distance on input and the hit distance on success
+	bool											Pick					(const Fvector& Start, const Fvector& Dir, float& InOutRange, u32& OutTriangle) const;
+
+	inline const Fvector*							GetTriangle				(u32 Triangle) const { return &Vertices[Triangle * 3]; }
+	inline bool										IsEmpty					() const { return Nodes.Num() == 0; }
+
+private:
+	struct FNode
+	{
+		Fbox										Bounds;
+		// Second child of an inner node, the first one follows the node itself. First triangle of a leaf
+		u32											First;
+		// Triangles of a leaf, zero for inner nodes
+		u32											Count;
+	};
+	int32											BuildNode				(TArray<u32>& Triangles, const TArray<Fvector>& Centers, const TArray<Fvector>& InVertices, int32 First, int32 Count);
+
+	TArray<Fvector>									Vertices;
+	TArray<FNode>									Nodes;
+};
@@ -1,5 +1,6 @@
 #include "StalkerKinematicsData.h"
 #include "StalkerKinematicsBone.h"
+#include "StalkerKinematicsSharedData.h"
 
 void UStalkerKinematicsData::BuildFromLegacy(const TArray<TSharedPtr<CBoneData>>& LegacyBones)
 {
@@ -8,6 +9,7 @@ void UStalkerKinematicsData::BuildFromLegacy(const TArray<TSharedPtr<CBoneData>>
 		FString Name =  Bone->name.c_str();
 		Bones.Add(FName( Name)).BuildFromLegacy(*Bone);
 	}
+	SharedData.Reset();
 }
 
 void UStalkerKinematicsData::BuildBones(TArray<StalkerKinematicsBone>& InBones)
@@ -43,3 +45,23 @@ void UStalkerKinematicsData::BuildBones(TArray<StalkerKinematicsBone>& InBones)
 	}
 }
 
+
+TSharedRef<FStalkerKinematicsSharedData> UStalkerKinematicsData::GetSharedData()
+{
+	check(IsInGameThread());
+	if (TSharedPtr<FStalkerKinematicsSharedData> Result = SharedData.Pin())
+	{
+		return Result.ToSharedRef();
+	}
+	TSharedRef<FStalkerKinematicsSharedData> Result = MakeShared<FStalkerKinematicsSharedData>(this);
+	SharedData = Result;
+	return Result;
+}
+
+#if WITH_EDITOR
+void UStalkerKinematicsData::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	SharedData.Reset();
+}
+#endif
@@ -21,4 +21,12 @@ public:
 
 	void BuildFromLegacy(const  TArray<TSharedPtr<CBoneData>>& LegacyBones);
 	void BuildBones(TArray<StalkerKinematicsBone>& LegacyBones);
+	// Built on first use and kept while any component references it
+	TSharedRef<class FStalkerKinematicsSharedData> GetSharedData();
+#if WITH_EDITOR
+	void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	TWeakPtr<class FStalkerKinematicsSharedData> SharedData;
 };
@@ -0,0 +1,226 @@
+#include "StalkerKinematicsSharedData.h"
+#include "StalkerKinematicsData.h"
+#include "Animation/AnimSequence.h"
+#include "Rendering/SkeletalMeshRenderData.h"
+
+FStalkerKinematicsSharedData::FStalkerKinematicsSharedData(UStalkerKinematicsData* KinematicsData)
+{
+	KinematicsData->BuildBones(Bones);
+	GeometryMesh = KinematicsData->Mesh;
+	if (KinematicsData->UserData.Len())
+	{
+		UserDataText.Append(TCHAR_TO_ANSI(*KinematicsData->UserData), KinematicsData->UserData.Len());
+	}
+
+	for (StalkerKinematicsBone& Bone : Bones)
+	{
+		BonesName2ID.Add(Bone.GetName(), Bone.SelfID);
+		BonesID2Name.Add(Bone.SelfID, Bone.GetName());
+	}
+
+	u32 BonesPartID = 0;
+	if (KinematicsData->Anims.Num())
+	{
+		for (auto& [Name, BonesPart] : KinematicsData->Anims[0]->BonesParts)
+		{
+			if (BonesPart.Bones.Num() == 0)continue;
+			BonesPartsName2ID.Add(TCHAR_TO_ANSI(*Name.ToString().ToLower()), BonesPartID);
+			BonesParts.Add(BonesPart);
+			BonesPartID++;
+		}
+	}
+	int32 BonesPartsID = 0;
+	for (FStalkerKinematicsAnimsBonesPart& BonesPart : BonesParts)
+	{
+		for (FName& BoneOfPart : BonesPart.Bones)
+		{
+			shared_str BoneName = TCHAR_TO_ANSI(*BoneOfPart.ToString().ToLower());
+			BonesPartsBoneID2ID.Add(BonesName2ID[BoneName], BonesPartsID);
+		}
+		BonesPartsID++;
+	}
+	u32 AnimID = 0;
+	for (int32 i = 0; i < KinematicsData->Anims.Num(); i++)
+	{
+		for (auto& [Name, AnimData] : KinematicsData->Anims[i]->Anims)
+		{
+			if (!IsValid(AnimData.Amim))
+			{
+				checkSlow(false);
+				continue;
+			}
+			if (!AnimData.Amim->GetSkeleton()->IsCompatible(KinematicsData->Mesh->GetSkeleton()))
+			{
+				checkSlow(false);
+				continue;
+			}
+			AnimsName2ID.Add(TCHAR_TO_ANSI(*Name.ToString().ToLower()), AnimID);
+			Anims.Add(AnimData);
+			AnimID++;
+			CMotionDef& MotionDef = AnimsDef.AddDefaulted_GetRef();
+			AnimData.BuildToLegacy(MotionDef, BonesName2ID, BonesPartsName2ID);
+			MotionDef.speed = MotionDef.Quantize(AnimData.Amim->RateScale);
+		}
+	}
+}
+
+void FStalkerKinematicsSharedData::BuildBonesGeometryOnce()
+{
+	if (bBonesGeometryBuilt)
+	{
+		return;
+	}
+	FScopeLock Lock(&BonesGeometryLock);
+	if (!bBonesGeometryBuilt)
+	{
+		if (USkeletalMesh* Mesh = GeometryMesh.Get())
+		{
+			BuildBonesGeometry(Mesh);
+		}
+		bBonesGeometryBuilt = true;
+	}
+}
+
+void FStalkerKinematicsSharedData::BuildBonesGeometry(USkeletalMesh* Mesh)
+{
+	FSkeletalMeshRenderData* RenderResource = Mesh->GetResourceForRendering();
+	if (!RenderResource || RenderResource->LODRenderData.Num() == 0)
+	{
+		return;
+	}
+	FSkeletalMeshLODRenderData& LODRenderData = RenderResource->LODRenderData[0];
+	const FPositionVertexBuffer& PositionVertexBuffer = LODRenderData.StaticVertexBuffers.PositionVertexBuffer;
+	const FSkinWeightVertexBuffer* SkinWeightVertexBuffer = LODRenderData.GetSkinWeightVertexBuffer();
+	const FRawStaticIndexBuffer16or32Interface* IndexBuffer = LODRenderData.MultiSizeIndexContainer.GetIndexBuffer();
+	// Cooked meshes drop their CPU copies unless CPU access is allowed
+	if (!PositionVertexBuffer.GetVertexData() || !SkinWeightVertexBuffer || !IndexBuffer || IndexBuffer->Num() == 0)
+	{
+		return;
+	}
+
+	// Vertices influenced by a bone, counted first and then placed, like a counting sort
+	const uint32 MaxBoneInfluences = SkinWeightVertexBuffer->GetMaxBoneInfluences();
+	const uint16 MinBoneWeight = 30;
+	BonesVerticesOffset.Init(0, Bones.Num() + 1);
+	for (int32 Pass = 0; Pass < 2; Pass++)
+	{
+		TArray<int32> BonesCursor;
+		if (Pass == 1)
+		{
+			for (int32 BoneID = 0; BoneID < Bones.Num(); BoneID++)
+			{
+				BonesVerticesOffset[BoneID + 1] += BonesVerticesOffset[BoneID];
+			}
+			BonesVertices.SetNumUninitialized(BonesVerticesOffset.Last());
+			BonesCursor = BonesVerticesOffset;
+		}
+		for (const FSkelMeshRenderSection& Section : LODRenderData.RenderSections)
+		{
+			for (uint32 VertexIndex = Section.BaseVertexIndex; VertexIndex < Section.BaseVertexIndex + Section.NumVertices; VertexIndex++)
+			{
+				const FSkinWeightInfo SkinWeightInfo = SkinWeightVertexBuffer->GetVertexSkinWeights(VertexIndex);
+				for (uint32 Influence = 0; Influence < MaxBoneInfluences; Influence++)
+				{
+					if (SkinWeightInfo.InfluenceWeights[Influence] <= MinBoneWeight)
+					{
+						continue;
+					}
+					const int32 BoneID = Section.BoneMap[SkinWeightInfo.InfluenceBones[Influence]];
+					if (BoneID >= Bones.Num())
+					{
+						continue;
+					}
+					if (Pass == 0)
+					{
+						BonesVerticesOffset[BoneID + 1]++;
+					}
+					else
+					{
+						BonesVertices[BonesCursor[BoneID]++] = StalkerMath::UnrealLocationToXRay(PositionVertexBuffer.VertexPosition(VertexIndex));
+					}
+				}
+			}
+		}
+	}
+
+	// Bind pose of every bone in model space, bones never follow their children
+	TArray<Fmatrix> InvBindTransforms;
+	InvBindTransforms.SetNumUninitialized(Bones.Num());
+	{
+		TArray<Fmatrix> BindTransforms;
+		BindTransforms.SetNumUninitialized(Bones.Num());
+		for (int32 BoneID = 0; BoneID < Bones.Num(); BoneID++)
+		{
+			if (Bones[BoneID].ParentID == BI_NONE)
+			{
+				BindTransforms[BoneID] = Bones[BoneID].BindTransformation;
+			}
+			else
+			{
+				check(Bones[BoneID].ParentID < BoneID);
+				BindTransforms[BoneID].mul_43(BindTransforms[Bones[BoneID].ParentID], Bones[BoneID].BindTransformation);
+			}
+			InvBindTransforms[BoneID].invert(BindTransforms[BoneID]);
+		}
+	}
+
+	TArray<TArray<Fvector>> BonesTriangles;
+	BonesTriangles.SetNum(Bones.Num());
+	for (const FSkelMeshRenderSection& Section : LODRenderData.RenderSections)
+	{
+		for (uint32 Triangle = 0; Triangle < Section.NumTriangles; Triangle++)
+		{
+			uint32 VertexIndices[3];
+			TArray<u16, TInlineAllocator<12>> TriangleBones;
+			for (int32 Corner = 0; Corner < 3; Corner++)
+			{
+				VertexIndices[Corner] = IndexBuffer->Get(Section.BaseIndex + Triangle * 3 + Corner);
+				const FSkinWeightInfo SkinWeightInfo = SkinWeightVertexBuffer->GetVertexSkinWeights(VertexIndices[Corner]);
+				for (uint32 Influence = 0; Influence < MaxBoneInfluences; Influence++)
+				{
+					if (SkinWeightInfo.InfluenceWeights[Influence] == 0)
+					{
+						continue;
+					}
+					const int32 BoneID = Section.BoneMap[SkinWeightInfo.InfluenceBones[Influence]];
+					if (BoneID < Bones.Num())
+					{
+						TriangleBones.AddUnique(u16(BoneID));
+					}
+				}
+			}
+			for (u16 BoneID : TriangleBones)
+			{
+				for (int32 Corner = 0; Corner < 3; Corner++)
+				{
+					InvBindTransforms[BoneID].transform_tiny(BonesTriangles[BoneID].AddDefaulted_GetRef(), StalkerMath::UnrealLocationToXRay(PositionVertexBuffer.VertexPosition(VertexIndices[Corner])));
+				}
+			}
+		}
+	}
+
+	BonesPickTree.SetNum(Bones.Num());
+	ParallelFor(Bones.Num(), [this, &BonesTriangles](int32 BoneID)
+	{
+		BonesPickTree[BoneID].Build(BonesTriangles[BoneID]);
+	});
+}
+
+CInifile* FStalkerKinematicsSharedData::GetUserData()
+{
+	FScopeLock Lock(&UserDataLock);
+	if (!UserDataParsed && UserDataText.Num())
+	{
+		IReader Reader(UserDataText.GetData(), UserDataText.Num());
+		UserData = MakeUnique<CInifile>(&Reader, FS.get_path("$game_config$")->m_Path);
+		UserDataText.Empty();
+	}
+	UserDataParsed = true;
+	return UserData.Get();
+}
+
+TSharedRef<FStalkerKinematicsSharedData> FStalkerKinematicsSharedData::GetEmpty()
+{
+	static TSharedRef<FStalkerKinematicsSharedData> Empty = MakeShared<FStalkerKinematicsSharedData>();
+	return Empty;
+}
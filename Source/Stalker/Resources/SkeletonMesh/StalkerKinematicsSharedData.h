@@ -0,0 +1,55 @@
+#pragma once
+#include "StalkerKinematicsBone.h"
+#include "StalkerKinematicsAnimsData.h"
+#include "StalkerKinematicsBonePickTree.h"
+THIRD_PARTY_INCLUDES_START
+#include "XrEngine/motion.h"
+THIRD_PARTY_INCLUDES_END
+
+// Tables built from a UStalkerKinematicsData that never change afterwards, shared by every kinematics component using it
+class STALKER_API FStalkerKinematicsSharedData
+{
+public:
+												FStalkerKinematicsSharedData	() = default;
+												FStalkerKinematicsSharedData	(class UStalkerKinematicsData* KinematicsData);
+												FStalkerKinematicsSharedData	(const FStalkerKinematicsSharedData&) = delete;
+	FStalkerKinematicsSharedData&				operator=						(const FStalkerKinematicsSharedData&) = delete;
+	// Used by components without kinematics data, so they never hold a null pointer
+	static TSharedRef<FStalkerKinematicsSharedData>	GetEmpty					();
+
+	TArray<StalkerKinematicsBone>				Bones;
+	TMap<u16, shared_str>						BonesID2Name;
+	TMap<shared_str, u16>						BonesName2ID;
+
+	TArray<FStalkerKinematicsAnimData>			Anims;
+	TArray<CMotionDef>							AnimsDef;
+	TMap<shared_str, u32>						AnimsName2ID;
+
+	TArray<FStalkerKinematicsAnimsBonesPart>	BonesParts;
+	TMap<shared_str, u32>						BonesPartsName2ID;
+	TMap<u32, u32>								BonesPartsBoneID2ID;
+
+	// Parsed on the first call, the instance is shared with editor spawn objects that are built before the game file system exists
+	CInifile*									GetUserData						();
+
+	// Builds the bone geometry below on the first call, it reads the CPU copy of the mesh buffers.
+	// Meshes cooked without CPU access leave it empty
+	void										BuildBonesGeometryOnce			();
+	// Indexed by bone ID, empty for bones without skinned triangles
+	TArray<FStalkerKinematicsBonePickTree>		BonesPickTree;
+	// Bind pose vertices of bone ID are BonesVertices[BonesVerticesOffset[ID]] up to BonesVerticesOffset[ID + 1]
+	TArray<int32>								BonesVerticesOffset;
+	TArray<Fvector>								BonesVertices;
+
+private:
+	void										BuildBonesGeometry				(class USkeletalMesh* Mesh);
+
+	TWeakObjectPtr<class USkeletalMesh>			GeometryMesh;
+	std::atomic<bool>							bBonesGeometryBuilt = false;
+	FCriticalSection							BonesGeometryLock;
+
+	TArray<char>								UserDataText;
+	TUniquePtr<CInifile>						UserData;
+	bool										UserDataParsed = false;
+	FCriticalSection							UserDataLock;
+};
@@ -1,7 +1,23 @@
 #pragma once
 #include "StalkerGameGraph.h"
+#include "StalkerLevelSpawn.h"
 #include "StalkerGameSpawn.generated.h"
 
+USTRUCT()
+struct FStalkerGameSpawnLevelPoint
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	FVector3f		Position = FVector3f::ZeroVector;
+
+	UPROPERTY()
+	uint32			NodeID = 0;
+
+	UPROPERTY()
+	float			Distance = 0.f;
+};
+
 USTRUCT()
 struct FStalkerGameSpawnLevelInfo
 {
@@ -21,6 +37,27 @@ struct FStalkerGameSpawnLevelInfo
 
 	UPROPERTY()
 	FGuid			LevelSpawnGuid;
+
+	UPROPERTY()
+	FGuid			ContentHash;
+
+	UPROPERTY()
+	TArray<FString>	Visuals;
+
+	// Settings the level was built with, a change invalidates the built objects below
+	UPROPERTY()
+	uint32			BuildSettingsHash = 0;
+
+	// Objects of the level after the last game spawn build corrected them, reused while the level is unchanged
+	UPROPERTY()
+	TArray<FStalkerLevelSpawnData>		BuiltSpawns;
+
+	UPROPERTY()
+	TArray<FStalkerGameSpawnLevelPoint>	BuiltLevelPoints;
+
+	// First game vertex of the level when BuiltSpawns were corrected, graph ids are rebased from it
+	UPROPERTY()
+	int32			BuiltVertexOffset = 0;
 };
 
 UCLASS()
@@ -1,4 +1,5 @@
 #include "StalkerLevelSpawn.h"
+#include "Misc/SecureHash.h"
 
 UStalkerLevelSpawn::UStalkerLevelSpawn	()
 {
@@ -65,8 +66,126 @@ void UStalkerLevelSpawn::InvalidLevelSpawn	()
 	GameGraphEdges.Empty();
 	GameCrossTableCells.Empty();
 	Spawns.Empty();
+	Visuals.Empty();
 	AIMap = nullptr;
 	LevelID = -1;
 	NeedRebuild = true;
 	Modify();
 }
+
+void UStalkerLevelSpawn::BuildGameVertexNodes(TArray<int32>& OutOffsets, TArray<uint32>& OutNodes) const
+{
+	const int32 VertexCount = GameGraphVertices.Num();
+	OutOffsets.Reset(VertexCount + 1);
+	OutOffsets.AddZeroed(VertexCount + 1);
+	for (const IGameLevelCrossTable::CCell& Cell : GameCrossTableCells)
+	{
+		if (static_cast<int32>(Cell.tGraphIndex) < VertexCount)
+		{
+			OutOffsets[Cell.tGraphIndex + 1]++;
+		}
+	}
+	for (int32 VertexID = 0; VertexID < VertexCount; VertexID++)
+	{
+		OutOffsets[VertexID + 1] += OutOffsets[VertexID];
+	}
+
+	TArray<int32> Cursors(OutOffsets.GetData(), VertexCount);
+	OutNodes.Reset(OutOffsets[VertexCount]);
+	OutNodes.AddUninitialized(OutOffsets[VertexCount]);
+	for (int32 NodeID = 0; NodeID < GameCrossTableCells.Num(); NodeID++)
+	{
+		const int32 VertexID = GameCrossTableCells[NodeID].tGraphIndex;
+		if (VertexID < VertexCount)
+		{
+			OutNodes[Cursors[VertexID]++] = static_cast<uint32>(NodeID);
+		}
+	}
+}
+
+FGuid UStalkerLevelSpawn::CalculateContentHash() const
+{
+	// Fields are hashed one by one, whole structs would pull their padding bytes into the digest.
+	// The CForm is not read by the game spawn build, it only reaches it through the AI map and so through AIMapGuid
+	FMD5 MD5;
+	auto Update = [&MD5](const auto& Value)
+	{
+		MD5.Update(reinterpret_cast<const uint8*>(&Value), sizeof(Value));
+	};
+	auto UpdateString = [&MD5, &Update](const FString& String)
+	{
+		Update(String.Len());
+		MD5.Update(reinterpret_cast<const uint8*>(*String), String.Len() * sizeof(TCHAR));
+	};
+
+	Update(AIMapGuid);
+	UpdateString(Map.ToString());
+	Update(GameGraphVertices.Num());
+	for (const IGameGraph::CVertex& Vertex : GameGraphVertices)
+	{
+		Update(Vertex.tLocalPoint);
+		Update(Vertex.tGlobalPoint);
+		Update(u32(Vertex.tLevelID));
+		Update(u32(Vertex.tNodeID));
+		Update(Vertex.tVertexTypes);
+		Update(u32(Vertex.dwEdgeOffset));
+		Update(u32(Vertex.dwPointOffset));
+		Update(u32(Vertex.tNeighbourCount));
+		Update(u32(Vertex.tDeathPointCount));
+	}
+	Update(GameGraphEdges.Num());
+	for (const IGameGraph::CEdge& Edge : GameGraphEdges)
+	{
+		Update(Edge.m_vertex_id);
+		Update(Edge.m_path_distance);
+	}
+	Update(GameCrossTableCells.Num());
+	for (const IGameLevelCrossTable::CCell& Cell : GameCrossTableCells)
+	{
+		Update(Cell.tGraphIndex);
+		Update(Cell.fDistance);
+	}
+	Update(Spawns.Num());
+	for (const FStalkerLevelSpawnData& Spawn : Spawns)
+	{
+		Update(Spawn.SpawnData.Num());
+		MD5.Update(Spawn.SpawnData.GetData(), Spawn.SpawnData.Num());
+	}
+	Update(Ways.Num());
+	for (const FStalkerLevelSpawnWay& Way : Ways)
+	{
+		UpdateString(Way.Name);
+		Update(Way.Points.Num());
+		for (const FStalkerLevelSpawnWayPoint& Point : Way.Points)
+		{
+			UpdateString(Point.Name);
+			Update(Point.Position);
+			Update(Point.Flags);
+			Update(Point.Links.Num());
+			for (const FStalkerLevelSpawnWayPointLink& Link : Point.Links)
+			{
+				Update(Link.Probability);
+				Update(Link.ToPoint);
+			}
+		}
+	}
+	TArray<int32> ConnectionIDs;
+	GameGraphConnection.GetKeys(ConnectionIDs);
+	ConnectionIDs.Sort();
+	Update(ConnectionIDs.Num());
+	for (int32 ConnectionID : ConnectionIDs)
+	{
+		const FStalkerLevelGraphPointConnection& Connection = GameGraphConnection[ConnectionID];
+		Update(ConnectionID);
+		Update(Connection.VertexID);
+		UpdateString(Connection.Name);
+		UpdateString(Connection.ConnectionLevelName);
+		UpdateString(Connection.ConnectionPointName);
+	}
+
+	uint8 Digest[16];
+	MD5.Final(Digest);
+	FGuid Result;
+	FMemory::Memcpy(&Result, Digest, sizeof(Result));
+	return Result;
+}
@@ -89,6 +89,9 @@ public:
 	TArray<FStalkerLevelSpawnData>		Spawns;
 	UPROPERTY()
 	TArray<FStalkerLevelSpawnWay>		Ways;
+	// Visual names referenced by Spawns, prefetched when the level is loaded
+	UPROPERTY()
+	TArray<FString>						Visuals;
 	UPROPERTY()
 	TMap<int32,FStalkerLevelGraphPointConnection>		GameGraphConnection;
 	UPROPERTY()
@@ -102,6 +105,10 @@ public:
 		
 	void								Serialize				(FArchive& Ar) override;
 	void								InvalidLevelSpawn		();
+	// MD5 of everything the game spawn build reads from this level, unlike SpawnGuid it survives a rebuild with the same result
+	FGuid								CalculateContentHash	() const;
+	// Level vertices of game vertex V in ascending order are OutNodes[OutOffsets[V]..OutOffsets[V + 1])
+	void								BuildGameVertexNodes	(TArray<int32>& OutOffsets, TArray<uint32>& OutNodes) const;
 private:
 	const int32							Version = 0;
 };
\ No newline at end of file
@@ -5,10 +5,16 @@
 #include "../Entities/Levels/Light/StalkerLight.h"
 #include "../Entities/Levels/Proxy/StalkerProxy.h"
 #include "Spawn/StalkerGameSpawn.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "../Kernel/Unreal/GameSettings/StalkerGameSettings.h"
 THIRD_PARTY_INCLUDES_START
 #include "XrEngine/xr_object.h"
 THIRD_PARTY_INCLUDES_END
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("XRay ~ Kinematics Created"), STAT_XRayEngineKinematicsCreated, STATGROUP_XRayEngine);
+DECLARE_DWORD_COUNTER_STAT(TEXT("XRay ~ Kinematics Reused"), STAT_XRayEngineKinematicsReused, STATGROUP_XRayEngine);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("XRay ~ Kinematics Pooled"), STAT_XRayEngineKinematicsPooled, STATGROUP_XRayEngine);
+
 
 USlateBrushAsset* FStalkerResourcesManager::GetBrush(FName InNameMaterial, FName InNameTexture)
 {
@@ -42,39 +48,10 @@ USlateBrushAsset* FStalkerResourcesManager::GetBrush(FName InNameMaterial, FName
 	NameMaterial.ReplaceCharInline(TEXT('\\'), TEXT('/'));
 	UE_LOG(LogStalker, Log, TEXT("Create slate brush:[%s]%s"), *NameMaterial,*NameTexture);
 
-	UMaterialInterface* ParentMaterial = nullptr;
-
-	switch (xrGameManager::GetGame())
+	UMaterialInterface* ParentMaterial = Cast<UMaterialInterface>(LoadResolved(UMaterialInterface::StaticClass(), ResolvedMaterialPaths, NameMaterial, [this, &NameMaterial](TArray<FString>& OutPaths)
 	{
-	default:
-	{
-		const FString ParentPackageName = TEXT("/Game/COP/Materials") / NameMaterial;
-		const FString ParentObjectPath = ParentPackageName + TEXT(".") + FPaths::GetBaseFilename(ParentPackageName);
-		ParentMaterial = LoadObject<UMaterialInterface>(nullptr, *ParentObjectPath, nullptr, LOAD_NoWarn);
-	}
-		break;
-	case EGame::CS:
-	{
-		const FString ParentPackageName = TEXT("/Game/CS/Materials") / NameMaterial;
-		const FString ParentObjectPath = ParentPackageName + TEXT(".") + FPaths::GetBaseFilename(ParentPackageName);
-		ParentMaterial = LoadObject<UMaterialInterface>(nullptr, *ParentObjectPath, nullptr, LOAD_NoWarn);
-	}
-		break;
-	case EGame::SHOC:
-	{
-		const FString ParentPackageName = TEXT("/Game/SHOC/Materials") / NameMaterial;
-		const FString ParentObjectPath = ParentPackageName + TEXT(".") + FPaths::GetBaseFilename(ParentPackageName);
-		ParentMaterial = LoadObject<UMaterialInterface>(nullptr, *ParentObjectPath,nullptr, LOAD_NoWarn);
-	}
-		break;
-	}
-
-	if (!IsValid(ParentMaterial))
-	{
-		const FString ParentPackageName = TEXT("/Game/Base/Materials") / NameMaterial;
-		const FString ParentObjectPath = ParentPackageName + TEXT(".") + FPaths::GetBaseFilename(ParentPackageName);
-		ParentMaterial = LoadObject<UMaterialInterface>(nullptr, *ParentObjectPath, nullptr, LOAD_NoWarn);
-	}
+		GetContentPaths(TEXT("Materials"), NameMaterial, OutPaths);
+	}));
 	if (!IsValid(ParentMaterial))
 	{
 		UE_LOG(LogStalker, Warning, TEXT("Can't found ui material:%s"), *NameMaterial);
@@ -87,36 +64,10 @@ USlateBrushAsset* FStalkerResourcesManager::GetBrush(FName InNameMaterial, FName
 	if(InNameTexture!=NAME_None)
 	{
 		
-		switch (xrGameManager::GetGame())
+		Texture = Cast<UTexture>(LoadResolved(UTexture::StaticClass(), ResolvedTexturePaths, NameTexture, [this, &NameTexture](TArray<FString>& OutPaths)
 		{
-		default:
-		{
-			const FString ParentPackageName = TEXT("/Game/COP/Textures") / NameTexture;
-			const FString ParentObjectPath = ParentPackageName + TEXT(".") + FPaths::GetBaseFilename(ParentPackageName);
-			Texture = LoadObject<UTexture>(nullptr, *ParentObjectPath, nullptr, LOAD_NoWarn);
-		}
-			break;
-		case EGame::CS:
-		{
-			const FString ParentPackageName = TEXT("/Game/CS/Textures") / NameTexture;
-			const FString ParentObjectPath = ParentPackageName + TEXT(".") + FPaths::GetBaseFilename(ParentPackageName);
-			Texture = LoadObject<UTexture>(nullptr, *ParentObjectPath, nullptr, LOAD_NoWarn);
-		}
-			break;
-		case EGame::SHOC:
-		{
-			const FString ParentPackageName = TEXT("/Game/SHOC/Textures") / NameTexture;
-			const FString ParentObjectPath = ParentPackageName + TEXT(".") + FPaths::GetBaseFilename(ParentPackageName);
-			Texture = LoadObject<UTexture>(nullptr, *ParentObjectPath, nullptr, LOAD_NoWarn);
-		}
-			break;
-		}
-		if (!IsValid(Texture))
-		{
-			const FString ParentPackageName = TEXT("/Game/Base/Textures") / NameTexture;
-			const FString ParentObjectPath = ParentPackageName + TEXT(".") + FPaths::GetBaseFilename(ParentPackageName);
-			Texture = LoadObject<UTexture>(nullptr, *ParentObjectPath, nullptr, LOAD_NoWarn);
-		}
+			GetContentPaths(TEXT("Textures"), NameTexture, OutPaths);
+		}));
 		if (!IsValid(Texture))
 		{
 			UE_LOG(LogStalker, Warning, TEXT("Can't found texture:%s"), *NameTexture);
@@ -263,77 +214,20 @@ class UStalkerKinematicsData* FStalkerResourcesManager::GetKinematics(const char
 		return nullptr;
 	}
 
-	UStalkerKinematicsData* KinematicsData  = LoadObject<UStalkerKinematicsData>(nullptr, *FString(InName), nullptr, LOAD_NoWarn);;
-
-	FString Name = InName;
-	if(!IsValid(KinematicsData))
+	const FString Name = InName;
+	if (int32* RequestID = PrefetchRequests.Find(Name))
 	{
-	
-		Name.ReplaceInline(TEXT("\\"), TEXT("/"));
-		Name.ReplaceInline(TEXT("#"), TEXT("_"));
-		switch (xrGameManager::GetGame())
-		{
-		default:
-		{
-			const FString ParentPackageName = TEXT("/Game/COP/Meshes") / Name;
-			const FString ParentObjectPath = ParentPackageName + TEXT(".") + FPaths::GetBaseFilename(ParentPackageName);
-			KinematicsData = LoadObject<UStalkerKinematicsData>(nullptr, *ParentObjectPath, nullptr, LOAD_NoWarn);
-			if (!IsValid(KinematicsData))
-			{
-				if (Name.StartsWith(TEXT("meshes/")))
-				{
-					FString NewName = Name;
-					NewName.RemoveFromStart(TEXT("meshes/"));
-					const FString ParentPackageNameFromLevel = TEXT("/Game/COP/Meshes/levels") / GStalkerEngineManager->GetCurrentWorldName() / NewName;
-					const FString ParentObjectPathFromLevel = ParentPackageNameFromLevel + TEXT(".") + FPaths::GetBaseFilename(ParentPackageNameFromLevel);
-					KinematicsData = LoadObject<UStalkerKinematicsData>(nullptr, *ParentObjectPathFromLevel, nullptr, LOAD_NoWarn);
-				}
-			}
-		}
-		break;
-		case EGame::CS:
-		{
-			const FString ParentPackageName = TEXT("/Game/CS/Meshes") / Name;
-			const FString ParentObjectPath = ParentPackageName + TEXT(".") + FPaths::GetBaseFilename(ParentPackageName);
-			KinematicsData = LoadObject<UStalkerKinematicsData>(nullptr, *ParentObjectPath, nullptr, LOAD_NoWarn);
-			if (!IsValid(KinematicsData))
-			{
-				if (Name.StartsWith(TEXT("meshes/")))
-				{
-					FString NewName = Name;
-					NewName.RemoveFromStart(TEXT("meshes/"));
-					const FString ParentPackageNameFromLevel = TEXT("/Game/CS/Meshes/levels") / GStalkerEngineManager->GetCurrentWorldName() / NewName;
-					const FString ParentObjectPathFromLevel = ParentPackageNameFromLevel + TEXT(".") + FPaths::GetBaseFilename(ParentPackageNameFromLevel);
-					KinematicsData = LoadObject<UStalkerKinematicsData>(nullptr, *ParentObjectPathFromLevel, nullptr, LOAD_NoWarn);
-				}
-			}
-		}
-		break;
-		case EGame::SHOC:
-		{
-			const FString ParentPackageName = TEXT("/Game/SHOC/Meshes") / Name;
-			const FString ParentObjectPath = ParentPackageName + TEXT(".") + FPaths::GetBaseFilename(ParentPackageName);
-			KinematicsData = LoadObject<UStalkerKinematicsData>(nullptr, *ParentObjectPath, nullptr, LOAD_NoWarn);
-			if (!IsValid(KinematicsData))
-			{
-				if (Name.StartsWith(TEXT("meshes/")))
-				{
-					FString NewName = Name;
-					NewName.RemoveFromStart(TEXT("meshes/"));
-					const FString ParentPackageNameFromLevel = TEXT("/Game/SHOC/Meshes/levels") / GStalkerEngineManager->GetCurrentWorldName() / NewName;
-					const FString ParentObjectPathFromLevel = ParentPackageNameFromLevel + TEXT(".") + FPaths::GetBaseFilename(ParentPackageNameFromLevel);
-					KinematicsData = LoadObject<UStalkerKinematicsData>(nullptr, *ParentObjectPathFromLevel, nullptr, LOAD_NoWarn);
-				}
-			}
-		}
-		break;
-		}
+		// still in flight, block on this one package only
+		FlushAsyncLoading(*RequestID);
 	}
+
+	UStalkerKinematicsData* KinematicsData = PrefetchedKinematics.FindRef(Name);
 	if (!IsValid(KinematicsData))
 	{
-		const FString ParentPackageName = TEXT("/Game/Base/Meshes") / Name;
-		const FString ParentObjectPath = ParentPackageName + TEXT(".") + FPaths::GetBaseFilename(ParentPackageName);
-		KinematicsData = LoadObject<UStalkerKinematicsData>(nullptr, *ParentObjectPath, nullptr, LOAD_NoWarn);
+		KinematicsData = Cast<UStalkerKinematicsData>(LoadResolved(UStalkerKinematicsData::StaticClass(), ResolvedKinematicsPaths, Name, [this, &Name](TArray<FString>& OutPaths)
+		{
+			GetKinematicsPaths(Name, OutPaths);
+		}));
 	}
 	if (!ensure(IsValid(KinematicsData))||!ensure(IsValid(KinematicsData->Mesh)))
 	{
@@ -353,8 +247,192 @@ class UStalkerKinematicsData* FStalkerResourcesManager::GetKinematics(const char
 	return KinematicsData;
 }
 
+void FStalkerResourcesManager::GetContentPaths(const TCHAR* Folder, const FString& Name, TArray<FString>& OutPaths)
+{
+	const FString GamePackageName = GetGamePath() / Folder / Name;
+	OutPaths.Add(GamePackageName + TEXT(".") + FPaths::GetBaseFilename(GamePackageName));
+	const FString BasePackageName = FString(TEXT("/Game/Base")) / Folder / Name;
+	OutPaths.Add(BasePackageName + TEXT(".") + FPaths::GetBaseFilename(BasePackageName));
+}
+
+UObject* FStalkerResourcesManager::LoadResolved(UClass* Class, TMap<FString, FString>& ResolvedPaths, const FString& Name, TFunctionRef<void(TArray<FString>&)> GetPaths)
+{
+	if (const FString* ResolvedPath = ResolvedPaths.Find(Name))
+	{
+		if (ResolvedPath->IsEmpty())
+		{
+			return nullptr;
+		}
+		UObject* Result = StaticLoadObject(Class, nullptr, **ResolvedPath, nullptr, LOAD_NoWarn);
+		if (IsValid(Result))
+		{
+			return Result;
+		}
+		ResolvedPaths.Remove(Name);
+	}
+
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	// while the registry is still scanning a missing asset can't be told from an unscanned one, so probe and don't remember misses
+	const bool bRegistryComplete = !AssetRegistry.IsLoadingAssets();
+	TArray<FString> Paths;
+	GetPaths(Paths);
+	for (const FString& ObjectPath : Paths)
+	{
+		if (bRegistryComplete && (!FPackageName::IsValidObjectPath(ObjectPath) || !AssetRegistry.GetAssetByObjectPath(FSoftObjectPath(ObjectPath)).IsValid()))
+		{
+			continue;
+		}
+		UObject* Result = StaticLoadObject(Class, nullptr, *ObjectPath, nullptr, LOAD_NoWarn);
+		if (IsValid(Result))
+		{
+			ResolvedPaths.Add(Name, ObjectPath);
+			return Result;
+		}
+	}
+	if (bRegistryComplete)
+	{
+		ResolvedPaths.Add(Name, FString());
+	}
+	return nullptr;
+}
+
+void FStalkerResourcesManager::ResetResolvedPaths()
+{
+	ResolvedMaterialPaths.Empty();
+	ResolvedTexturePaths.Empty();
+	ResolvedKinematicsPaths.Empty();
+}
+
+#if WITH_EDITOR
+void FStalkerResourcesManager::OnAssetChanged(const FAssetData& AssetData)
+{
+	ResetResolvedPaths();
+}
+
+void FStalkerResourcesManager::OnAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	ResetResolvedPaths();
+}
+#endif
+
+void FStalkerResourcesManager::GetKinematicsPaths(const FString& InName, TArray<FString>& OutPaths)
+{
+	auto AddPath = [&OutPaths](const FString& PackageName)
+	{
+		OutPaths.Add(PackageName + TEXT(".") + FPaths::GetBaseFilename(PackageName));
+	};
+
+	OutPaths.Add(InName);
+	FString Name = InName;
+	Name.ReplaceInline(TEXT("\\"), TEXT("/"));
+	Name.ReplaceInline(TEXT("#"), TEXT("_"));
+	AddPath(GetGamePath() / TEXT("Meshes") / Name);
+	if (Name.StartsWith(TEXT("meshes/")))
+	{
+		FString NewName = Name;
+		NewName.RemoveFromStart(TEXT("meshes/"));
+		AddPath(GetGamePath() / TEXT("Meshes/levels") / GStalkerEngineManager->GetCurrentWorldName() / NewName);
+	}
+	AddPath(TEXT("/Game/Base/Meshes") / Name);
+}
+
+void FStalkerResourcesManager::PrefetchKinematics(const TArray<FString>& Names)
+{
+	TArray<FString> Paths;
+	for (const FString& Name : Names)
+	{
+		if (PrefetchedKinematics.Contains(Name) || PrefetchRequests.Contains(Name))
+		{
+			continue;
+		}
+		Paths.Reset();
+		if (const FString* ResolvedPath = ResolvedKinematicsPaths.Find(Name))
+		{
+			Paths.Add(*ResolvedPath);
+		}
+		else
+		{
+			GetKinematicsPaths(Name, Paths);
+		}
+		for (const FString& ObjectPath : Paths)
+		{
+			const FString PackageName = FPackageName::ObjectPathToPackageName(ObjectPath);
+			if (!FPackageName::IsValidLongPackageName(PackageName))
+			{
+				continue;
+			}
+			if (UStalkerKinematicsData* KinematicsData = FindObject<UStalkerKinematicsData>(nullptr, *ObjectPath))
+			{
+				PrefetchedKinematics.Add(Name, KinematicsData);
+				break;
+			}
+			if (!FPackageName::DoesPackageExist(PackageName))
+			{
+				continue;
+			}
+			const int32 RequestID = LoadPackageAsync(PackageName, FLoadPackageAsyncDelegate::CreateRaw(this, &FStalkerResourcesManager::OnKinematicsPrefetched, Name, ObjectPath, PrefetchGeneration));
+			PrefetchRequests.Add(Name, RequestID);
+			break;
+		}
+	}
+	UE_LOG(LogStalker, Log, TEXT("Prefetch kinematics: %d requested, %d in flight"), Names.Num(), PrefetchRequests.Num());
+}
+
+void FStalkerResourcesManager::PrefetchLevelKinematics(const FString& LevelName)
+{
+	UStalkerGameSpawn* CurrentGameSpawn = GetGameSpawn();
+	if (!IsValid(CurrentGameSpawn))
+	{
+		return;
+	}
+	const FStalkerGameSpawnLevelInfo* LevelInfo = CurrentGameSpawn->LevelsInfo.FindByPredicate([&LevelName](const FStalkerGameSpawnLevelInfo& LevelInfo)
+	{
+		return LevelInfo.Name == LevelName;
+	});
+	if (LevelInfo)
+	{
+		PrefetchKinematics(LevelInfo->Visuals);
+	}
+}
+
+void FStalkerResourcesManager::FlushPrefetchedKinematics()
+{
+	// requests still in flight belong to the old generation and drop their results when done
+	PrefetchedKinematics.Empty();
+	PrefetchRequests.Empty();
+	PrefetchGeneration++;
+}
+
+void FStalkerResourcesManager::OnKinematicsPrefetched(const FName& PackageName, UPackage* Package, EAsyncLoadingResult::Type Result, FString Name, FString ObjectPath, uint32 Generation)
+{
+	if (Generation != PrefetchGeneration)
+	{
+		return;
+	}
+	PrefetchRequests.Remove(Name);
+	if (Result != EAsyncLoadingResult::Succeeded)
+	{
+		return;
+	}
+	UStalkerKinematicsData* KinematicsData = FindObject<UStalkerKinematicsData>(nullptr, *ObjectPath);
+	if (IsValid(KinematicsData))
+	{
+		PrefetchedKinematics.Add(Name, KinematicsData);
+	}
+}
+
 class UStalkerKinematicsComponent* FStalkerResourcesManager::CreateKinematics(class UStalkerKinematicsData* KinematicsData)
 {
+	if (TArray<UStalkerKinematicsComponent*>* Pool = KinematicsPool.Find(KinematicsData))
+	{
+		if (Pool->Num())
+		{
+			INC_DWORD_STAT(STAT_XRayEngineKinematicsReused);
+			SET_DWORD_STAT(STAT_XRayEngineKinematicsPooled, --KinematicsPoolNum);
+			return Pool->Pop(false);
+		}
+	}
+	INC_DWORD_STAT(STAT_XRayEngineKinematicsCreated);
 	UStalkerKinematicsComponent* Result =  NewObject< UStalkerKinematicsComponent>();
 	Result->SetFlags(EObjectFlags::RF_Transient);
 	Result->Initilize(KinematicsData);
@@ -380,9 +458,36 @@ class UStalkerKinematicsComponent* FStalkerResourcesManager::CreateKinematics(co
 void FStalkerResourcesManager::Destroy(UStalkerKinematicsComponent* Mesh)
 {
 	Meshes.Remove(Mesh);
+	// only detached components are reused, one still owned by an actor or locked by an xray object goes away with it
+	UStalkerKinematicsData* KinematicsData = Mesh->KinematicsData;
+	if (IsValid(KinematicsData) && Mesh->IsReusable())
+	{
+		TArray<UStalkerKinematicsComponent*>& Pool = KinematicsPool.FindOrAdd(KinematicsData);
+		if (Pool.Num() < GetDefault<UStalkerGameSettings>()->KinematicsPoolSize)
+		{
+			Mesh->ResetForReuse();
+			Pool.Add(Mesh);
+			SET_DWORD_STAT(STAT_XRayEngineKinematicsPooled, ++KinematicsPoolNum);
+			return;
+		}
+	}
 	Mesh->MarkAsGarbage();
 }
 
+void FStalkerResourcesManager::TrimKinematicsPool()
+{
+	for (auto& [KinematicsData, Pool] : KinematicsPool)
+	{
+		for (UStalkerKinematicsComponent* Mesh : Pool)
+		{
+			Mesh->MarkAsGarbage();
+		}
+	}
+	KinematicsPool.Empty();
+	KinematicsPoolNum = 0;
+	SET_DWORD_STAT(STAT_XRayEngineKinematicsPooled, 0);
+}
+
 
 void FStalkerResourcesManager::RegisterKinematics(class UStalkerKinematicsComponent* Mesh)
 {
@@ -471,6 +576,15 @@ void FStalkerResourcesManager::AddReferencedObjects(FReferenceCollector& Collect
 	{
 		Collector.AddReferencedObject(Value);
 	}
+	for (auto& [Key, Value] : PrefetchedKinematics)
+	{
+		Collector.AddReferencedObject(Value);
+	}
+	for (auto& [Key, Pool] : KinematicsPool)
+	{
+		Collector.AddReferencedObject(Key);
+		Collector.AddReferencedObjects(Pool);
+	}
 	Collector.AddReferencedObject(GameSpawn);
 }
 
@@ -481,11 +595,33 @@ FString FStalkerResourcesManager::GetReferencerName() const
 
 FStalkerResourcesManager::FStalkerResourcesManager()
 {
+#if WITH_EDITOR
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.OnAssetAdded().AddRaw(this, &FStalkerResourcesManager::OnAssetChanged);
+	AssetRegistry.OnAssetRemoved().AddRaw(this, &FStalkerResourcesManager::OnAssetChanged);
+	AssetRegistry.OnAssetRenamed().AddRaw(this, &FStalkerResourcesManager::OnAssetRenamed);
+#endif
+	FCoreDelegates::GetMemoryTrimDelegate().AddRaw(this, &FStalkerResourcesManager::TrimKinematicsPool);
 
 }
 
 FStalkerResourcesManager::~FStalkerResourcesManager()
 {
+	FCoreDelegates::GetMemoryTrimDelegate().RemoveAll(this);
+#if WITH_EDITOR
+	if (FAssetRegistryModule* AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+	{
+		IAssetRegistry& AssetRegistry = AssetRegistryModule->Get();
+		AssetRegistry.OnAssetAdded().RemoveAll(this);
+		AssetRegistry.OnAssetRemoved().RemoveAll(this);
+		AssetRegistry.OnAssetRenamed().RemoveAll(this);
+	}
+#endif
+	// completion callbacks are bound to this, flushed requests of older generations included
+	if (IsAsyncLoading())
+	{
+		FlushAsyncLoading();
+	}
 
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 class USlateBrushAsset;
+struct FAssetData;
 class STALKER_API FStalkerResourcesManager	: public FGCObject
 {
 public:
@@ -16,9 +17,14 @@ public:
 	class AStalkerLight*								CreateLight					();
 	void												Desotry						(class IRender_Light*Light);
 	class UStalkerKinematicsData*						GetKinematics				(const char* Name);
+	void												PrefetchKinematics			(const TArray<FString>& Names);
+	void												PrefetchLevelKinematics		(const FString& LevelName);
+	void												FlushPrefetchedKinematics	();
+	void												ResetResolvedPaths			();
 	class UStalkerKinematicsComponent*					CreateKinematics			(const char*Name, bool NeedRefence = false);
 	class UStalkerKinematicsComponent*					CreateKinematics			(class UStalkerKinematicsData* KinematicsData);
 	void												Destroy						(class UStalkerKinematicsComponent* Mesh);
+	void												TrimKinematicsPool			();
 	void												RegisterKinematics			(class UStalkerKinematicsComponent* Mesh);
 	void												UnregisterKinematics		(class UStalkerKinematicsComponent* Mesh);
 	void												Refresh						();
@@ -31,6 +37,9 @@ public:
 
 
 private:
+	friend class FStalkerResourcesResolvedPathsTest;
+	friend class FStalkerResourcesResolvedPathsBenchmark;
+	friend class FStalkerResourcesKinematicsChurnBenchmark;
 
 	TMap<FName, UFont*>									Fonts;
 
@@ -48,6 +57,25 @@ private:
 	TMap<USlateBrushAsset*, BrushInfo>					BrushesInfo;
 	
 	TSet<UStalkerKinematicsComponent*>					Meshes;
+	// Destroyed components kept for reuse, they are unregistered and live in the transient package
+	TMap<class UStalkerKinematicsData*, TArray<UStalkerKinematicsComponent*>>	KinematicsPool;
+	int32												KinematicsPoolNum = 0;
+
+	void												GetKinematicsPaths			(const FString& Name, TArray<FString>& OutPaths);
+	void												GetContentPaths				(const TCHAR* Folder, const FString& Name, TArray<FString>& OutPaths);
+	UObject*											LoadResolved				(UClass* Class, TMap<FString, FString>& ResolvedPaths, const FString& Name, TFunctionRef<void(TArray<FString>&)> GetPaths);
+#if WITH_EDITOR
+	void												OnAssetChanged				(const FAssetData& AssetData);
+	void												OnAssetRenamed				(const FAssetData& AssetData, const FString& OldObjectPath);
+#endif
+	// legacy name -> object path, an empty path marks a name none of the content paths has
+	TMap<FString, FString>								ResolvedMaterialPaths;
+	TMap<FString, FString>								ResolvedTexturePaths;
+	TMap<FString, FString>								ResolvedKinematicsPaths;
+	void												OnKinematicsPrefetched		(const FName& PackageName, UPackage* Package, EAsyncLoadingResult::Type Result, FString Name, FString ObjectPath, uint32 Generation);
+	TMap<FString, class UStalkerKinematicsData*>		PrefetchedKinematics;
+	TMap<FString, int32>								PrefetchRequests;
+	uint32												PrefetchGeneration = 0;
 
 	class UStalkerGameSpawn*							GameSpawn = nullptr;
 };
\ No newline at end of file
@@ -0,0 +1,392 @@
+#include "Misc/AutomationTest.h"
+#include "Resources/AIMap/StalkerAIMap.h"
+#include "Resources/AIMap/StalkerAIMapSpatialIndex.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITORONLY_DATA
+
+namespace StalkerAIMapTest
+{
+	UStalkerAIMap* CreateGrid(int32 SizeX, int32 SizeY)
+	{
+		UStalkerAIMap* AIMap = NewObject<UStalkerAIMap>(GetTransientPackage());
+		AIMap->HashClear();
+		for (int32 y = 0; y < SizeY; y++)
+		{
+			for (int32 x = 0; x < SizeX; x++)
+			{
+				const FVector3f Position(x * AIMap->NodeSize, y * AIMap->NodeSize, (x + y) % 3 * 10.f);
+				const int32 Node = AIMap->FindOrCreateNode(Position, 1.f, true);
+				AIMap->Nodes.Planes[Node] = FPlane4f(Position, FVector3f(0, 0, 1));
+			}
+		}
+		for (int32 Node = 0; Node < AIMap->Nodes.Num(); Node++)
+		{
+			AIMap->AutoLink(Node, 50.f, 50.f);
+		}
+		return AIMap;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerAIMapRemoveNodeTest, "Stalker.AIMap.RemoveNode", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStalkerAIMapRemoveNodeTest::RunTest(const FString& Parameters)
+{
+	UStalkerAIMap* AIMap = StalkerAIMapTest::CreateGrid(32, 32);
+	FStalkerAIMapNodes& Nodes = AIMap->Nodes;
+	TestTrue(TEXT("Interior node is linked on every side"), Nodes.Links[33][0] != INDEX_NONE && Nodes.Links[33][1] != INDEX_NONE && Nodes.Links[33][2] != INDEX_NONE && Nodes.Links[33][3] != INDEX_NONE);
+
+	TArray<FStalkerAIMapNodeHandle> Handles;
+	TArray<FVector3f> HandlePositions = Nodes.Positions;
+	for (int32 Node = 0; Node < Nodes.Num(); Node++)
+	{
+		Handles.Add(Nodes.GetHandle(Node));
+	}
+
+	// Links are compared by position because removal moves the last node into the hole
+	TArray<FVector3f> Removed;
+	FRandomStream Random(7);
+	for (int32 i = 0; i < 300; i++)
+	{
+		const int32 Node = Random.RandHelper(Nodes.Num());
+		Removed.Add(Nodes.Positions[Node]);
+		AIMap->RemoveNode(Node);
+	}
+
+	TestEqual(TEXT("Node count"), Nodes.Num(), 32 * 32 - 300);
+	TestEqual(TEXT("Index size"), AIMap->NodesIndex.Num(), Nodes.Num());
+	for (int32 Node = 0; Node < Nodes.Num(); Node++)
+	{
+		TestEqual(TEXT("Node is found at its position"), AIMap->FindNode(Nodes.Positions[Node], 1.f), Node);
+		for (int32 Link = 0; Link < 4; Link++)
+		{
+			const int32 Neighbour = Nodes.Links[Node][Link];
+			if (Neighbour == INDEX_NONE)
+			{
+				continue;
+			}
+			if (!TestTrue(TEXT("Link points into the node array"), Nodes.IsValidIndex(Neighbour)))
+			{
+				return false;
+			}
+			TestEqual(TEXT("Link is symmetric"), Nodes.Links[Neighbour][(Link + 2) % 4], Node);
+			TestFalse(TEXT("Link points to a removed node"), Removed.Contains(Nodes.Positions[Neighbour]));
+		}
+	}
+
+	int32 NumStale = 0;
+	for (int32 i = 0; i < Handles.Num(); i++)
+	{
+		const int32 Node = Nodes.Resolve(Handles[i]);
+		if (Node == INDEX_NONE)
+		{
+			NumStale++;
+			TestTrue(TEXT("Only removed nodes lose their handle"), Removed.Contains(HandlePositions[i]));
+			continue;
+		}
+		TestTrue(TEXT("Handle follows its node"), Nodes.Positions[Node] == HandlePositions[i]);
+	}
+	TestEqual(TEXT("Removed handles"), NumStale, 300);
+
+	// A slot freed by removal is reused by the next node under a new generation
+	const FStalkerAIMapNodeHandle Handle = Nodes.GetHandle(0);
+	const FVector3f Position = Nodes.Positions[0];
+	AIMap->RemoveNode(0);
+	const int32 Added = AIMap->FindOrCreateNode(Position, 1.f, true);
+	TestEqual(TEXT("New node does not take over the removed handle"), Nodes.Resolve(Handle), int32(INDEX_NONE));
+	TestEqual(TEXT("New node handle"), Nodes.Resolve(Nodes.GetHandle(Added)), Added);
+
+	const FStalkerAIMapNodeHandle BeforeReset = Nodes.GetHandle(Added);
+	Nodes.Reset();
+	Nodes.SetNum(Added + 1);
+	TestEqual(TEXT("Handles do not survive a reset"), Nodes.Resolve(BeforeReset), int32(INDEX_NONE));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerAIMapNodesBenchmark, "Stalker.AIMap.NodesBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FStalkerAIMapNodesBenchmark::RunTest(const FString& Parameters)
+{
+	// 708 x 708 grid, a little over 500k nodes
+	double StartTime = FPlatformTime::Seconds();
+	UStalkerAIMap* AIMap = StalkerAIMapTest::CreateGrid(708, 708);
+	const double CreateTime = FPlatformTime::Seconds() - StartTime;
+	FStalkerAIMapNodes& Nodes = AIMap->Nodes;
+	const int32 NumNodes = Nodes.Num();
+
+	int32 NumLinks = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Node = 0; Node < Nodes.Num(); Node++)
+	{
+		for (int32 Link = 0; Link < 4; Link++)
+		{
+			const int32 Neighbour = Nodes.Links[Node][Link];
+			NumLinks += Neighbour != INDEX_NONE && Nodes.Positions[Neighbour].Z >= Nodes.Positions[Node].Z;
+		}
+	}
+	const double WalkTime = FPlatformTime::Seconds() - StartTime;
+
+	TArray<FStalkerAIMapNodeHandle> Handles;
+	Handles.Reserve(Nodes.Num());
+	FRandomStream Random(3);
+	for (int32 Node = 0; Node < Nodes.Num(); Node++)
+	{
+		Handles.Add(Nodes.GetHandle(Node));
+		if (Random.FRand() < 0.2f)
+		{
+			AIMap->SelectNode(Node);
+		}
+	}
+	const int32 NumSelected = AIMap->GetCountSelected();
+	StartTime = FPlatformTime::Seconds();
+	AIMap->RemoveSelect();
+	const double RemoveTime = FPlatformTime::Seconds() - StartTime;
+
+	int32 NumResolved = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (const FStalkerAIMapNodeHandle& Handle : Handles)
+	{
+		NumResolved += Nodes.Resolve(Handle) != INDEX_NONE;
+	}
+	const double ResolveTime = FPlatformTime::Seconds() - StartTime;
+
+	TestEqual(TEXT("Removed count"), Nodes.Num(), NumNodes - NumSelected);
+	TestEqual(TEXT("Surviving handles resolve"), NumResolved, Nodes.Num());
+	AddInfo(FString::Printf(TEXT("%d nodes: create and link %.3f s, link walk %.2f ms (%d links), remove %d selected %.2f ms, resolve %.2f ms"),
+		NumNodes, CreateTime, WalkTime * 1000.0, NumLinks, NumSelected, RemoveTime * 1000.0, ResolveTime * 1000.0));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerAIMapSerializeBulkTest, "Stalker.AIMap.SerializeBulk", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStalkerAIMapSerializeBulkTest::RunTest(const FString& Parameters)
+{
+	UStalkerAIMap* AIMap = StalkerAIMapTest::CreateGrid(64, 64);
+	const FStalkerAIMapNodes& Nodes = AIMap->Nodes;
+	for (bool bCompress : { false, true })
+	{
+		FStalkerAIMapNodes Source = Nodes;
+		// Odd bit patterns must survive the delta encoding unchanged
+		Source.Positions[1].X = -0.f;
+		Source.Positions[2].Y = UE_BIG_NUMBER;
+		Source.Positions[3].Z = UE_SMALL_NUMBER;
+
+		TArray<uint8> Bytes;
+		FMemoryWriter Writer(Bytes);
+		Source.SerializeBulk(Writer, bCompress);
+
+		FStalkerAIMapNodes Loaded;
+		Loaded.SetNum(Source.Num());
+		FMemoryReader Reader(Bytes);
+		Loaded.SerializeBulk(Reader, bCompress);
+
+		const TCHAR* Mode = bCompress ? TEXT("compressed") : TEXT("raw");
+		TestFalse(FString::Printf(TEXT("Read error (%s)"), Mode), Reader.IsError());
+		TestEqual(FString::Printf(TEXT("Whole stream is read (%s)"), Mode), Reader.Tell(), int64(Bytes.Num()));
+		TestTrue(FString::Printf(TEXT("Positions are bit exact (%s)"), Mode), FMemory::Memcmp(Source.Positions.GetData(), Loaded.Positions.GetData(), Source.Positions.Num() * sizeof(FVector3f)) == 0);
+		TestTrue(FString::Printf(TEXT("Planes are bit exact (%s)"), Mode), FMemory::Memcmp(Source.Planes.GetData(), Loaded.Planes.GetData(), Source.Planes.Num() * sizeof(FPlane4f)) == 0);
+		TestTrue(FString::Printf(TEXT("Links match (%s)"), Mode), FMemory::Memcmp(Source.Links.GetData(), Loaded.Links.GetData(), Source.Links.Num() * sizeof(FStalkerAIMapNodeLinks)) == 0);
+		if (bCompress)
+		{
+			TestTrue(TEXT("Grid positions compress"), Bytes.Num() < Source.Num() * int32(sizeof(FVector3f) + sizeof(FPlane4f) + sizeof(FStalkerAIMapNodeLinks)));
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerAIMapSerializeBenchmark, "Stalker.AIMap.SerializeBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FStalkerAIMapSerializeBenchmark::RunTest(const FString& Parameters)
+{
+	UStalkerAIMap* AIMap = StalkerAIMapTest::CreateGrid(708, 708);
+	const FStalkerAIMapNodes& Nodes = AIMap->Nodes;
+
+	// Legacy per node records against the bulk blocks of version 2, raw and with compressed positions
+	for (int32 Format = 0; Format < 3; Format++)
+	{
+		const TCHAR* Name = Format == 0 ? TEXT("legacy") : Format == 1 ? TEXT("bulk") : TEXT("bulk compressed");
+		auto Serialize = [Format](FStalkerAIMapNodes& InNodes, FArchive& Ar)
+		{
+			if (Format == 0)
+			{
+				InNodes.SerializeLegacy(Ar);
+			}
+			else
+			{
+				InNodes.SerializeBulk(Ar, Format == 2);
+			}
+		};
+
+		FStalkerAIMapNodes Source = Nodes;
+		TArray<uint8> Bytes;
+		Bytes.Reserve(Nodes.Num() * 64);
+		FMemoryWriter Writer(Bytes);
+		double StartTime = FPlatformTime::Seconds();
+		Serialize(Source, Writer);
+		const double SaveTime = FPlatformTime::Seconds() - StartTime;
+
+		double LoadTime = DBL_MAX;
+		FStalkerAIMapNodes Loaded;
+		for (int32 Run = 0; Run < 3; Run++)
+		{
+			StartTime = FPlatformTime::Seconds();
+			Loaded.Reset();
+			Loaded.SetNum(Nodes.Num());
+			FMemoryReader Reader(Bytes);
+			Serialize(Loaded, Reader);
+			LoadTime = FMath::Min(LoadTime, FPlatformTime::Seconds() - StartTime);
+		}
+
+		TestTrue(FString::Printf(TEXT("Positions survive (%s)"), Name), FMemory::Memcmp(Nodes.Positions.GetData(), Loaded.Positions.GetData(), Nodes.Num() * sizeof(FVector3f)) == 0);
+		TestTrue(FString::Printf(TEXT("Links survive (%s)"), Name), FMemory::Memcmp(Nodes.Links.GetData(), Loaded.Links.GetData(), Nodes.Num() * sizeof(FStalkerAIMapNodeLinks)) == 0);
+		AddInfo(FString::Printf(TEXT("%d nodes %s: %.2f MB, save %.2f ms, load %.2f ms"), Nodes.Num(), Name, Bytes.Num() / (1024.0 * 1024.0), SaveTime * 1000.0, LoadTime * 1000.0));
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerAIMapSpatialIndexTest, "Stalker.AIMap.SpatialIndex", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStalkerAIMapSpatialIndexTest::RunTest(const FString& Parameters)
+{
+	constexpr float CellSize = 70.f;
+	FStalkerAIMapNodes Nodes;
+	FStalkerAIMapSpatialIndex Index;
+	Index.Reset(Nodes, CellSize);
+
+	// Stacked floors with close heights in a few cells
+	FRandomStream Random(5);
+	const float Heights[] = { -200.f, 0.f, 0.f, 35.f, 100.f, 101.f, 250.f, 400.f };
+	for (int32 x = -3; x <= 3; x++)
+	{
+		for (int32 y = -3; y <= 3; y++)
+		{
+			for (float Height : Heights)
+			{
+				if (Random.FRand() < 0.7f)
+				{
+					const FVector3f Position(x * CellSize, y * CellSize, Height + Random.FRandRange(-2.f, 2.f));
+					Index.Add(Nodes.Add(Position, FPlane4f(Position, FVector3f(0, 0, 1))));
+				}
+			}
+		}
+	}
+
+	// The nearest node inside the tolerance wins, ties go to the one below, the same cell rule holds for nodes and queries
+	auto FindExpected = [&Nodes, CellSize](const FVector3f& Position, float MaxDown, float MaxUp)
+	{
+		const int32 CellX = FMath::FloorToInt32(Position.X / CellSize + 1e-3f);
+		const int32 CellY = FMath::FloorToInt32(Position.Y / CellSize + 1e-3f);
+		int32 Best = INDEX_NONE;
+		float BestDistance = 0;
+		for (int32 Node = 0; Node < Nodes.Num(); Node++)
+		{
+			const FVector3f& NodePosition = Nodes.Positions[Node];
+			if (FMath::FloorToInt32(NodePosition.X / CellSize + 1e-3f) != CellX || FMath::FloorToInt32(NodePosition.Y / CellSize + 1e-3f) != CellY)
+			{
+				continue;
+			}
+			const float Delta = NodePosition.Z - Position.Z;
+			if (Delta > MaxUp || -Delta > MaxDown)
+			{
+				continue;
+			}
+			const float Distance = FMath::Abs(Delta);
+			if (Best == INDEX_NONE || Distance < BestDistance || (Distance == BestDistance && Delta < 0))
+			{
+				Best = Node;
+				BestDistance = Distance;
+			}
+		}
+		return Best;
+	};
+
+	int32 NumMismatched = 0;
+	for (int32 i = 0; i < 20000; i++)
+	{
+		const FVector3f Position(Random.FRandRange(-4.f, 4.f) * CellSize, Random.FRandRange(-4.f, 4.f) * CellSize, Random.FRandRange(-300.f, 500.f));
+		const float MaxDown = Random.FRandRange(0.f, 150.f);
+		const float MaxUp = Random.FRandRange(0.f, 150.f);
+		const int32 Expected = FindExpected(Position, MaxDown, MaxUp);
+		const int32 Found = Index.FindNearest(Position, MaxDown, MaxUp);
+		const bool bSame = Expected == INDEX_NONE ? Found == INDEX_NONE : Found != INDEX_NONE && Nodes.Positions[Found].Z == Nodes.Positions[Expected].Z;
+		if (!bSame && NumMismatched++ < 8)
+		{
+			AddError(FString::Printf(TEXT("Query %s (-%.1f +%.1f) found %d, brute force %d"), *Position.ToString(), MaxDown, MaxUp, Found, Expected));
+		}
+	}
+	TestEqual(TEXT("Index finds what brute force finds"), NumMismatched, 0);
+
+	// Grid positions that came out a rounding error short stay in their own cell, for nodes and for queries
+	const FVector3f Short(3.f * CellSize - 1e-4f, -2.f * CellSize - 1e-4f, 0.f);
+	Nodes.Reset();
+	Index.Reset(Nodes, CellSize);
+	const int32 ShortNode = Nodes.Add(Short, FPlane4f(Short, FVector3f(0, 0, 1)));
+	Index.Add(ShortNode);
+	TestEqual(TEXT("Short node is found from the grid position"), Index.FindNearest(FVector3f(3.f * CellSize, -2.f * CellSize, 0.f), 1.f, 1.f), ShortNode);
+	TestEqual(TEXT("Short node is found from inside its cell"), Index.FindNearest(FVector3f(3.5f * CellSize, -1.5f * CellSize, 0.f), 1.f, 1.f), ShortNode);
+	TestEqual(TEXT("Short node is not found from the cell below"), Index.FindNearest(FVector3f(2.5f * CellSize, -2.5f * CellSize, 0.f), 1.f, 1.f), int32(INDEX_NONE));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerAIMapSpatialIndexBenchmark, "Stalker.AIMap.SpatialIndexBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FStalkerAIMapSpatialIndexBenchmark::RunTest(const FString& Parameters)
+{
+	// 1M nodes: a 1000 x 1000 grid, every fourth cell with a second floor above it
+	constexpr float CellSize = 70.f;
+	FStalkerAIMapNodes Nodes;
+	Nodes.Reset(1000 * 1000 + 1000 * 1000 / 4);
+	for (int32 y = 0; y < 1000; y++)
+	{
+		for (int32 x = 0; x < 1000; x++)
+		{
+			const FVector3f Position(x * CellSize, y * CellSize, (x + y) % 5 * 10.f);
+			Nodes.Add(Position, FPlane4f(Position, FVector3f(0, 0, 1)));
+			if ((x & 1) == 0 && (y & 1) == 0)
+			{
+				const FVector3f Upper = Position + FVector3f(0, 0, 300.f);
+				Nodes.Add(Upper, FPlane4f(Upper, FVector3f(0, 0, 1)));
+			}
+		}
+	}
+
+	FStalkerAIMapSpatialIndex Index;
+	double StartTime = FPlatformTime::Seconds();
+	Index.Reset(Nodes, CellSize);
+	for (int32 Node = 0; Node < Nodes.Num(); Node++)
+	{
+		Index.Add(Node);
+	}
+	const double AddTime = FPlatformTime::Seconds() - StartTime;
+
+	StartTime = FPlatformTime::Seconds();
+	Index.Build(Nodes, CellSize);
+	const double BuildTime = FPlatformTime::Seconds() - StartTime;
+
+	int32 NumFound = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Node = 0; Node < Nodes.Num(); Node++)
+	{
+		NumFound += Index.FindNearest(Nodes.Positions[Node], 1.f, 1.f) == Node;
+	}
+	const double FindTime = FPlatformTime::Seconds() - StartTime;
+
+	int32 NumNeighbours = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Node = 0; Node < Nodes.Num(); Node++)
+	{
+		int32 Neighbours[4];
+		Index.FindNeighbours(Nodes.Positions[Node], 50.f, 50.f, Neighbours);
+		NumNeighbours += (Neighbours[0] != INDEX_NONE) + (Neighbours[1] != INDEX_NONE) + (Neighbours[2] != INDEX_NONE) + (Neighbours[3] != INDEX_NONE);
+	}
+	const double NeighboursTime = FPlatformTime::Seconds() - StartTime;
+
+	TestEqual(TEXT("Every node finds itself"), NumFound, Nodes.Num());
+	const double NanosecondsPerNode = 1e9 / Nodes.Num();
+	AddInfo(FString::Printf(TEXT("%d nodes: add %.1f ns, build %.1f ns, find %.1f ns, neighbours %.1f ns per node (%d links)"),
+		Nodes.Num(), AddTime * NanosecondsPerNode, BuildTime * NanosecondsPerNode, FindTime * NanosecondsPerNode, NeighboursTime * NanosecondsPerNode, NumNeighbours));
+	return true;
+}
+
+#endif
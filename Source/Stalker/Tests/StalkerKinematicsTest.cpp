@@ -0,0 +1,530 @@
+#include "Misc/AutomationTest.h"
+#include "Entities/Kinematics/StalkerKinematicsComponent.h"
+#include "Resources/SkeletonMesh/StalkerKinematicsData.h"
+#include "Resources/SkeletonMesh/StalkerKinematicsSharedData.h"
+#include "Resources/SkeletonMesh/StalkerKinematicsBonePickTree.h"
+#include "Kernel/XRay/Render/Resources/Visual/XRayKinematicsLegacy.h"
+#include "Kernel/Unreal/GameSettings/StalkerGameSettings.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/Skeleton.h"
+#include "Engine/SkeletalMesh.h"
+#include "ReferenceSkeleton.h"
+#if WITH_EDITOR
+#include "Animation/AnimData/IAnimationDataController.h"
+#endif
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace StalkerKinematicsTest
+{
+	UStalkerKinematicsData* CreateKinematicsData()
+	{
+		USkeletalMesh* Mesh = LoadObject<USkeletalMesh>(nullptr, TEXT("/Engine/EngineMeshes/SkeletalCube.SkeletalCube"));
+		if (!Mesh)
+		{
+			return nullptr;
+		}
+		UStalkerKinematicsData* KinematicsData = NewObject<UStalkerKinematicsData>(GetTransientPackage());
+		KinematicsData->Mesh = Mesh;
+		return KinematicsData;
+	}
+
+	UStalkerKinematicsComponent* CreateKinematics(UStalkerKinematicsData* KinematicsData)
+	{
+		UStalkerKinematicsComponent* Kinematics = NewObject<UStalkerKinematicsComponent>(GetTransientPackage(), NAME_None, RF_Transient);
+		Kinematics->Initilize(KinematicsData);
+		return Kinematics;
+	}
+
+	// One bone part and one empty sequence that plays both as a cycle and as an FX
+	MotionID AddEmptyMotion(UStalkerKinematicsComponent* Kinematics)
+	{
+		FStalkerKinematicsSharedData& SharedData = *Kinematics->SharedData;
+		SharedData.BonesParts.AddDefaulted();
+		SharedData.BonesPartsBoneID2ID.Add(0, 0);
+		SharedData.Anims.AddZeroed_GetRef().Amim = NewObject<UAnimSequence>(GetTransientPackage());
+		SharedData.AnimsDef.AddZeroed_GetRef().bone_or_part = 0;
+		MotionID Motion;
+		Motion.val = u16(SharedData.Anims.Num() - 1);
+		return Motion;
+	}
+
+#if WITH_EDITOR
+	// Bone chain skeleton with one raw sequence that keys every bone on every frame
+	UAnimSequence* CreateChainAnimation(int32 NumBones, int32 NumFrames)
+	{
+		USkeletalMesh* Mesh = NewObject<USkeletalMesh>(GetTransientPackage(), NAME_None, RF_Transient);
+		{
+			FReferenceSkeletonModifier Modifier(Mesh->GetRefSkeleton(), nullptr);
+			for (int32 BoneIndex = 0; BoneIndex < NumBones; BoneIndex++)
+			{
+				const FName BoneName(*FString::Printf(TEXT("bone_%03d"), BoneIndex));
+				Modifier.Add(FMeshBoneInfo(BoneName, BoneName.ToString(), BoneIndex - 1), FTransform(FVector(0.0, 0.0, 10.0)));
+			}
+		}
+		USkeleton* Skeleton = NewObject<USkeleton>(GetTransientPackage(), NAME_None, RF_Transient);
+		Skeleton->MergeAllBonesToBoneTree(Mesh);
+
+		UAnimSequence* Anim = NewObject<UAnimSequence>(GetTransientPackage(), NAME_None, RF_Transient);
+		Anim->SetSkeleton(Skeleton);
+		IAnimationDataController& Controller = Anim->GetController();
+		Controller.OpenBracket(FText::GetEmpty(), false);
+		Controller.ResetModel(false);
+		FRandomStream Random(11);
+		for (int32 BoneIndex = 0; BoneIndex < NumBones; BoneIndex++)
+		{
+			TArray<FVector> PosKeys;
+			TArray<FQuat> RotKeys;
+			TArray<FVector> ScaleKeys;
+			for (int32 Frame = 0; Frame < NumFrames; Frame++)
+			{
+				PosKeys.Add(FVector(Random.FRandRange(-1.f, 1.f), Random.FRandRange(-1.f, 1.f), 10.f));
+				RotKeys.Add(FQuat(FRotator(Random.FRandRange(-30.f, 30.f), Random.FRandRange(-30.f, 30.f), Random.FRandRange(-30.f, 30.f))));
+				ScaleKeys.Add(FVector::OneVector);
+			}
+			const FName BoneName = Skeleton->GetReferenceSkeleton().GetBoneName(BoneIndex);
+			Controller.AddBoneTrack(BoneName, false);
+			Controller.SetBoneTrackKeys(BoneName, PosKeys, RotKeys, ScaleKeys, false);
+		}
+		Controller.SetPlayLength(static_cast<float>(NumFrames - 1) / 30.f, false);
+		Controller.SetFrameRate(FFrameRate(30, 1), false);
+		Controller.NotifyPopulated();
+		Controller.CloseBracket(false);
+		return Anim;
+	}
+#endif
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerKinematicsSharedDataTest, "Stalker.Kinematics.SharedData", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStalkerKinematicsSharedDataTest::RunTest(const FString& Parameters)
+{
+	UStalkerKinematicsData* KinematicsData = StalkerKinematicsTest::CreateKinematicsData();
+	if (!TestNotNull(TEXT("Skeletal cube"), KinematicsData))
+	{
+		return false;
+	}
+
+	UStalkerKinematicsComponent* First = StalkerKinematicsTest::CreateKinematics(KinematicsData);
+	UStalkerKinematicsComponent* Second = StalkerKinematicsTest::CreateKinematics(KinematicsData);
+	TWeakPtr<FStalkerKinematicsSharedData> SharedData = First->SharedData;
+	TestTrue(TEXT("Components of one kinematics data share their tables"), First->SharedData == Second->SharedData);
+	TestEqual(TEXT("Bone count"), int32(First->LL_BoneCount()), KinematicsData->Mesh->GetRefSkeleton().GetNum());
+	TestEqual(TEXT("Root bone is found by name"), First->LL_BoneID(First->LL_BoneName_dbg(0)), u16(0));
+
+	// Boxes are handed out by mutable reference, a write must stay in its component
+	const Fobb Original = First->LL_GetBox(0);
+	First->LL_GetBox(0).m_halfsize.set(100.f, 100.f, 100.f);
+	TestTrue(TEXT("Box write does not reach other components"), Second->LL_GetBox(0).m_halfsize.similar(Original.m_halfsize));
+	TestTrue(TEXT("Box write does not reach the shared tables"), SharedData.Pin()->Bones[0].Obb.m_halfsize.similar(Original.m_halfsize));
+
+	First->Initilize(nullptr);
+	TestTrue(TEXT("Tables live while a component uses them"), SharedData.IsValid());
+	Second->Initilize(nullptr);
+	TestFalse(TEXT("Tables are freed with the last component"), SharedData.IsValid());
+
+	First->MarkAsGarbage();
+	Second->MarkAsGarbage();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerKinematicsBlendsPoolTest, "Stalker.Kinematics.BlendsPool", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStalkerKinematicsBlendsPoolTest::RunTest(const FString& Parameters)
+{
+	UStalkerKinematicsData* KinematicsData = StalkerKinematicsTest::CreateKinematicsData();
+	if (!TestNotNull(TEXT("Skeletal cube"), KinematicsData))
+	{
+		return false;
+	}
+	UStalkerKinematicsComponent* Kinematics = StalkerKinematicsTest::CreateKinematics(KinematicsData);
+
+	const MotionID Motion = StalkerKinematicsTest::AddEmptyMotion(Kinematics);
+
+	// Mixed cycles keep the previous blends, so the pool runs dry
+	for (int32 i = 0; i < MAX_BLENDED_POOL; i++)
+	{
+		if (!Kinematics->LL_PlayCycle(0, Motion, TRUE, 1.f, 1.f, 1.f, FALSE, nullptr, nullptr))
+		{
+			AddError(FString::Printf(TEXT("Cycle %d did not play"), i));
+			break;
+		}
+	}
+	AddExpectedError(TEXT("ran out of blends"), EAutomationExpectedErrorFlags::Contains, 2);
+	TestNull(TEXT("Cycle past the pool is skipped"), Kinematics->LL_PlayCycle(0, Motion, TRUE, 1.f, 1.f, 1.f, FALSE, nullptr, nullptr));
+	TestNull(TEXT("FX past the pool is skipped"), Kinematics->PlayFX(Motion, 1.f));
+	TestEqual(TEXT("Skipped blends are not tracked"), Kinematics->BlendsCycles[0].Num(), MAX_BLENDED_POOL);
+
+	Kinematics->LL_CloseCycle(0, 1 << 0);
+	TestNotNull(TEXT("FX plays once blends are freed"), Kinematics->PlayFX(Motion, 1.f));
+	TestNotNull(TEXT("Cycle plays once blends are freed"), Kinematics->LL_PlayCycle(0, Motion, FALSE, 1.f, 1.f, 1.f, FALSE, nullptr, nullptr));
+
+	Kinematics->Initilize(nullptr);
+	Kinematics->MarkAsGarbage();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerKinematicsPickBoneTest, "Stalker.Kinematics.PickBone", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStalkerKinematicsPickBoneTest::RunTest(const FString& Parameters)
+{
+	UStalkerKinematicsData* KinematicsData = StalkerKinematicsTest::CreateKinematicsData();
+	if (!TestNotNull(TEXT("Skeletal cube"), KinematicsData))
+	{
+		return false;
+	}
+	UStalkerKinematicsComponent* Kinematics = StalkerKinematicsTest::CreateKinematics(KinematicsData);
+	TestEqual(TEXT("Pick trees are not built on spawn"), Kinematics->SharedData->BonesPickTree.Num(), 0);
+
+	Fvector Center;
+	Kinematics->GetBox().getcenter(Center);
+	const float Radius = Kinematics->GetBox().getradius();
+	Fvector Start, Dir;
+	Start.set(Center).add(Fvector().set(Radius * 2.f, Radius * 0.1f, Radius * 0.1f));
+	Dir.sub(Center, Start).normalize();
+	Fmatrix Identity;
+	Identity.identity();
+
+	auto PickAny = [&](const Fvector& InStart, const Fvector& InDir, pick_result& Result)
+	{
+		for (u16 BoneID = 0; BoneID < Kinematics->LL_BoneCount(); BoneID++)
+		{
+			if (Kinematics->PickBone(Identity, Result, Radius * 4.f, InStart, InDir, BoneID))
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+	pick_result Result;
+	if (TestTrue(TEXT("Ray towards the cube hits a bone"), PickAny(Start, Dir, Result)))
+	{
+		TestTrue(TEXT("Hit lies between the start and the center"), Result.dist > 0.f && Result.dist < Start.distance_to(Center));
+	}
+	TestEqual(TEXT("Pick trees are built on the first pick"), Kinematics->SharedData->BonesPickTree.Num(), int32(Kinematics->LL_BoneCount()));
+	TestFalse(TEXT("Ray away from the cube misses"), PickAny(Start, Fvector().invert(Dir), Result));
+
+	Kinematics->Initilize(nullptr);
+	Kinematics->MarkAsGarbage();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerKinematicsPickBenchmark, "Stalker.Kinematics.PickBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FStalkerKinematicsPickBenchmark::RunTest(const FString& Parameters)
+{
+	UStalkerKinematicsData* KinematicsData = StalkerKinematicsTest::CreateKinematicsData();
+	if (!TestNotNull(TEXT("Skeletal cube"), KinematicsData))
+	{
+		return false;
+	}
+
+	// Crowd of 300 skeletal cubes on a grid, every ray is aimed at one of them as a hit query after the broad phase
+	const int32 NumInstances = 300;
+	const int32 NumRays = 200000;
+	TArray<UStalkerKinematicsComponent*> Crowd;
+	TArray<Fmatrix> Placements;
+	for (int32 i = 0; i < NumInstances; i++)
+	{
+		Crowd.Add(StalkerKinematicsTest::CreateKinematics(KinematicsData));
+		Placements.AddDefaulted_GetRef().translate(Fvector().set(float(i % 20) * 3.f, 0.f, float(i / 20) * 3.f));
+	}
+	Fvector Center;
+	Crowd[0]->GetBox().getcenter(Center);
+	const float Radius = Crowd[0]->GetBox().getradius();
+
+	FRandomStream Random(5);
+	TArray<TPair<Fvector, Fvector>> Rays;
+	TArray<int32> Targets;
+	for (int32 i = 0; i < NumRays; i++)
+	{
+		const int32 Target = Random.RandRange(0, NumInstances - 1);
+		Fvector Aim;
+		Placements[Target].transform_tiny(Aim, Fvector().set(Center).add(Fvector().set(Random.FRandRange(-Radius, Radius), Random.FRandRange(-Radius, Radius), Random.FRandRange(-Radius, Radius))));
+		const FVector Direction = Random.GetUnitVector();
+		const Fvector Start = Fvector().set(Aim).add(Fvector().set(float(Direction.X), float(Direction.Y), float(Direction.Z)).mul(Radius * 3.f));
+		Rays.Emplace(Start, Fvector().sub(Aim, Start).normalize());
+		Targets.Add(Target);
+	}
+
+	int32 NumHits = 0;
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumRays; i++)
+	{
+		UStalkerKinematicsComponent* Kinematics = Crowd[Targets[i]];
+		pick_result Result;
+		for (u16 BoneID = 0; BoneID < Kinematics->LL_BoneCount(); BoneID++)
+		{
+			if (Kinematics->PickBone(Placements[Targets[i]], Result, Radius * 6.f, Rays[i].Key, Rays[i].Value, BoneID))
+			{
+				NumHits++;
+				break;
+			}
+		}
+	}
+	const double CrowdTime = FPlatformTime::Seconds() - StartTime;
+	TestTrue(TEXT("Rays aimed inside the cubes hit"), NumHits > 0);
+
+	// One dense bone, a sphere of 20k triangles, against the brute force over all of its triangles
+	TArray<Fvector> Vertices;
+	const int32 Rings = 80;
+	const int32 Segments = 128;
+	auto SpherePoint = [](int32 Ring, int32 Segment)
+	{
+		const float Theta = PI * float(Ring) / float(Rings);
+		const float Phi = 2.f * PI * float(Segment) / float(Segments);
+		return Fvector().set(FMath::Sin(Theta) * FMath::Cos(Phi), FMath::Cos(Theta), FMath::Sin(Theta) * FMath::Sin(Phi));
+	};
+	for (int32 Ring = 0; Ring < Rings; Ring++)
+	{
+		for (int32 Segment = 0; Segment < Segments; Segment++)
+		{
+			const Fvector A = SpherePoint(Ring, Segment), B = SpherePoint(Ring + 1, Segment), C = SpherePoint(Ring + 1, Segment + 1), D = SpherePoint(Ring, Segment + 1);
+			Vertices.Append({ A, B, C, A, C, D });
+		}
+	}
+	TArray<Fvector> TreeVertices = Vertices;
+	FStalkerKinematicsBonePickTree PickTree;
+	PickTree.Build(TreeVertices);
+	const int32 NumDenseRays = 2000;
+	TArray<TPair<Fvector, Fvector>> DenseRays;
+	for (int32 i = 0; i < NumDenseRays; i++)
+	{
+		const FVector Direction = Random.GetUnitVector();
+		const Fvector Start = Fvector().set(float(Direction.X), float(Direction.Y), float(Direction.Z)).mul(3.f);
+		const Fvector Aim = Fvector().set(Random.FRandRange(-0.5f, 0.5f), Random.FRandRange(-0.5f, 0.5f), Random.FRandRange(-0.5f, 0.5f));
+		DenseRays.Emplace(Start, Fvector().sub(Aim, Start).normalize());
+	}
+
+	TArray<float> TreeRanges;
+	StartTime = FPlatformTime::Seconds();
+	for (const TPair<Fvector, Fvector>& Ray : DenseRays)
+	{
+		float Range = 10.f;
+		u32 Triangle;
+		TreeRanges.Add(PickTree.Pick(Ray.Key, Ray.Value, Range, Triangle) ? Range : -1.f);
+	}
+	const double TreeTime = FPlatformTime::Seconds() - StartTime;
+
+	int32 NumMismatches = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumDenseRays; i++)
+	{
+		float Best = 10.f;
+		bool bHit = false;
+		for (int32 Vertex = 0; Vertex < Vertices.Num(); Vertex += 3)
+		{
+			float U, V, Range;
+			if (CDB::TestRayTri(DenseRays[i].Key, DenseRays[i].Value, &Vertices[Vertex], U, V, Range, false) && Range > 0 && Range < Best)
+			{
+				Best = Range;
+				bHit = true;
+			}
+		}
+		NumMismatches += FMath::Abs((bHit ? Best : -1.f) - TreeRanges[i]) > 1e-4f;
+	}
+	const double BruteTime = FPlatformTime::Seconds() - StartTime;
+	TestEqual(TEXT("Tree and brute force agree"), NumMismatches, 0);
+
+	AddInfo(FString::Printf(TEXT("Crowd of %d skeletal cubes: %.0f rays/s (%d of %d hit)"), NumInstances, NumRays / FMath::Max(CrowdTime, 1e-9), NumHits, NumRays));
+	AddInfo(FString::Printf(TEXT("%d triangle bone: tree %.0f rays/s, brute force %.0f rays/s"), Vertices.Num() / 3, NumDenseRays / FMath::Max(TreeTime, 1e-9), NumDenseRays / FMath::Max(BruteTime, 1e-9)));
+
+	for (UStalkerKinematicsComponent* Kinematics : Crowd)
+	{
+		Kinematics->Initilize(nullptr);
+		Kinematics->MarkAsGarbage();
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerKinematicsLegacyVisiboxTest, "Stalker.Kinematics.LegacyVisibox", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStalkerKinematicsLegacyVisiboxTest::RunTest(const FString& Parameters)
+{
+	// Rotated and offset bone boxes, compared against the eight transformed corners the legacy update used
+	FRandomStream Random(23);
+	for (int32 i = 0; i < 256; i++)
+	{
+		Fmatrix Bone, Box;
+		Bone.setHPB(Random.FRandRange(-PI, PI), Random.FRandRange(-PI, PI), Random.FRandRange(-PI, PI));
+		Bone.c.set(Random.FRandRange(-10.f, 10.f), Random.FRandRange(-10.f, 10.f), Random.FRandRange(-10.f, 10.f));
+		Box.setHPB(Random.FRandRange(-PI, PI), Random.FRandRange(-PI, PI), Random.FRandRange(-PI, PI));
+		Box.c.set(Random.FRandRange(-1.f, 1.f), Random.FRandRange(-1.f, 1.f), Random.FRandRange(-1.f, 1.f));
+		const Fvector S = Fvector().set(Random.FRandRange(0.01f, 2.f), Random.FRandRange(0.01f, 2.f), Random.FRandRange(0.01f, 2.f));
+
+		Fmatrix X;
+		X.mul_43(Bone, Box);
+		Fbox Expected;
+		Expected.invalidate();
+		for (int32 Corner = 0; Corner < 8; Corner++)
+		{
+			Fvector P;
+			X.transform_tiny(P, Fvector().set(Corner & 1 ? S.x : -S.x, Corner & 2 ? S.y : -S.y, Corner & 4 ? S.z : -S.z));
+			Expected.modify(P);
+		}
+
+		Fmatrix Scaled = Box;
+		Scaled.i.mul(S.x);
+		Scaled.j.mul(S.y);
+		Scaled.k.mul(S.z);
+		X.mul_43(Bone, Scaled);
+		Fbox Result;
+		Result.invalidate();
+		XRayKinematicsLegacy::Visibox_Modify(Result, X);
+
+		if (!Result.min.similar(Expected.min, 1e-3f) || !Result.max.similar(Expected.max, 1e-3f))
+		{
+			AddError(FString::Printf(TEXT("Box %d differs from the corner box"), i));
+			break;
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerKinematicsReuseTest, "Stalker.Kinematics.Reuse", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStalkerKinematicsReuseTest::RunTest(const FString& Parameters)
+{
+	UStalkerKinematicsData* KinematicsData = StalkerKinematicsTest::CreateKinematicsData();
+	if (!TestNotNull(TEXT("Skeletal cube"), KinematicsData))
+	{
+		return false;
+	}
+	UStalkerKinematicsComponent* Kinematics = StalkerKinematicsTest::CreateKinematics(KinematicsData);
+	const MotionID Motion = StalkerKinematicsTest::AddEmptyMotion(Kinematics);
+	const EVisibilityBasedAnimTickOption TickOption = Kinematics->VisibilityBasedAnimTickOption;
+	const Fobb Original = Kinematics->LL_GetBox(0);
+
+	// Leave behind everything a despawned object can: blends, a hidden bone, a written box, the compute instance and a skipped pose
+	TestNotNull(TEXT("Cycle plays"), Kinematics->LL_PlayCycle(0, Motion, FALSE, 1.f, 1.f, 1.f, FALSE, nullptr, nullptr));
+	TestNotNull(TEXT("FX plays"), Kinematics->PlayFX(Motion, 1.f));
+	Kinematics->LL_SetBoneVisible(0, FALSE, FALSE);
+	Kinematics->LL_GetBox(0).m_halfsize.set(100.f, 100.f, 100.f);
+	TestNotNull(TEXT("Compute instance is created"), Kinematics->GetKinematicsAnimInstanceForCompute());
+	UStalkerGameSettings* GameSettings = GetMutableDefault<UStalkerGameSettings>();
+	const bool SkipHiddenKinematicsPose = GameSettings->SkipHiddenKinematicsPose;
+	GameSettings->SkipHiddenKinematicsPose = true;
+	Kinematics->UpdateHiddenPoseSkip();
+	GameSettings->SkipHiddenKinematicsPose = SkipHiddenKinematicsPose;
+	TestTrue(TEXT("Pose is skipped while hidden"), Kinematics->bHiddenPoseSkipped);
+
+	Kinematics->ResetForReuse();
+	TestEqual(TEXT("Cycles are stopped"), Kinematics->BlendsCycles[0].Num(), 0);
+	TestEqual(TEXT("FX are stopped"), Kinematics->BlendsFX[0].Num(), 0);
+	TestTrue(TEXT("Bones are visible again"), !!Kinematics->LL_GetBoneVisible(0));
+	TestTrue(TEXT("Box is taken from the shared tables again"), Kinematics->LL_GetBox(0).m_halfsize.similar(Original.m_halfsize));
+	TestNull(TEXT("Anim script instance is cleared"), Kinematics->GetAnimInstance());
+	TestNull(TEXT("Compute instance is released"), Kinematics->KinematicsAnimInstanceForCompute);
+	TestFalse(TEXT("Skipped pose is restored"), Kinematics->bHiddenPoseSkipped);
+	TestTrue(TEXT("Tick option is restored"), Kinematics->VisibilityBasedAnimTickOption == TickOption);
+
+	Kinematics->Initilize(nullptr);
+	Kinematics->MarkAsGarbage();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerKinematicsHiddenPoseSkipTest, "Stalker.Kinematics.HiddenPoseSkip", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStalkerKinematicsHiddenPoseSkipTest::RunTest(const FString& Parameters)
+{
+	UStalkerKinematicsData* KinematicsData = StalkerKinematicsTest::CreateKinematicsData();
+	if (!TestNotNull(TEXT("Skeletal cube"), KinematicsData))
+	{
+		return false;
+	}
+	UStalkerKinematicsComponent* Kinematics = StalkerKinematicsTest::CreateKinematics(KinematicsData);
+	const EVisibilityBasedAnimTickOption TickOption = Kinematics->VisibilityBasedAnimTickOption;
+	UStalkerGameSettings* GameSettings = GetMutableDefault<UStalkerGameSettings>();
+	const bool SkipHiddenKinematicsPose = GameSettings->SkipHiddenKinematicsPose;
+	GameSettings->SkipHiddenKinematicsPose = true;
+
+	Kinematics->UpdateHiddenPoseSkip();
+	TestTrue(TEXT("Pose without consumers is skipped"), Kinematics->bHiddenPoseSkipped);
+	TestFalse(TEXT("Bone callbacks are not recounted before a bone instance is handed out"), Kinematics->bBoneCallbacksDirty);
+
+	Kinematics->LL_GetTransform(0);
+	TestFalse(TEXT("A game side read evaluates the skipped pose"), Kinematics->bHiddenPoseSkipped);
+	TestTrue(TEXT("Tick option is restored by the read"), Kinematics->VisibilityBasedAnimTickOption == TickOption);
+	Kinematics->UpdateHiddenPoseSkip();
+	TestFalse(TEXT("A recent read keeps the pose evaluated"), Kinematics->bHiddenPoseSkipped);
+
+	Kinematics->LL_GetBoneInstance(0);
+	TestTrue(TEXT("Handing out a bone instance marks the callbacks for a recount"), Kinematics->bBoneCallbacksDirty);
+	Kinematics->PoseReadFrame = MAX_uint64;
+	Kinematics->UpdateHiddenPoseSkip();
+	TestFalse(TEXT("Callbacks are recounted"), Kinematics->bBoneCallbacksDirty);
+	TestEqual(TEXT("No bone callbacks"), Kinematics->BoneCallbackCount, 0);
+	TestTrue(TEXT("Pose is skipped once the reads stop"), Kinematics->bHiddenPoseSkipped);
+
+	GameSettings->SkipHiddenKinematicsPose = SkipHiddenKinematicsPose;
+	Kinematics->UpdateHiddenPoseSkip();
+	TestTrue(TEXT("Tick option is restored with the setting"), Kinematics->VisibilityBasedAnimTickOption == TickOption);
+	Kinematics->Initilize(nullptr);
+	Kinematics->MarkAsGarbage();
+	return true;
+}
+
+#if WITH_EDITOR
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerKinematicsFXBenchmark, "Stalker.Kinematics.FXBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FStalkerKinematicsFXBenchmark::RunTest(const FString& Parameters)
+{
+	// 30 NPCs with two hit reactions each on a 64 bone skeleton, every FX drives one bone in the middle of the chain
+	const int32 NumBones = 64;
+	const int32 NumFX = 30 * 2;
+	const int32 NumFrames = 200;
+	UAnimSequence* Anim = StalkerKinematicsTest::CreateChainAnimation(NumBones, 31);
+	USkeleton* Skeleton = Anim->GetSkeleton();
+	TArray<FBoneIndexType> RequiredBones;
+	for (int32 BoneIndex = 0; BoneIndex < NumBones; BoneIndex++)
+	{
+		RequiredBones.Add(FBoneIndexType(BoneIndex));
+	}
+	FBoneContainer BoneContainer(RequiredBones, FCurveEvaluationOption(false), *Skeleton);
+	BoneContainer.SetUseRAWData(true);
+	const FCompactPoseBoneIndex BoneIndex(NumBones / 2);
+	const int32 SkeletonBoneIndex = BoneContainer.GetSkeletonIndex(BoneIndex);
+	auto FXTime = [&Anim](int32 Frame, int32 FX)
+	{
+		return FMath::Fmod(0.013f * (Frame + FX * 7), Anim->GetPlayLength());
+	};
+
+	// Previous path: a whole pose is extracted for every FX and one bone is read from it
+	FTransform FullResult = FTransform::Identity;
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		for (int32 FX = 0; FX < NumFX; FX++)
+		{
+			FCompactPose Pose;
+			FBlendedCurve Curve;
+			UE::Anim::FStackAttributeContainer Attributes;
+			Pose.SetBoneContainer(&BoneContainer);
+			Curve.InitFrom(BoneContainer);
+			FAnimationPoseData AnimationPoseData(Pose, Curve, Attributes);
+			Anim->GetAnimationPose(AnimationPoseData, FAnimExtractContext(FXTime(Frame, FX), false, FDeltaTimeRecord(), false));
+			FullResult = Pose[BoneIndex];
+		}
+	}
+	const double FullTime = FPlatformTime::Seconds() - StartTime;
+
+	// Single bone path of Evaluate_BoneInBlend
+	FTransform BoneResult = FTransform::Identity;
+	StartTime = FPlatformTime::Seconds();
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		for (int32 FX = 0; FX < NumFX; FX++)
+		{
+			Anim->GetBoneTransform(BoneResult, FSkeletonPoseBoneIndex(SkeletonBoneIndex), FXTime(Frame, FX), BoneContainer.ShouldUseRawData());
+		}
+	}
+	const double BoneTime = FPlatformTime::Seconds() - StartTime;
+
+	TestTrue(TEXT("Both paths sample the same bone transform"), FullResult.Equals(BoneResult, 1e-3));
+	AddInfo(FString::Printf(TEXT("%d FX on %d bones, per frame: full pose %.3f ms, single bone %.3f ms (x%.1f)"),
+		NumFX, NumBones, FullTime * 1000.0 / NumFrames, BoneTime * 1000.0 / NumFrames, FullTime / FMath::Max(BoneTime, 1e-9)));
+	return true;
+}
+#endif
+
+#endif
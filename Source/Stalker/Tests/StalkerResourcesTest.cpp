@@ -0,0 +1,205 @@
+#include "Misc/AutomationTest.h"
+#include "Resources/StalkerResourcesManager.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Entities/Kinematics/StalkerKinematicsComponent.h"
+#include "Resources/SkeletonMesh/StalkerKinematicsData.h"
+#include "Kernel/Unreal/GameSettings/StalkerGameSettings.h"
+#include "Engine/SkeletalMesh.h"
+#include "UObject/UObjectArray.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerResourcesResolvedPathsTest, "Stalker.Resources.ResolvedPaths", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStalkerResourcesResolvedPathsTest::RunTest(const FString& Parameters)
+{
+	FStalkerResourcesManager ResourcesManager;
+	TMap<FString, FString>& ResolvedPaths = ResourcesManager.ResolvedMaterialPaths;
+	const FString FoundPath = TEXT("/Engine/BasicShapes/Cube.Cube");
+	int32 Probes = 0;
+	auto GetPaths = [&Probes, &FoundPath](TArray<FString>& OutPaths)
+	{
+		Probes++;
+		OutPaths.Add(TEXT("/Game/StalkerResourcesTest/Cube.Cube"));
+		OutPaths.Add(FoundPath);
+	};
+	auto GetMissingPaths = [&Probes](TArray<FString>& OutPaths)
+	{
+		Probes++;
+		OutPaths.Add(TEXT("/Game/StalkerResourcesTest/Missing.Missing"));
+	};
+
+	// The first lookup probes the candidates, the later ones go straight to the path it found
+	UObject* Found = ResourcesManager.LoadResolved(UStaticMesh::StaticClass(), ResolvedPaths, TEXT("cube"), GetPaths);
+	if (!TestNotNull(TEXT("Second candidate is loaded"), Found))
+	{
+		return false;
+	}
+	TestEqual(TEXT("Found path is cached"), ResolvedPaths.FindRef(TEXT("cube")), FoundPath);
+	TestTrue(TEXT("Cached lookup returns the same object"), ResourcesManager.LoadResolved(UStaticMesh::StaticClass(), ResolvedPaths, TEXT("cube"), GetPaths) == Found);
+	TestEqual(TEXT("Cached lookup does not probe"), Probes, 1);
+
+	// Misses are remembered once the registry has finished scanning
+	Probes = 0;
+	TestNull(TEXT("Missing name resolves to nothing"), ResourcesManager.LoadResolved(UStaticMesh::StaticClass(), ResolvedPaths, TEXT("missing"), GetMissingPaths));
+	TestNull(TEXT("Missing name resolves to nothing again"), ResourcesManager.LoadResolved(UStaticMesh::StaticClass(), ResolvedPaths, TEXT("missing"), GetMissingPaths));
+	if (!FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get().IsLoadingAssets())
+	{
+		TestTrue(TEXT("Miss is cached as an empty path"), ResolvedPaths.Contains(TEXT("missing")) && ResolvedPaths[TEXT("missing")].IsEmpty());
+		TestEqual(TEXT("Cached miss does not probe"), Probes, 1);
+	}
+
+	// A cached path that no longer loads is dropped and probed again
+	ResolvedPaths.Add(TEXT("cube"), TEXT("/Game/StalkerResourcesTest/Stale.Stale"));
+	Probes = 0;
+	TestTrue(TEXT("Stale path falls back to the candidates"), ResourcesManager.LoadResolved(UStaticMesh::StaticClass(), ResolvedPaths, TEXT("cube"), GetPaths) == Found);
+	TestEqual(TEXT("Stale path is replaced"), ResolvedPaths.FindRef(TEXT("cube")), FoundPath);
+	TestEqual(TEXT("Stale path probes once"), Probes, 1);
+
+	ResourcesManager.ResetResolvedPaths();
+	TestEqual(TEXT("Reset forgets resolved paths"), ResolvedPaths.Num(), 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerResourcesResolvedPathsBenchmark, "Stalker.Resources.ResolvedPathsBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FStalkerResourcesResolvedPathsBenchmark::RunTest(const FString& Parameters)
+{
+	// 10k legacy names, half of them found in the last content path as GetContentPaths orders them, half found nowhere
+	const int32 NumNames = 10000;
+	const TCHAR* Assets[] = { TEXT("Cube"), TEXT("Sphere"), TEXT("Cylinder"), TEXT("Cone"), TEXT("Plane") };
+	TArray<FString> Names;
+	for (int32 i = 0; i < NumNames; i++)
+	{
+		Names.Add(FString::Printf(TEXT("%s_%05d"), i % 2 ? TEXT("missing") : Assets[(i / 2) % UE_ARRAY_COUNT(Assets)], i));
+	}
+	auto GetPaths = [&Names, &Assets](int32 Index, TArray<FString>& OutPaths)
+	{
+		for (const TCHAR* Folder : { TEXT("COP"), TEXT("CS"), TEXT("SHOC") })
+		{
+			OutPaths.Add(FString::Printf(TEXT("/Game/%s/StalkerResourcesTest/%s.%s"), Folder, *Names[Index], *Names[Index]));
+		}
+		if (Index % 2 == 0)
+		{
+			const TCHAR* Asset = Assets[(Index / 2) % UE_ARRAY_COUNT(Assets)];
+			OutPaths.Add(FString::Printf(TEXT("/Engine/BasicShapes/%s.%s"), Asset, Asset));
+		}
+		else
+		{
+			OutPaths.Add(FString::Printf(TEXT("/Game/Base/StalkerResourcesTest/%s.%s"), *Names[Index], *Names[Index]));
+		}
+	};
+
+	// Previous lookup: every candidate is handed to the loader until one loads
+	int32 NumFound = 0;
+	double StartTime = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumNames; i++)
+	{
+		TArray<FString> Paths;
+		GetPaths(i, Paths);
+		for (const FString& ObjectPath : Paths)
+		{
+			if (IsValid(StaticLoadObject(UStaticMesh::StaticClass(), nullptr, *ObjectPath, nullptr, LOAD_NoWarn)))
+			{
+				NumFound++;
+				break;
+			}
+		}
+	}
+	const double ProbeTime = FPlatformTime::Seconds() - StartTime;
+
+	FStalkerResourcesManager ResourcesManager;
+	TMap<FString, FString>& ResolvedPaths = ResourcesManager.ResolvedMaterialPaths;
+	auto Resolve = [&]()
+	{
+		int32 Result = 0;
+		for (int32 i = 0; i < NumNames; i++)
+		{
+			Result += ResourcesManager.LoadResolved(UStaticMesh::StaticClass(), ResolvedPaths, Names[i], [&GetPaths, i](TArray<FString>& OutPaths) { GetPaths(i, OutPaths); }) != nullptr;
+		}
+		return Result;
+	};
+	StartTime = FPlatformTime::Seconds();
+	const int32 NumFoundCold = Resolve();
+	const double ColdTime = FPlatformTime::Seconds() - StartTime;
+	StartTime = FPlatformTime::Seconds();
+	const int32 NumFoundWarm = Resolve();
+	const double WarmTime = FPlatformTime::Seconds() - StartTime;
+
+	TestEqual(TEXT("Cold cache finds what the probes found"), NumFoundCold, NumFound);
+	TestEqual(TEXT("Warm cache finds what the probes found"), NumFoundWarm, NumFound);
+	TestEqual(TEXT("Half of the names exist"), NumFound, NumNames / 2);
+	AddInfo(FString::Printf(TEXT("%d names (%d found): probing %.2f ms, cold cache %.2f ms, warm cache %.2f ms (%d cached)"),
+		NumNames, NumFound, ProbeTime * 1000.0, ColdTime * 1000.0, WarmTime * 1000.0, ResolvedPaths.Num()));
+	ResourcesManager.ResetResolvedPaths();
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerResourcesKinematicsChurnBenchmark, "Stalker.Resources.KinematicsChurnBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FStalkerResourcesKinematicsChurnBenchmark::RunTest(const FString& Parameters)
+{
+	USkeletalMesh* Mesh = LoadObject<USkeletalMesh>(nullptr, TEXT("/Engine/EngineMeshes/SkeletalCube.SkeletalCube"));
+	if (!TestNotNull(TEXT("Skeletal cube"), Mesh))
+	{
+		return false;
+	}
+	UStalkerKinematicsData* KinematicsData = NewObject<UStalkerKinematicsData>(GetTransientPackage());
+	KinematicsData->Mesh = Mesh;
+
+	FStalkerResourcesManager ResourcesManager;
+	UStalkerGameSettings* GameSettings = GetMutableDefault<UStalkerGameSettings>();
+	const int32 KinematicsPoolSize = GameSettings->KinematicsPoolSize;
+
+	// Corpses and items coming and going: 200 waves of 16 spawns, every one despawned before the next wave
+	const int32 NumWaves = 200;
+	const int32 NumPerWave = 16;
+	auto Churn = [&](int32 PoolSize, int32& OutObjects, double& OutChurnTime, double& OutGCTime)
+	{
+		GameSettings->KinematicsPoolSize = PoolSize;
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		const int32 StartObjects = GUObjectArray.GetObjectArrayNumMinusAvailable();
+		double StartTime = FPlatformTime::Seconds();
+		TArray<UStalkerKinematicsComponent*> Wave;
+		for (int32 i = 0; i < NumWaves; i++)
+		{
+			for (int32 j = 0; j < NumPerWave; j++)
+			{
+				Wave.Add(ResourcesManager.CreateKinematics(KinematicsData));
+			}
+			for (UStalkerKinematicsComponent* Kinematics : Wave)
+			{
+				ResourcesManager.Destroy(Kinematics);
+			}
+			Wave.Reset();
+		}
+		OutChurnTime = FPlatformTime::Seconds() - StartTime;
+		OutObjects = GUObjectArray.GetObjectArrayNumMinusAvailable() - StartObjects;
+		StartTime = FPlatformTime::Seconds();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		OutGCTime = FPlatformTime::Seconds() - StartTime;
+	};
+
+	int32 ObjectsOff, ObjectsOn;
+	double ChurnTimeOff, ChurnTimeOn, GCTimeOff, GCTimeOn;
+	Churn(0, ObjectsOff, ChurnTimeOff, GCTimeOff);
+	TestEqual(TEXT("Nothing is pooled with the pool off"), ResourcesManager.KinematicsPoolNum, 0);
+	Churn(NumPerWave, ObjectsOn, ChurnTimeOn, GCTimeOn);
+	TestEqual(TEXT("One wave stays pooled"), ResourcesManager.KinematicsPoolNum, NumPerWave);
+	TestTrue(TEXT("Pooling allocates fewer objects"), ObjectsOn < ObjectsOff);
+
+	// Locked or owned components are not handed out again
+	UStalkerKinematicsComponent* Locked = ResourcesManager.CreateKinematics(KinematicsData);
+	Locked->Lock(this);
+	ResourcesManager.Destroy(Locked);
+	TestEqual(TEXT("Locked component is not pooled"), ResourcesManager.KinematicsPoolNum, NumPerWave);
+	Locked->Unlock(this);
+
+	GameSettings->KinematicsPoolSize = KinematicsPoolSize;
+	ResourcesManager.TrimKinematicsPool();
+	AddInfo(FString::Printf(TEXT("%d spawns: pool off %d objects, churn %.2f ms, GC %.2f ms; pool on %d objects, churn %.2f ms, GC %.2f ms"),
+		NumWaves * NumPerWave, ObjectsOff, ChurnTimeOff * 1000.0, GCTimeOff * 1000.0, ObjectsOn, ChurnTimeOn * 1000.0, GCTimeOn * 1000.0));
+	return true;
+}
+
+#endif
@@ -72,7 +72,7 @@ FPrimitiveSceneProxy* UStalkerAIMapEditorRenderComponent::CreateSceneProxy()
 
 			const float NodeSize = (StalkerAIMap->NodeSize * 0.9f) * 0.5f;
 
-			auto DrawNode = [this, NodeToUV, StalkerWorldSettings, NodeSize, &CountNode](FDynamicMeshBuilder& MeshBuilder, FPlane4f& NodePlane, int32 Node, float x, float y, float z, bool IsSelected)
+			auto DrawNode = [this, NodeToUV, StalkerWorldSettings, NodeSize, &CountNode](FDynamicMeshBuilder& MeshBuilder, const FPlane4f& NodePlane, int32 Node, float x, float y, float z, bool IsSelected)
 			{
 				const FVector3f PlaneNormalRender = FVector3f(0, 0, 1);
 				FVector3f Vertex1 = FMath::RayPlaneIntersection(FVector3f(x - NodeSize, y - NodeSize, z), PlaneNormalRender, NodePlane);
@@ -103,30 +103,33 @@ FPrimitiveSceneProxy* UStalkerAIMapEditorRenderComponent::CreateSceneProxy()
 					MeshBuilder.ReserveTriangles(70 * 70 * 2);
 					MeshBuilder.ReserveVertices(70 * 70 * 4);
 					FMeshBatch Mesh;
-					for (FStalkerAIMapNode* Node : StalkerAIMap->Nodes)
+					const FStalkerAIMapNodes& Nodes = StalkerAIMap->Nodes;
+					for (int32 Node = 0; Node < Nodes.Num(); Node++)
 					{
+						const FVector3f& Position = Nodes.Positions[Node];
+						if (FVector::DistXY(View->ViewLocation, FVector(Position)) >= DistanceRenderAIMap * 100.0)
+						{
+							continue;
+						}
+						const FStalkerAIMapNodeLinks& Links = Nodes.Links[Node];
 						int32 NodeLink = 0;
-						if (Node->NodeLeft)
+						if (Links[0] != INDEX_NONE)
 						{
 							NodeLink |= 1 << 2;
 						}
-						if (Node->NodeForward)
+						if (Links[1] != INDEX_NONE)
 						{
 							NodeLink |= 1 << 3;
 						}
-						if (Node->NodeRight)
+						if (Links[2] != INDEX_NONE)
 						{
 							NodeLink |= 1 << 0;
 						}
-						if (Node->NodeBackward)
+						if (Links[3] != INDEX_NONE)
 						{
 							NodeLink |= 1 << 1;
 						}
-						if (FVector::DistXY(View->ViewLocation, FVector(Node->Position)) < DistanceRenderAIMap * 100.0)
-						{
-							DrawNode(MeshBuilder, Node->Plane, NodeLink, Node->Position.X, Node->Position.Y, Node->Position.Z, EnumHasAnyFlags(Node->Flags, EStalkerAIMapNodeFlags::Selected));
-						}
-
+						DrawNode(MeshBuilder, Nodes.Planes[Node], NodeLink, Position.X, Position.Y, Position.Z, Nodes.IsSelected(Node));
 					}
 					MeshBuilder.GetMesh(FMatrix::Identity, StalkerWorldSettings->EditorMaterialAIMap->GetRenderProxy(), SDPG_World, true, false, ViewIndex, Collector);
 				}
@@ -417,26 +417,24 @@ bool XRayLevelFactory::ImportLevel(const FString& FileName,UXRayLevelImportOptio
 				INAIMap->ClearAIMap();
 				if (AIMapTool)
 				{
-					INAIMap->Nodes.AddDefaulted(AIMapTool->m_Nodes.size());
+					FStalkerAIMapNodes& Nodes = INAIMap->Nodes;
+					Nodes.SetNum(AIMapTool->m_Nodes.size());
 					for (int32 i = 0; i < AIMapTool->m_Nodes.size(); i++)
 					{
-						INAIMap->Nodes[i] = new FStalkerAIMapNode;
-					}
-					for (int32 i = 0; i < AIMapTool->m_Nodes.size(); i++)
-					{
-						INAIMap->Nodes[i]->Position = StalkerMath::XRayLocationToUnreal(AIMapTool->m_Nodes[i]->Pos);
-						INAIMap->Nodes[i]->Position.X = INAIMap->NodeSize * FMath::RoundToDouble(INAIMap->Nodes[i]->Position.X / INAIMap->NodeSize);
-						INAIMap->Nodes[i]->Position.Y = INAIMap->NodeSize * FMath::RoundToDouble(INAIMap->Nodes[i]->Position.Y / INAIMap->NodeSize);
+						FVector3f& Position = Nodes.Positions[i];
+						Position = StalkerMath::XRayLocationToUnreal(AIMapTool->m_Nodes[i]->Pos);
+						Position.X = INAIMap->NodeSize * FMath::RoundToDouble(Position.X / INAIMap->NodeSize);
+						Position.Y = INAIMap->NodeSize * FMath::RoundToDouble(Position.Y / INAIMap->NodeSize);
 						FVector3f PlaneNormal = StalkerMath::XRayNormalToUnreal(AIMapTool->m_Nodes[i]->Plane.n);
-						INAIMap->Nodes[i]->Plane.X = PlaneNormal.X;
-						INAIMap->Nodes[i]->Plane.Y = PlaneNormal.Y;
-						INAIMap->Nodes[i]->Plane.Z = PlaneNormal.Z;
-						INAIMap->Nodes[i]->Plane.W = -AIMapTool->m_Nodes[i]->Plane.d * 100.f;
+						Nodes.Planes[i].X = PlaneNormal.X;
+						Nodes.Planes[i].Y = PlaneNormal.Y;
+						Nodes.Planes[i].Z = PlaneNormal.Z;
+						Nodes.Planes[i].W = -AIMapTool->m_Nodes[i]->Plane.d * 100.f;
 						for (int32 Link = 0; Link < 4; Link++)
 						{
 							if (AIMapTool->m_Nodes[i]->n[Link])
 							{
-								INAIMap->Nodes[i]->Nodes[Link] = INAIMap->Nodes[AIMapTool->m_Nodes[i]->n[Link]->idx];
+								Nodes.Links[i][Link] = AIMapTool->m_Nodes[i]->n[Link]->idx;
 							}
 						}
 					}
@@ -1,4 +1,5 @@
 #include "StalkerEditorAIMap.h"
+#include "StalkerEditorAIMapCollision.h"
 #include "Kernel/Unreal/WorldSettings/StalkerWorldSettings.h"
 #include "Resources/AIMap/StalkerAIMap.h"
 #include "Resources/AIMap/StalkerAIMapNode.h"
@@ -16,36 +17,52 @@ void UStalkerEditorAIMap::Destroy()
 {
 }
 
-bool UStalkerEditorAIMap::CreateNode(FStalkerAIMapNode& Result,UWorld* InWorld, const FVector& InPosition, bool bIgnoreConstraints )
+UStalkerAIMap* UStalkerEditorAIMap::GetSettings(UWorld* InWorld, FStalkerEditorAIMapSettings& OutSettings)
 {
 	AStalkerWorldSettings* StalkerWorldSettings = Cast<AStalkerWorldSettings>(InWorld->GetWorldSettings());
 	if (!StalkerWorldSettings)
 	{
-		return false;
+		return nullptr;
 	}
 
 	UStalkerAIMap* StalkerAIMap = StalkerWorldSettings->GetOrCreateAIMap();
 	if (!StalkerAIMap)
+	{
+		return nullptr;
+	}
+	OutSettings.NodeSize = StalkerAIMap->NodeSize;
+	OutSettings.CanUP = StalkerWorldSettings->AIMapCanUP;
+	OutSettings.CanDOWN = StalkerWorldSettings->AIMapCanDOWN;
+	OutSettings.TestHeight = StalkerWorldSettings->AIMapTestHeight;
+	return StalkerAIMap;
+}
+
+bool UStalkerEditorAIMap::CreateNode(FStalkerAIMapNode& Result,UWorld* InWorld, const FVector& InPosition, bool bIgnoreConstraints )
+{
+	FStalkerEditorAIMapSettings Settings;
+	UStalkerAIMap* StalkerAIMap = GetSettings(InWorld, Settings);
+	if (!StalkerAIMap)
 	{
 		return false;
 	}
 
 	StalkerAIMap->NeedRebuild = true;
+	return CreateNode(Result, Settings, FStalkerEditorAIMapWorldQuery(InWorld), InPosition, bIgnoreConstraints);
+}
 
-	const float NodeSize = StalkerAIMap->NodeSize;
-	const int32	RCAST_MaxTris = (2 * 1024);
-	const int32	RCAST_Count = 4;
-	const int32	RCAST_Total = (2 * RCAST_Count + 1) * (2 * RCAST_Count + 1);
+bool UStalkerEditorAIMap::CreateNode(FStalkerAIMapNode& Result, const FStalkerEditorAIMapSettings& Settings, const FStalkerEditorAIMapQuery& Query, const FVector& InPosition, bool bIgnoreConstraints)
+{
+	const float NodeSize = Settings.NodeSize;
+	constexpr int32	RCAST_Count = 4;
+	constexpr int32	RCAST_Total = (2 * RCAST_Count + 1) * (2 * RCAST_Count + 1);
 	const float	RCAST_Depth = 1.f * 100.f;
 	const float RCAST_VALID = 0.55f * 100.f;
 
 	const FVector3f Position = FVector3f(FMath::Floor(InPosition.X / NodeSize) * NodeSize, FMath::Floor(InPosition.Y / NodeSize) * NodeSize, InPosition.Z);
 
 
-	TArray<FVector> Points;
-	TArray<FVector> Normals;
-	FCollisionQueryParams CollisionQueryParams;
-	CollisionQueryParams.bTraceComplex = true;
+	TArray<FVector, TInlineAllocator<RCAST_Total>> Points;
+	TArray<FVector, TInlineAllocator<RCAST_Total>> Normals;
 	float RCASTDelta = 0.5f * NodeSize/ float(RCAST_Count);
 
 	for (int32 x = -RCAST_Count; x <= RCAST_Count; x++)
@@ -56,11 +73,11 @@ bool UStalkerEditorAIMap::CreateNode(FStalkerAIMapNode& Result,UWorld* InWorld,
 			float RayY = Position.Y + RCASTDelta * float(y);
 			FVector StartRay = FVector(RayX, RayY, Position.Z + RCAST_Depth);
 			FVector EndRay = FVector(RayX, RayY, Position.Z - RCAST_Depth);
-			FHitResult HitResult;
-			if (InWorld->LineTraceSingleByChannel(HitResult, StartRay, EndRay, ECC_WorldStatic,CollisionQueryParams,FCollisionResponseParams(ECR_Block)))
+			FVector HitLocation, HitNormal;
+			if (Query.LineTrace(StartRay, EndRay, HitLocation, HitNormal))
 			{
-				Points.Add(HitResult.Location);
-				Normals.Add(HitResult.Normal);
+				Points.Add(HitLocation);
+				Normals.Add(HitNormal);
 			}
 		}
 	}
@@ -106,12 +123,12 @@ bool UStalkerEditorAIMap::CreateNode(FStalkerAIMapNode& Result,UWorld* InWorld,
 	}
 	if (Position.Z > Result.Position.Z) 
 	{
-		if (Position.Z - Result.Position.Z > StalkerWorldSettings->AIMapCanDOWN)
+		if (Position.Z - Result.Position.Z > Settings.CanDOWN)
 			return false;
 	}
 	else 
 	{
-		if (Result.Position.Z - Position.Z > StalkerWorldSettings->AIMapCanUP)
+		if (Result.Position.Z - Position.Z > Settings.CanUP)
 			return false;
 	}
 
@@ -124,21 +141,11 @@ bool UStalkerEditorAIMap::CreateNode(FStalkerAIMapNode& Result,UWorld* InWorld,
 
 		FBox TestHeightBox(ForceInit);
 		TestHeightBox += FVector(Position.X - NodeSize * 0.5f, Position.Y - NodeSize * 0.5f, MaxZ + 6.f);
-		TestHeightBox += FVector(Position.X + NodeSize * 0.5f, Position.Y + NodeSize * 0.5f, MaxZ + StalkerWorldSettings->AIMapTestHeight);
-		TArray<FHitResult> HitResults;
-		InWorld->SweepMultiByChannel(HitResults, TestHeightBox.GetCenter(), TestHeightBox.GetCenter(), FQuat::Identity, ECC_WorldStatic, FCollisionShape::MakeBox(TestHeightBox.GetExtent()), CollisionQueryParams, FCollisionResponseParams(ECR_Block));
-		if (HitResults.Num())
+		TestHeightBox += FVector(Position.X + NodeSize * 0.5f, Position.Y + NodeSize * 0.5f, MaxZ + Settings.TestHeight);
+		if (Query.OverlapBox(TestHeightBox.GetCenter(), TestHeightBox.GetExtent()))
 		{
-			for (FHitResult& HitResult : HitResults)
-			{
-				if (HitResult.bBlockingHit)
-				{
-					//DrawDebugBox(InWorld, TestHeightBox.GetCenter(), TestHeightBox.GetExtent(), FColor::Red, true, 10.f);
-					return false;
-				}
-			}
+			return false;
 		}
-		//DrawDebugBox(InWorld, TestHeightBox.GetCenter(), TestHeightBox.GetExtent(), FColor::Green, true, 10.f);
 	}
 
 	int32 NumSuccessedRays = 0;
@@ -151,12 +158,11 @@ bool UStalkerEditorAIMap::CreateNode(FStalkerAIMapNode& Result,UWorld* InWorld,
 			FVector StartRay = FVector(RayX, RayY, Position.Z + RCAST_Depth);
 			FVector EndRay = FVector(RayX, RayY, Position.Z - RCAST_Depth);
 			StartRay.Z = FMath::RayPlaneIntersection(FVector3f(StartRay) - FVector3f(0, 0, RCAST_VALID * 0.01f), FVector3f(0, 0, -1), Result.Plane).Z+6.f;
-			FVector EndCheckRay = StartRay + FVector(0,0,RCAST_Depth);
-			FHitResult HitResult;
+			FVector HitLocation, HitNormal;
 		
-			if (InWorld->LineTraceSingleByChannel(HitResult, StartRay, EndRay, ECC_WorldStatic, CollisionQueryParams, FCollisionResponseParams(ECR_Block)))
+			if (Query.LineTrace(StartRay, EndRay, HitLocation, HitNormal))
 			{
-				if (FVector::Distance(HitResult.Location, StartRay) < RCAST_VALID)
+				if (FVector::Distance(HitLocation, StartRay) < RCAST_VALID)
 				{
 					NumSuccessedRays++;
 				}
@@ -173,24 +179,9 @@ bool UStalkerEditorAIMap::CreateNode(FStalkerAIMapNode& Result,UWorld* InWorld,
 	return true;
 }
 
-bool UStalkerEditorAIMap::CanTravel(UWorld* InWorld, const FVector& InFrom, const FVector& InTo, const FPlane4f InPlaneFrom, const FPlane4f InPlaneTo)
+bool UStalkerEditorAIMap::CanTravel(const FStalkerEditorAIMapSettings& Settings, const FStalkerEditorAIMapQuery& Query, const FVector& InFrom, const FVector& InTo, const FPlane4f InPlaneFrom, const FPlane4f InPlaneTo)
 {
-	AStalkerWorldSettings* StalkerWorldSettings = Cast<AStalkerWorldSettings>(InWorld->GetWorldSettings());
-	if (!StalkerWorldSettings)
-	{
-		return false;
-	}
-
-	UStalkerAIMap* StalkerAIMap = StalkerWorldSettings->GetOrCreateAIMap();
-	if (!StalkerAIMap)
-	{
-		return false;
-	}
-
-	FCollisionQueryParams CollisionQueryParams;
-	CollisionQueryParams.bTraceComplex = true;
-
-	const float NodeSize = StalkerAIMap->NodeSize;
+	const float NodeSize = Settings.NodeSize;
 	const FVector3f From = FVector3f(FMath::Floor(InFrom.X / NodeSize) * NodeSize, FMath::Floor(InFrom.Y / NodeSize) * NodeSize, InFrom.Z);
 	const FVector3f To = FVector3f(FMath::Floor(InTo.X / NodeSize) * NodeSize, FMath::Floor(InTo.Y / NodeSize) * NodeSize, InTo.Z);
 
@@ -201,7 +192,7 @@ bool UStalkerEditorAIMap::CanTravel(UWorld* InWorld, const FVector& InFrom, cons
 		return false;
 	}
 
-	auto GetMaxZ = [NodeSize, StalkerAIMap](const FPlane4f Plane, const FVector& Position)
+	auto GetMaxZ = [NodeSize](const FPlane4f Plane, const FVector& Position)
 	{
 		float MaxZ = FMath::RayPlaneIntersection(FVector3f(Position) - FVector3f(NodeSize * .5f, NodeSize * .5f, 0), FVector3f(0, 0, -1),Plane).Z;
 		MaxZ = FMath::Max(FMath::RayPlaneIntersection(FVector3f(Position) - FVector3f(NodeSize * .5f, -NodeSize * .5f, 0), FVector3f(0, 0, -1),Plane).Z, MaxZ);
@@ -218,14 +209,14 @@ bool UStalkerEditorAIMap::CanTravel(UWorld* InWorld, const FVector& InFrom, cons
 		float TestZTo = FMath::RayPlaneIntersection((FVector3f(InFrom) + FVector3f(InTo)) / 2.f, FVector3f(0, 0, -1), InPlaneTo).Z;
 		if (TestZFrom > TestZTo)
 		{
-			if (StalkerWorldSettings->AIMapCanDOWN < TestZFrom - TestZTo)
+			if (Settings.CanDOWN < TestZFrom - TestZTo)
 			{
 				return false;
 			}
 		}
 		else
 		{
-			if (StalkerWorldSettings->AIMapCanUP < TestZTo - TestZFrom)
+			if (Settings.CanUP < TestZTo - TestZFrom)
 			{
 				return false;
 			}
@@ -241,21 +232,21 @@ bool UStalkerEditorAIMap::CanTravel(UWorld* InWorld, const FVector& InFrom, cons
 	{
 		TestBox1 += FVector(BoxStart1) + FVector(NodeSize*0.1f, NodeSize * 0.5f * 0.9f, 0);
 		TestBox1 += FVector(BoxStart1) + FVector(-NodeSize * 0.1f, -NodeSize * 0.5f * 0.9f, 0);
-		TestBox1 += FVector(BoxStart1) + FVector(0,0,FMath::Max( (MaxZ2> MaxZ1)?(MaxZ2- MaxZ1) :0 ,StalkerWorldSettings->AIMapTestHeight));
+		TestBox1 += FVector(BoxStart1) + FVector(0,0,FMath::Max( (MaxZ2> MaxZ1)?(MaxZ2- MaxZ1) :0 ,Settings.TestHeight));
 
 		TestBox2 += FVector(BoxStart2) + FVector(NodeSize * 0.1f, NodeSize * 0.5f * 0.9f, 0);
 		TestBox2 += FVector(BoxStart2) + FVector(NodeSize * 0.1f, -NodeSize * 0.5f * 0.9f, 0);
-		TestBox2 += FVector(BoxStart2) + FVector(0, 0, FMath::Max((MaxZ1 > MaxZ2) ? (MaxZ1 - MaxZ2) : 0, StalkerWorldSettings->AIMapTestHeight));
+		TestBox2 += FVector(BoxStart2) + FVector(0, 0, FMath::Max((MaxZ1 > MaxZ2) ? (MaxZ1 - MaxZ2) : 0, Settings.TestHeight));
 	}
 	else
 	{
 		TestBox1 += FVector(BoxStart1) + FVector( NodeSize * 0.5f * 0.9f, NodeSize * 0.1f,  0);
 		TestBox1 += FVector(BoxStart1) + FVector( -NodeSize * 0.5f * 0.9f, NodeSize * 0.1f, 0);
-		TestBox1 += FVector(BoxStart1) + FVector(0, 0, FMath::Max((MaxZ2 > MaxZ1) ? (MaxZ2 - MaxZ1) : 0, StalkerWorldSettings->AIMapTestHeight));
+		TestBox1 += FVector(BoxStart1) + FVector(0, 0, FMath::Max((MaxZ2 > MaxZ1) ? (MaxZ2 - MaxZ1) : 0, Settings.TestHeight));
 
 		TestBox2 += FVector(BoxStart2) + FVector(NodeSize * 0.5f * 0.9f, NodeSize * 0.1f, 0);
 		TestBox2 += FVector(BoxStart2) + FVector(-NodeSize * 0.5f * 0.9f, NodeSize * 0.1f, 0);
-		TestBox2 += FVector(BoxStart2) + FVector(0, 0, FMath::Max((MaxZ1 > MaxZ2) ? (MaxZ1 - MaxZ2) : 0, StalkerWorldSettings->AIMapTestHeight));
+		TestBox2 += FVector(BoxStart2) + FVector(0, 0, FMath::Max((MaxZ1 > MaxZ2) ? (MaxZ1 - MaxZ2) : 0, Settings.TestHeight));
 
 	}
 
@@ -263,213 +254,179 @@ bool UStalkerEditorAIMap::CanTravel(UWorld* InWorld, const FVector& InFrom, cons
 	if (MaxZ2 > MaxZ1)
 	{
 		CheckBox += FVector(From.X - NodeSize * 0.5f * 0.9f, From.Y - NodeSize * 0.5f * 0.9f, MaxZ1 + 6.f);
-		CheckBox += FVector(From.X + NodeSize * 0.5f * 0.9f, From.Y + NodeSize * 0.5f * 0.9f, MaxZ1 + 6.f + (MaxZ2 - MaxZ1) + StalkerWorldSettings->AIMapTestHeight);
+		CheckBox += FVector(From.X + NodeSize * 0.5f * 0.9f, From.Y + NodeSize * 0.5f * 0.9f, MaxZ1 + 6.f + (MaxZ2 - MaxZ1) + Settings.TestHeight);
 	}
 	else
 	{
 		CheckBox += FVector(To.X - NodeSize * 0.5f * 0.9f, To.Y - NodeSize * 0.5f * 0.9f, MaxZ2 + 6.f);
-		CheckBox += FVector(To.X + NodeSize * 0.5f * 0.9f, To.Y + NodeSize * 0.5f * 0.9f, MaxZ2 + 6.f + (MaxZ1 - MaxZ2) + StalkerWorldSettings->AIMapTestHeight);
+		CheckBox += FVector(To.X + NodeSize * 0.5f * 0.9f, To.Y + NodeSize * 0.5f * 0.9f, MaxZ2 + 6.f + (MaxZ1 - MaxZ2) + Settings.TestHeight);
 	}
 
 
-	TArray<FHitResult> HitResults;
-	InWorld->SweepMultiByChannel(HitResults, CheckBox.GetCenter(), CheckBox.GetCenter(), FQuat::Identity, ECC_WorldStatic, FCollisionShape::MakeBox(TestBox1.GetExtent()), CollisionQueryParams, FCollisionResponseParams(ECR_Block));
-	for (FHitResult& HitResult : HitResults)
-	{
-		if (HitResult.bBlockingHit)
-		{
-			DrawDebugBox(InWorld, CheckBox.GetCenter(), CheckBox.GetExtent(), FColor::Red, true, 10.f);
-			return false;
-		}
-	}
-	//DrawDebugBox(InWorld, CheckBox.GetCenter(), CheckBox.GetExtent(), FColor::Green, true, 10.f);
-	HitResults.Empty();
-
-	InWorld->SweepMultiByChannel(HitResults, TestBox1.GetCenter(), TestBox1.GetCenter(), FQuat::Identity, ECC_WorldStatic, FCollisionShape::MakeBox(TestBox1.GetExtent()), CollisionQueryParams, FCollisionResponseParams(ECR_Block));
-	bool bResult = true;
-	for (FHitResult& HitResult : HitResults)
+	if (Query.OverlapBox(CheckBox.GetCenter(), TestBox1.GetExtent()))
 	{
-		if (HitResult.bBlockingHit)
-		{
-			bResult = false;
-			break;
-		}
+		Query.DrawBlockedBox(CheckBox.GetCenter(), CheckBox.GetExtent());
+		return false;
 	}
-	if (bResult)
+	if (!Query.OverlapBox(TestBox1.GetCenter(), TestBox1.GetExtent()))
 	{
-		//DrawDebugBox(InWorld, TestBox1.GetCenter(), TestBox1.GetExtent(), FColor::Green, true, 10.f);
 		return true;
 	}
-	
-
-	//DrawDebugBox(InWorld, TestBox2.GetCenter(), TestBox2.GetExtent(), FColor::Red, true, 10.f);
-	HitResults.Empty();
-	InWorld->SweepMultiByChannel(HitResults, TestBox2.GetCenter(), TestBox2.GetCenter(), FQuat::Identity, ECC_WorldStatic, FCollisionShape::MakeBox(TestBox2.GetExtent()), CollisionQueryParams, FCollisionResponseParams(ECR_Block));
-	bResult = true;
-	for (FHitResult& HitResult : HitResults)
-	{
-		if (HitResult.bBlockingHit)
-		{
-			bResult = false;
-			break;
-		}
-	}
-	if (bResult)
+	if (!Query.OverlapBox(TestBox2.GetCenter(), TestBox2.GetExtent()))
 	{
-		//DrawDebugBox(InWorld, TestBox2.GetCenter(), TestBox2.GetExtent(), FColor::Green, true, 10.f);
 		return true;
 	}
-	DrawDebugBox(InWorld, TestBox2.GetCenter(), TestBox2.GetExtent(), FColor::Red, true, 10.f);
+	Query.DrawBlockedBox(TestBox2.GetCenter(), TestBox2.GetExtent());
 	return false;
 }
 
-struct FStalkerAIMapNode* UStalkerEditorAIMap::FindNeighbour(UWorld* InWorld, struct FStalkerAIMapNode* Node, int32 ID, bool bIgnoreConstraints)
+bool UStalkerEditorAIMap::CanLink(const FStalkerEditorAIMapSettings& Settings, const FStalkerEditorAIMapQuery& Query, const FStalkerAIMapNodes& Nodes, int32 Node, int32 Neighbour, bool bIgnoreConstraints)
 {
-	AStalkerWorldSettings* StalkerWorldSettings = Cast<AStalkerWorldSettings>(InWorld->GetWorldSettings());
-	if (!StalkerWorldSettings)
-	{
-		return nullptr;
-	}
+	return Neighbour != INDEX_NONE && Neighbour != Node && (bIgnoreConstraints || CanTravel(Settings, Query, FVector(Nodes.Positions[Node]), FVector(Nodes.Positions[Neighbour]), Nodes.Planes[Node], Nodes.Planes[Neighbour]));
+}
 
-	UStalkerAIMap* StalkerAIMap = StalkerWorldSettings->GetOrCreateAIMap();
+void UStalkerEditorAIMap::AutoLink(UWorld* InWorld, int32 Node, bool bIgnoreConstraints)
+{
+	FStalkerEditorAIMapSettings Settings;
+	UStalkerAIMap* StalkerAIMap = GetSettings(InWorld, Settings);
 	if (!StalkerAIMap)
 	{
-		return nullptr;
+		return;
 	}
-	const float NodeSize = StalkerAIMap->NodeSize;
-	FVector Position = FVector(Node->Position);
-	if (ID == 0)
-	{
-		FStalkerAIMapNode* LeftNode = FindNode(InWorld,Position + FVector(NodeSize, 0, 0));
-		if (LeftNode&& LeftNode != Node&&( bIgnoreConstraints||CanTravel(InWorld,FVector(Node->Position), FVector(LeftNode->Position), Node->Plane, LeftNode->Plane)))
-		{
-			return LeftNode;
-		}
-		return nullptr ;
+	AutoLink(StalkerAIMap, Settings, FStalkerEditorAIMapWorldQuery(InWorld), Node, bIgnoreConstraints);
+}
 
+void UStalkerEditorAIMap::AutoLink(UStalkerAIMap* StalkerAIMap, const FStalkerEditorAIMapSettings& Settings, const FStalkerEditorAIMapQuery& Query, int32 Node, bool bIgnoreConstraints )
+{
+	FStalkerAIMapNodes& Nodes = StalkerAIMap->Nodes;
+	int32 Neighbours[4];
+	StalkerAIMap->NodesIndex.FindNeighbours(Nodes.Positions[Node], Settings.CanDOWN, Settings.CanUP, Neighbours);
+	FStalkerAIMapNodeLinks& Links = Nodes.Links[Node];
+	for (int32 i = 0; i < 4; i++)
+	{
+		if (Links[i] == INDEX_NONE)
+			Links[i] = CanLink(Settings, Query, Nodes, Node, Neighbours[i], bIgnoreConstraints) ? Neighbours[i] : INDEX_NONE;
+	
 	}
-	else if (ID == 1)
+	for (int32 i = 0; i < 4; i++)
 	{
-		FStalkerAIMapNode* ForwardNode = FindNode(InWorld, Position + FVector(0, NodeSize, 0));
-		if (ForwardNode && ForwardNode != Node && (bIgnoreConstraints || CanTravel(InWorld, FVector(Node->Position), FVector(ForwardNode->Position), Node->Plane, ForwardNode->Plane)))
+		const int32 BackLink = (i + 2) % 4;
+		if (Links[i] != INDEX_NONE && Nodes.Links[Links[i]][BackLink] == INDEX_NONE)
 		{
-			return ForwardNode;
+			Nodes.Links[Links[i]][BackLink] = Node;
 		}
-		return nullptr;
 	}
-	else if (ID == 2)
+}
+
+bool UStalkerEditorAIMap::IsInsideGenerateBounds(const FVector3f& Position) const
+{
+	if (!GenerateAABB.IsInsideOrOn(Position))
 	{
-		FStalkerAIMapNode* RightNode = FindNode(InWorld, Position + FVector(-NodeSize, 0, 0));
-		if (RightNode && RightNode != Node && (bIgnoreConstraints || CanTravel(InWorld, FVector(Node->Position), FVector(RightNode->Position), Node->Plane, RightNode->Plane)))
-		{
-			return RightNode;
-		}
+		return false;
 	}
-	else if (ID == 3)
+	if (GenerateAABBs.Num() > 1)
 	{
-		FStalkerAIMapNode* BackwardNode = FindNode(InWorld, Position + FVector(0, -NodeSize, 0));
-		if (BackwardNode && BackwardNode != Node && (bIgnoreConstraints || CanTravel(InWorld, FVector(Node->Position), FVector(BackwardNode->Position), Node->Plane, BackwardNode->Plane)))
+		for (const FBox3f& Box : GenerateAABBs)
 		{
-			return BackwardNode;
+			if (Box.IsInsideOrOn(Position))
+			{
+				return true;
+			}
 		}
+		return false;
 	}
-	return nullptr;
+	return true;
 }
 
-struct FStalkerAIMapNode* UStalkerEditorAIMap::FindNode(UWorld* InWorld, const FVector& InPosition)
+void UStalkerEditorAIMap::Generate(UWorld* InWorld, bool bSelectedOnly /*= false*/)
 {
 	AStalkerWorldSettings* StalkerWorldSettings = Cast<AStalkerWorldSettings>(InWorld->GetWorldSettings());
 	if (!StalkerWorldSettings)
 	{
-		return nullptr;
+		return;
 	}
 
-	UStalkerAIMap* StalkerAIMap = StalkerWorldSettings->GetOrCreateAIMap();
+	FStalkerEditorAIMapSettings Settings;
+	UStalkerAIMap* StalkerAIMap = GetSettings(InWorld, Settings);
 	if (!StalkerAIMap)
 	{
-		return nullptr;
+		return;
 	}
-	const float NodeSize = StalkerAIMap->NodeSize;
-	TArray<FStalkerAIMapNode*>* NodesHashList = StalkerAIMap->GetEditorHashMap(FVector3f(InPosition));
-	if (NodesHashList)
-	{
-		FVector3f Position = FVector3f(FMath::Floor(InPosition.X / StalkerAIMap->NodeSize) * NodeSize, FMath::Floor(InPosition.Y / StalkerAIMap->NodeSize) * NodeSize, InPosition.Z);
-		FStalkerAIMapNode* Result = nullptr;
-		for (FStalkerAIMapNode* Node : *NodesHashList)
-		{
-			if (FMath::IsNearlyEqual(Node->Position.X, Position.X, 1.f) &&
-				FMath::IsNearlyEqual(Node->Position.Y, Position.Y, 1.f))
-			{
 
-				if (Position.Z > Node->Position.Z)
-				{
-					if (Position.Z - Node->Position.Z > StalkerWorldSettings->AIMapCanDOWN)
-						continue;
-				}
-				else
-				{
-					if (Node->Position.Z - Position.Z > StalkerWorldSettings->AIMapCanUP)
-						continue;
-				}
-				if (Result)
-				{
-					if (FMath::Abs(InPosition.Z - Result->Position.Z) > FMath::Abs(InPosition.Z - Node->Position.Z))
-					{
-						Result = Node;
-					}
-				}
-				else
-				{
-					Result = Node;
-				}
-			}
-		}
-		return Result;
+	StalkerAIMap->NeedRebuild = true;
+	if (!GatherGenerateBounds(InWorld))
+	{
+		return;
 	}
-	return nullptr;
-}
+	StalkerAIMap->HashFill(GenerateAABB);
 
-void UStalkerEditorAIMap::AutoLink(UWorld* InWorld, struct FStalkerAIMapNode* Node, bool bIgnoreConstraints )
-{
-	for (int32 i = 0; i < 4; i++)
+	const double StartTime = FPlatformTime::Seconds();
+	const int32 StartCount = StalkerAIMap->Nodes.Num();
+	if (StalkerWorldSettings->AIMapGenerateFromCollisionSnapshot)
 	{
-		if(!Node->Nodes[i])
-			Node->Nodes[i] = FindNeighbour(InWorld,Node,i, bIgnoreConstraints);
-	
+		FStalkerEditorAIMapCollision Collision;
+		Collision.Build(InWorld, Settings.NodeSize);
+		UE_LOG(LogStalkerEditor, Log, TEXT("AIMap collision snapshot: %d triangles, %.2f sec"), Collision.GetTrianglesNum(), FPlatformTime::Seconds() - StartTime);
+		Generate(StalkerAIMap, Settings, Collision, bSelectedOnly);
 	}
-	if (Node->NodeLeft&& !Node->NodeLeft->NodeRight)
+	else
 	{
-		Node->NodeLeft->NodeRight = Node;
+		Generate(StalkerAIMap, Settings, FStalkerEditorAIMapWorldQuery(InWorld), bSelectedOnly);
 	}
-	if (Node->NodeRight && !Node->NodeRight->NodeLeft)
+	UE_LOG(LogStalkerEditor, Log, TEXT("AIMap generated %d nodes in %.2f sec"), StalkerAIMap->Nodes.Num() - StartCount, FPlatformTime::Seconds() - StartTime);
+}
+
+bool UStalkerEditorAIMap::CompareCollisionSnapshot(UWorld* InWorld, float Tolerance)
+{
+	FStalkerEditorAIMapSettings Settings;
+	UStalkerAIMap* StalkerAIMap = GetSettings(InWorld, Settings);
+	if (!StalkerAIMap || !GatherGenerateBounds(InWorld))
 	{
-		Node->NodeRight->NodeLeft = Node;
+		return false;
 	}
-	if (Node->NodeForward && !Node->NodeForward->NodeBackward)
+
+	auto GenerateCopy = [this, StalkerAIMap, &Settings](const FStalkerEditorAIMapQuery& Query)
 	{
-		Node->NodeForward->NodeBackward = Node;
-	}
-	if (Node->NodeBackward && !Node->NodeBackward->NodeForward)
+		UStalkerAIMap* Copy = NewObject<UStalkerAIMap>(GetTransientPackage());
+		Copy->NodeSize = StalkerAIMap->NodeSize;
+		Copy->Nodes = StalkerAIMap->Nodes;
+		Copy->HashFill(GenerateAABB);
+		Generate(Copy, Settings, Query, false);
+		return Copy;
+	};
+
+	FStalkerEditorAIMapCollision Collision;
+	Collision.Build(InWorld, Settings.NodeSize);
+	const FStalkerAIMapNodes& TraceNodes = GenerateCopy(FStalkerEditorAIMapWorldQuery(InWorld))->Nodes;
+	const FStalkerAIMapNodes& SnapshotNodes = GenerateCopy(Collision)->Nodes;
+	if (TraceNodes.Num() != SnapshotNodes.Num())
 	{
-		Node->NodeBackward->NodeForward = Node;
+		UE_LOG(LogStalkerEditor, Warning, TEXT("AIMap collision snapshot generated %d nodes, world traces %d"), SnapshotNodes.Num(), TraceNodes.Num());
+		return false;
 	}
-}
 
-void UStalkerEditorAIMap::Generate(UWorld* InWorld, bool bSelectedOnly /*= false*/)
-{
-	AStalkerWorldSettings* StalkerWorldSettings = Cast<AStalkerWorldSettings>(InWorld->GetWorldSettings());
-	if (!StalkerWorldSettings)
+	int32 NumMismatched = 0;
+	for (int32 Node = 0; Node < TraceNodes.Num(); Node++)
 	{
-		return;
+		const bool bSameLinks = FMemory::Memcmp(&TraceNodes.Links[Node], &SnapshotNodes.Links[Node], sizeof(FStalkerAIMapNodeLinks)) == 0;
+		if (bSameLinks && TraceNodes.Positions[Node].Equals(SnapshotNodes.Positions[Node], Tolerance) && TraceNodes.Planes[Node].GetNormal().Equals(SnapshotNodes.Planes[Node].GetNormal(), 1e-3f))
+		{
+			continue;
+		}
+		if (NumMismatched++ < 16)
+		{
+			UE_LOG(LogStalkerEditor, Warning, TEXT("AIMap node %d differs: world traces %s, collision snapshot %s"), Node, *TraceNodes.Positions[Node].ToString(), *SnapshotNodes.Positions[Node].ToString());
+		}
 	}
-
-	UStalkerAIMap* StalkerAIMap = StalkerWorldSettings->GetOrCreateAIMap();
-	if (!StalkerAIMap)
+	if (NumMismatched)
 	{
-		return;
+		UE_LOG(LogStalkerEditor, Warning, TEXT("AIMap collision snapshot differs from world traces in %d of %d nodes"), NumMismatched, TraceNodes.Num());
 	}
+	return NumMismatched == 0;
+}
 
-	StalkerAIMap->NeedRebuild = true;
+bool UStalkerEditorAIMap::GatherGenerateBounds(UWorld* InWorld)
+{
 	GenerateAABB = FBox3f(ForceInit);
 	GenerateAABBs.Reset();
 	for (TActorIterator<AStalkerAIMapBoundsVolume> It(InWorld); It; ++It)
@@ -481,132 +438,118 @@ void UStalkerEditorAIMap::Generate(UWorld* InWorld, bool bSelectedOnly /*= false
 			GenerateAABB += FBox3f(GenerateAABBs.Last());
 		}
 	}
-	if (GenerateAABBs.Num() == 0)
-	{
-		return;
-	}
-	StalkerAIMap->HashFill(GenerateAABB);
-
-	for (int32 i = 0; i < StalkerAIMap->Nodes.Num(); i++)
-	{
+	return GenerateAABBs.Num() != 0;
+}
 
-		if (GenerateAABB.IsInsideOrOn(StalkerAIMap->Nodes[i]->Position))
+void UStalkerEditorAIMap::Generate(UStalkerAIMap* StalkerAIMap, const FStalkerEditorAIMapSettings& Settings, const FStalkerEditorAIMapQuery& Query, bool bSelectedOnly)
+{
+	// Nodes appended while expanding the range [Begin, End) form the next wavefront, so walking
+	// wavefronts in order visits nodes exactly like a single loop over the growing Nodes array.
+	// Candidates depend only on the source node and the geometry, which lets a thread-safe query
+	// evaluate a whole wavefront in parallel while links are still applied serially in order.
+	TArray<FStalkerEditorAIMapCandidate> Candidates;
+	FStalkerAIMapNodes& Nodes = StalkerAIMap->Nodes;
+	for (int32 Begin = 0, End = Nodes.Num(); Begin < End; Begin = End, End = Nodes.Num())
+	{
+		Candidates.Reset();
+		for (int32 Node = Begin; Node < End; Node++)
 		{
-			if (GenerateAABBs.Num() > 1)
+			if (!IsInsideGenerateBounds(Nodes.Positions[Node]))
 			{
-				bool bCheck = false;
-				for (FBox3f& Box : GenerateAABBs)
-				{
-					bCheck|=Box.IsInsideOrOn(StalkerAIMap->Nodes[i]->Position);
-				}
-				if (!bCheck)
+				continue;
+			}
+			if (!bSelectedOnly || Nodes.IsSelected(Node))
+			{
+				for (int32 Link = 0; Link < 4; Link++)
 				{
-					continue;
+					if (Nodes.Links[Node][Link] == INDEX_NONE)
+					{
+						FStalkerEditorAIMapCandidate& Candidate = Candidates.AddDefaulted_GetRef();
+						Candidate.Node = Node;
+						Candidate.Link = Link;
+					}
 				}
 			}
 		}
-		else
+
+		if (Query.IsThreadSafe())
 		{
-			continue;
+			ParallelFor(Candidates.Num(), [this, &Candidates, &Nodes, &Settings, &Query](int32 Index)
+			{
+				BuildCandidate(Candidates[Index], Nodes, Settings, Query);
+			});
 		}
-		if (!bSelectedOnly || EnumHasAnyFlags(StalkerAIMap->Nodes[i]->Flags,EStalkerAIMapNodeFlags::Selected))
+
+		for (FStalkerEditorAIMapCandidate& Candidate : Candidates)
 		{
-			for (int32 Link = 0; Link < 4; Link++)
+			if (Nodes.Links[Candidate.Node][Candidate.Link] != INDEX_NONE)
 			{
-				if (!StalkerAIMap->Nodes[i]->Nodes[Link])
-				{
-					StalkerAIMap->Nodes[i]->Nodes[Link] = BuildNode(InWorld, StalkerAIMap->Nodes[i], Link, bSelectedOnly);
-				}
+				continue;
+			}
+			if (!Query.IsThreadSafe())
+			{
+				BuildCandidate(Candidate, Nodes, Settings, Query);
 			}
+			const int32 Result = BuildNode(StalkerAIMap, Settings, Query, Candidate);
+			Nodes.Links[Candidate.Node][Candidate.Link] = Result;
 		}
-		
 	}
 }
 
-struct FStalkerAIMapNode* UStalkerEditorAIMap::BuildNode(UWorld* InWorld, struct FStalkerAIMapNode* Node, int32 ID, bool bSelectedOnly)
+void UStalkerEditorAIMap::BuildCandidate(FStalkerEditorAIMapCandidate& Candidate, const FStalkerAIMapNodes& Nodes, const FStalkerEditorAIMapSettings& Settings, const FStalkerEditorAIMapQuery& Query) const
 {
-	AStalkerWorldSettings* StalkerWorldSettings = Cast<AStalkerWorldSettings>(InWorld->GetWorldSettings());
-	if (!StalkerWorldSettings)
-	{
-		return nullptr;
-	}
-
-	UStalkerAIMap* StalkerAIMap = StalkerWorldSettings->GetOrCreateAIMap();
-	if (!StalkerAIMap)
-	{
-		return nullptr;
-	}
+	const FVector Position = FVector(Nodes.Positions[Candidate.Node]);
 	FVector ToPosition;
 	
-	if (ID == 0)
-	{
-		ToPosition = FVector(Node->Position) + FVector(StalkerAIMap->NodeSize, 0, 0);
-	}
-	else if (ID == 1)
+	if (Candidate.Link == 0)
 	{
-		ToPosition = FVector(Node->Position) + FVector(0, StalkerAIMap->NodeSize, 0);
+		ToPosition = Position + FVector(Settings.NodeSize, 0, 0);
 	}
-	else if (ID == 2)
+	else if (Candidate.Link == 1)
 	{
-
-		ToPosition = FVector(Node->Position) + FVector(-StalkerAIMap->NodeSize, 0, 0);
+		ToPosition = Position + FVector(0, Settings.NodeSize, 0);
 	}
-	else if (ID == 3)
+	else if (Candidate.Link == 2)
 	{
-		ToPosition = FVector(Node->Position) + FVector(0, -StalkerAIMap->NodeSize, 0);
-	}
 
-	if (GenerateAABB.IsInsideOrOn(FVector3f(ToPosition)))
-	{
-		if (GenerateAABBs.Num() > 1)
-		{
-			bool bCheck = false;
-			for (FBox3f& Box : GenerateAABBs)
-			{
-				bCheck |= Box.IsInsideOrOn(FVector3f(ToPosition));
-			}
-			if (!bCheck)
-			{
-				return nullptr;
-			}
-		}
+		ToPosition = Position + FVector(-Settings.NodeSize, 0, 0);
 	}
 	else
 	{
-		return nullptr;
-	}
-	FStalkerAIMapNode TempNode;
-	if (!CreateNode(TempNode, InWorld, ToPosition))
-	{
-		return nullptr;
-	}
-	if (!CanTravel(InWorld, FVector(Node->Position), FVector(TempNode.Position), Node->Plane, TempNode.Plane))
-	{
-		return nullptr;
+		ToPosition = Position + FVector(0, -Settings.NodeSize, 0);
 	}
-	FStalkerAIMapNode* Result = StalkerAIMap->FindNode(TempNode.Position,1);
-	if (!Result)
+
+	Candidate.bValid = false;
+	if (!IsInsideGenerateBounds(FVector3f(ToPosition)))
 	{
-		Result = StalkerAIMap->FindOrCreateNode(TempNode.Position,1,true,false);
-		Result->Plane = TempNode.Plane;
-		Result->Flags |= EStalkerAIMapNodeFlags::Selected;
-		AutoLink(InWorld,Result);
+		return;
 	}
-	if (ID == 0&& !Result->NodeRight)
+	if (!CreateNode(Candidate.Result, Settings, Query, ToPosition))
 	{
-		Result->NodeRight = Node;
+		return;
 	}
-	else if (ID == 1 && !Result->NodeBackward)
+	Candidate.bValid = CanTravel(Settings, Query, Position, FVector(Candidate.Result.Position), Nodes.Planes[Candidate.Node], Candidate.Result.Plane);
+}
+
+int32 UStalkerEditorAIMap::BuildNode(UStalkerAIMap* StalkerAIMap, const FStalkerEditorAIMapSettings& Settings, const FStalkerEditorAIMapQuery& Query, const FStalkerEditorAIMapCandidate& Candidate)
+{
+	if (!Candidate.bValid)
 	{
-		Result->NodeBackward = Node;
+		return INDEX_NONE;
 	}
-	else if (ID == 2 && !Result->NodeLeft)
+	int32 Result = StalkerAIMap->FindNode(Candidate.Result.Position,1);
+	if (Result == INDEX_NONE)
 	{
-		Result->NodeLeft = Node;
+		Result = StalkerAIMap->FindOrCreateNode(Candidate.Result.Position,1,true);
+		StalkerAIMap->Nodes.Planes[Result] = Candidate.Result.Plane;
+		StalkerAIMap->SelectNode(Result);
+		AutoLink(StalkerAIMap, Settings, Query, Result);
 	}
-	else if (ID == 3&&!Result->NodeForward)
+	const int32 BackLink = (Candidate.Link + 2) % 4;
+	FStalkerAIMapNodeLinks& Links = StalkerAIMap->Nodes.Links[Result];
+	if (Links[BackLink] == INDEX_NONE)
 	{
-		Result->NodeForward = Node;
+		Links[BackLink] = Candidate.Node;
 	}
 	return Result;
 }
@@ -627,39 +570,40 @@ void UStalkerEditorAIMap::Smooth(UWorld* InWorld, bool bSelectedOnly /*= false*/
 
 	StalkerAIMap->NeedRebuild = true;
 	const float NodeSize = StalkerAIMap->NodeSize;
+	FStalkerAIMapNodes& Nodes = StalkerAIMap->Nodes;
 
 
-	auto PointLF = [NodeSize](FStalkerAIMapNode&Node)
+	auto PointLF = [NodeSize, &Nodes](int32 Node)
 	{
 		FVector3f	Ray(0,0, -1);
-		FVector3f	Position =Node.Position;;
+		FVector3f	Position = Nodes.Positions[Node];
 		Position.X += NodeSize / 2;
 		Position.Y += NodeSize / 2;
-		return FMath::RayPlaneIntersection(Position,Ray,Node.Plane);
+		return FMath::RayPlaneIntersection(Position,Ray, Nodes.Planes[Node]);
 	};
-	auto PointRF = [NodeSize](FStalkerAIMapNode& Node)
+	auto PointRF = [NodeSize, &Nodes](int32 Node)
 	{
 		FVector3f	Ray(0, 0, -1);
-		FVector3f	Position = Node.Position;;
+		FVector3f	Position = Nodes.Positions[Node];
 		Position.X -= NodeSize / 2;
 		Position.Y += NodeSize / 2;
-		return FMath::RayPlaneIntersection(Position, Ray, Node.Plane);
+		return FMath::RayPlaneIntersection(Position, Ray, Nodes.Planes[Node]);
 	};
-	auto PointRB = [NodeSize](FStalkerAIMapNode& Node)
+	auto PointRB = [NodeSize, &Nodes](int32 Node)
 	{
 		FVector3f	Ray(0, 0, -1);
-		FVector3f	Position = Node.Position;;
+		FVector3f	Position = Nodes.Positions[Node];
 		Position.X -= NodeSize / 2;
 		Position.Y -= NodeSize / 2;
-		return FMath::RayPlaneIntersection(Position, Ray, Node.Plane);
+		return FMath::RayPlaneIntersection(Position, Ray, Nodes.Planes[Node]);
 	};
-	auto PointLB = [NodeSize](FStalkerAIMapNode& Node)
+	auto PointLB = [NodeSize, &Nodes](int32 Node)
 	{
 		FVector3f	Ray(0, 0, -1);
-		FVector3f	Position = Node.Position;;
+		FVector3f	Position = Nodes.Positions[Node];
 		Position.X += NodeSize / 2;
 		Position.Y -= NodeSize / 2;
-		return FMath::RayPlaneIntersection(Position, Ray, Node.Plane);
+		return FMath::RayPlaneIntersection(Position, Ray, Nodes.Planes[Node]);
 	};
 	auto Merge = [NodeSize](int32&Count,FVector3f&To,const FVector3f&In)
 	{
@@ -670,25 +614,12 @@ void UStalkerEditorAIMap::Smooth(UWorld* InWorld, bool bSelectedOnly /*= false*/
 		}
 	};
 
-	TArray<FStalkerAIMapNode*> NewNodes;
-	NewNodes.Empty(StalkerAIMap->Nodes.Num());
-	for (int32 i = 0; i < StalkerAIMap->Nodes.Num(); i++)
-	{
-		NewNodes.Add(new FStalkerAIMapNode);
-		NewNodes.Last()->Index = i;
-	}
-	StalkerAIMap->CalculateIndex();
-	for (int32 i = 0; i < StalkerAIMap->Nodes.Num(); i++)
+	TArray<FVector3f> NewPositions = Nodes.Positions;
+	TArray<FPlane4f> NewPlanes = Nodes.Planes;
+	for (int32 i = 0; i < Nodes.Num(); i++)
 	{
-		
-		FStalkerAIMapNode&MainNode = *StalkerAIMap->Nodes[i];
-		NewNodes[i]->Plane = MainNode.Plane;
-		NewNodes[i]->Position = MainNode.Position;
-		for (int32 Link = 0; Link < 4; Link++)
-		{
-			NewNodes[i]->Nodes[Link] = MainNode.Nodes[Link] ? NewNodes[MainNode.Nodes[Link]->Index]: nullptr;
-		}
-		if (!bSelectedOnly || EnumHasAnyFlags(StalkerAIMap->Nodes[i]->Flags, EStalkerAIMapNodeFlags::Selected))
+		const FStalkerAIMapNodeLinks& Links = Nodes.Links[i];
+		if (!bSelectedOnly || Nodes.IsSelected(i))
 		{
 
 			FVector3f Point1,Point2,Point3,Point4;
@@ -696,23 +627,23 @@ void UStalkerEditorAIMap::Smooth(UWorld* InWorld, bool bSelectedOnly /*= false*/
 			{
 				bool	bCorner = false;
 				int32	Counter = 1;
-				Point1 = PointLF(MainNode);
-				if (MainNode.NodeLeft)
+				Point1 = PointLF(i);
+				if (Links[0] != INDEX_NONE)
 				{
-					Merge(Counter, Point1,PointRF(*MainNode.NodeLeft));
-					if (MainNode.NodeLeft->NodeForward)
+					Merge(Counter, Point1,PointRF(Links[0]));
+					if (Nodes.Links[Links[0]][1] != INDEX_NONE)
 					{
 						bCorner = true;
-						Merge(Counter, Point1, PointRB(*MainNode.NodeLeft->NodeForward));
+						Merge(Counter, Point1, PointRB(Nodes.Links[Links[0]][1]));
 					}
 				}
-				if (MainNode.NodeForward)
+				if (Links[1] != INDEX_NONE)
 				{
-					Merge(Counter, Point1, PointLB(*MainNode.NodeForward));
-					if (!bCorner && MainNode.NodeForward->NodeLeft)
+					Merge(Counter, Point1, PointLB(Links[1]));
+					if (!bCorner && Nodes.Links[Links[1]][0] != INDEX_NONE)
 					{
 						bCorner = true;
-						Merge(Counter, Point1, PointRB(*MainNode.NodeForward->NodeLeft));
+						Merge(Counter, Point1, PointRB(Nodes.Links[Links[1]][0]));
 					}
 				}
 				check(Counter <= 4);
@@ -723,23 +654,23 @@ void UStalkerEditorAIMap::Smooth(UWorld* InWorld, bool bSelectedOnly /*= false*/
 			{
 				bool	bCorner = false;
 				int32	Counter = 1;
-				Point2 = PointRF(MainNode);
-				if (MainNode.NodeForward)
+				Point2 = PointRF(i);
+				if (Links[1] != INDEX_NONE)
 				{
-					Merge(Counter, Point2, PointRB(*MainNode.NodeForward));
-					if (MainNode.NodeForward->NodeRight)
+					Merge(Counter, Point2, PointRB(Links[1]));
+					if (Nodes.Links[Links[1]][2] != INDEX_NONE)
 					{
 						bCorner = true;
-						Merge(Counter, Point2, PointLB(*MainNode.NodeForward->NodeRight));
+						Merge(Counter, Point2, PointLB(Nodes.Links[Links[1]][2]));
 					}
 				}
-				if (MainNode.NodeRight)
+				if (Links[2] != INDEX_NONE)
 				{
-					Merge(Counter, Point2, PointLF(*MainNode.NodeRight));
-					if (!bCorner && MainNode.NodeRight->NodeForward)
+					Merge(Counter, Point2, PointLF(Links[2]));
+					if (!bCorner && Nodes.Links[Links[2]][1] != INDEX_NONE)
 					{
 						bCorner = true;
-						Merge(Counter, Point2, PointLB(*MainNode.NodeRight->NodeForward));
+						Merge(Counter, Point2, PointLB(Nodes.Links[Links[2]][1]));
 					}
 				}
 				check(Counter <= 4);
@@ -750,23 +681,23 @@ void UStalkerEditorAIMap::Smooth(UWorld* InWorld, bool bSelectedOnly /*= false*/
 			{
 				bool	bCorner = false;
 				int32	Counter = 1;
-				Point3 = PointRB(MainNode);
-				if (MainNode.NodeRight)
+				Point3 = PointRB(i);
+				if (Links[2] != INDEX_NONE)
 				{
-					Merge(Counter, Point3, PointLB(*MainNode.NodeRight));
-					if (MainNode.NodeRight->NodeBackward)
+					Merge(Counter, Point3, PointLB(Links[2]));
+					if (Nodes.Links[Links[2]][3] != INDEX_NONE)
 					{
 						bCorner = true;
-						Merge(Counter, Point3, PointLF(*MainNode.NodeRight->NodeBackward));
+						Merge(Counter, Point3, PointLF(Nodes.Links[Links[2]][3]));
 					}
 				}
-				if (MainNode.NodeBackward)
+				if (Links[3] != INDEX_NONE)
 				{
-					Merge(Counter, Point3, PointRF(*MainNode.NodeBackward));
-					if (!bCorner && MainNode.NodeBackward->NodeRight)
+					Merge(Counter, Point3, PointRF(Links[3]));
+					if (!bCorner && Nodes.Links[Links[3]][2] != INDEX_NONE)
 					{
 						bCorner = true;
-						Merge(Counter, Point3, PointLF(*MainNode.NodeBackward->NodeRight));
+						Merge(Counter, Point3, PointLF(Nodes.Links[Links[3]][2]));
 					}
 				}
 				check(Counter <= 4);
@@ -777,23 +708,23 @@ void UStalkerEditorAIMap::Smooth(UWorld* InWorld, bool bSelectedOnly /*= false*/
 			{
 				bool	bCorner = false;
 				int32	Counter = 1;
-				Point4 = PointLB(MainNode);
-				if (MainNode.NodeBackward)
+				Point4 = PointLB(i);
+				if (Links[3] != INDEX_NONE)
 				{
-					Merge(Counter, Point4, PointLF(*MainNode.NodeBackward));
-					if (MainNode.NodeBackward->NodeLeft)
+					Merge(Counter, Point4, PointLF(Links[3]));
+					if (Nodes.Links[Links[3]][0] != INDEX_NONE)
 					{
 						bCorner = true;
-						Merge(Counter, Point4, PointRF(*MainNode.NodeBackward->NodeLeft));
+						Merge(Counter, Point4, PointRF(Nodes.Links[Links[3]][0]));
 					}
 				}
-				if (MainNode.NodeLeft)
+				if (Links[0] != INDEX_NONE)
 				{
-					Merge(Counter, Point4, PointRB(*MainNode.NodeLeft));
-					if (!bCorner && MainNode.NodeLeft->NodeBackward)
+					Merge(Counter, Point4, PointRB(Links[0]));
+					if (!bCorner && Nodes.Links[Links[0]][3] != INDEX_NONE)
 					{
 						bCorner = true;
-						Merge(Counter, Point4, PointRF(*MainNode.NodeLeft->NodeBackward));
+						Merge(Counter, Point4, PointRF(Nodes.Links[Links[0]][3]));
 					}
 				}
 				check(Counter <= 4);
@@ -823,15 +754,16 @@ void UStalkerEditorAIMap::Smooth(UWorld* InWorld, bool bSelectedOnly /*= false*/
 			FVector3f Normal = Plane1.GetNormal()+ Plane2.GetNormal() + Plane3.GetNormal() + Plane4.GetNormal();
 			Normal.Normalize();
 			FVector3f Position = (Point1+ Point2+Point3+Point4)/4.f;
-			Position.X = MainNode.Position.X;
-			Position.Y = MainNode.Position.Y;
-			NewNodes[i]->Position = Position;
-			NewNodes[i]->Plane = FPlane4f(Position,Normal);
+			Position.X = Nodes.Positions[i].X;
+			Position.Y = Nodes.Positions[i].Y;
+			NewPositions[i] = Position;
+			NewPlanes[i] = FPlane4f(Position,Normal);
 		}
 	}
-	StalkerAIMap->ClearAIMap();
-	StalkerAIMap->Nodes = NewNodes;
-	NewNodes.Empty();
+	StalkerAIMap->InvalidAIMap();
+	StalkerAIMap->ClearSelected();
+	Nodes.Positions = MoveTemp(NewPositions);
+	Nodes.Planes = MoveTemp(NewPlanes);
 	StalkerAIMap->HashFill();
 }
 
@@ -848,11 +780,12 @@ void UStalkerEditorAIMap::Reset(UWorld* InWorld, bool bSelectedOnly /*= false*/)
 	{
 		return;
 	}
-	for (int32 i = 0; i < StalkerAIMap->Nodes.Num(); i++)
+	FStalkerAIMapNodes& Nodes = StalkerAIMap->Nodes;
+	for (int32 i = 0; i < Nodes.Num(); i++)
 	{
-		if (!bSelectedOnly || EnumHasAnyFlags(StalkerAIMap->Nodes[i]->Flags, EStalkerAIMapNodeFlags::Selected))
+		if (!bSelectedOnly || Nodes.IsSelected(i))
 		{
-			StalkerAIMap->Nodes[i]->Plane = FPlane4f(StalkerAIMap->Nodes[i]->Position,FVector3f(0,0,1));
+			Nodes.Planes[i] = FPlane4f(Nodes.Positions[i],FVector3f(0,0,1));
 		}
 	}
 }
@@ -865,8 +798,6 @@ void UStalkerEditorAIMap::Build()
 	{
 		return;
 	}
-	constexpr float high_cover_height = 1.5f;
-	constexpr float low_cover_height = 0.6f;
 	FWorldContext* WorldContext = GEngine->GetWorldContextFromGameViewport(GEngine->GameViewport);
 	if (!WorldContext)
 		return;
@@ -885,6 +816,20 @@ void UStalkerEditorAIMap::Build()
 	{
 		return;
 	}
+	AIMap->InvalidAIMap();
+	UStalkerLevelSpawn *LevelSpawn =  StalkerWorldSettings->GetSpawn();
+	if (LevelSpawn)
+	{
+		LevelSpawn->NeedRebuild = true;
+		LevelSpawn->Modify();
+	}
+	BuildLevelGraph(AIMap);
+}
+
+void UStalkerEditorAIMap::BuildLevelGraph(UStalkerAIMap* AIMap)
+{
+	constexpr float high_cover_height = 1.5f;
+	constexpr float low_cover_height = 0.6f;
 	const float NodeSize = AIMap->NodeSize/100.f;
 	auto CNodePositionCompressor = [NodeSize](NodePosition & Pdest,const Fvector & Psrc, hdrNODES & H)
 	{
@@ -896,12 +841,12 @@ void UStalkerEditorAIMap::Build()
 		Pdest.xz(pxz);
 		clamp(py, 0, 65535);	Pdest.y(u16(py));
 	};
-	auto CompressNode  = [](NodeCompressed & Dest, FStalkerAIMapNode* Src)
+	auto CompressNode  = [](NodeCompressed & Dest, const FStalkerAIMapNodeLinks& Src)
 	{
 		constexpr int32 InvalidNode = (1 << 24) - 1;
 		Dest.light(15);
 		for (u8 L = 0; L < 4; ++L)
-			Dest.link(L, Src->Nodes[L] ? Src->Nodes[L]->Index : InvalidNode);
+			Dest.link(L, Src[L] != INDEX_NONE ? Src[L] : InvalidNode);
 	};
 	auto CompressCover = [](float c, int max_value)
 	{
@@ -909,11 +854,11 @@ void UStalkerEditorAIMap::Build()
 		clamp(cover, 0, max_value);
 		return BYTE(cover);
 	};
-	auto	Compress = [low_cover_height, high_cover_height, CompressCover, CompressNode, CNodePositionCompressor](NodeCompressed & Dest, FStalkerAIMapNode * Src, hdrNODES & H)
+	auto	Compress = [low_cover_height, high_cover_height, CompressCover, CompressNode, CNodePositionCompressor](NodeCompressed & Dest, const FStalkerAIMapNodes& Nodes, int32 Src, hdrNODES & H)
 	{
-		Dest.plane = pvCompress(StalkerMath::UnrealNormalToXRay(Src->Plane.GetNormal()));
-		CNodePositionCompressor(Dest.p, StalkerMath::UnrealLocationToXRay(Src->Position), H);
-		CompressNode(Dest, Src);
+		Dest.plane = pvCompress(StalkerMath::UnrealNormalToXRay(Nodes.Planes[Src].GetNormal()));
+		CNodePositionCompressor(Dest.p, StalkerMath::UnrealLocationToXRay(Nodes.Positions[Src]), H);
+		CompressNode(Dest, Nodes.Links[Src]);
 		Dest.high.cover0 = CompressCover(high_cover_height, 15);
 		Dest.high.cover1 = CompressCover(high_cover_height, 15);
 		Dest.high.cover2 = CompressCover(high_cover_height, 15);
@@ -962,14 +907,6 @@ void UStalkerEditorAIMap::Build()
 			});
 	};
 
-
-	AIMap->InvalidAIMap();
-	UStalkerLevelSpawn *LevelSpawn =  StalkerWorldSettings->GetSpawn();
-	if (LevelSpawn)
-	{
-		LevelSpawn->NeedRebuild = true;
-		LevelSpawn->Modify();
-	}
 	if (AIMap->Nodes.Num() == 0)
 	{
 		UE_LOG(LogStalkerEditor,Warning,TEXT("AIMap [%s] is empty !"), *AIMap->GetPathName())
@@ -977,14 +914,13 @@ void UStalkerEditorAIMap::Build()
 	}
 	AIMap->NeedRebuild = false;
 	AIMap->HashFill();
-	AIMap->CalculateIndex();
 	AIMap->AIMapGuid = FGuid::NewGuid();
 	auto CalculateAABB = [&AIMap](Fbox& BB)->float
 	{
 		BB.invalidate();
 		for (int32 i = 0; i < AIMap->Nodes.Num(); i++)
 		{
-			BB.modify(StalkerMath::UnrealLocationToXRay(AIMap->Nodes[i]->Position));
+			BB.modify(StalkerMath::UnrealLocationToXRay(AIMap->Nodes.Positions[i]));
 		}
 		return BB.max.y - BB.min.y + EPS_L;
 	};
@@ -995,10 +931,10 @@ void UStalkerEditorAIMap::Build()
 	FMemory::Memcpy(&static_cast<hdrNODES&>(AIMap->LevelGraphHeader).guid, &AIMap->AIMapGuid,sizeof(FGuid));
 	AIMap->LevelGraphVertices.Empty(AIMap->Nodes.Num());
 
-	for (FStalkerAIMapNode* Node : AIMap->Nodes)
+	for (int32 Node = 0; Node < AIMap->Nodes.Num(); Node++)
 	{
 		ILevelGraph::CVertex	NC;
-		Compress(NC, Node, static_cast<hdrNODES&>(AIMap->LevelGraphHeader));
+		Compress(NC, AIMap->Nodes, Node, static_cast<hdrNODES&>(AIMap->LevelGraphHeader));
 		AIMap->LevelGraphVertices.Add(NC);
 	}
 	xr_vector<u32>	sorted;
@@ -1,5 +1,15 @@
 #pragma once
+#include "Resources/AIMap/StalkerAIMapNode.h"
 #include "StalkerEditorAIMap.generated.h"
+
+struct FStalkerEditorAIMapCandidate
+{
+	int32						Node = INDEX_NONE;
+	int32						Link = 0;
+	bool						bValid = false;
+	FStalkerAIMapNode			Result;
+};
+
 UCLASS()
 class UStalkerEditorAIMap : public UObject
 {
@@ -8,17 +18,31 @@ public:
 	void						Initialize				();
 	void						Destroy					();
 	bool						CreateNode				(struct FStalkerAIMapNode& Result, UWorld*InWorld, const FVector& InPossition,bool bIgnoreConstraints=false);
-	bool						CanTravel				(UWorld* InWorld, const FVector& From, const FVector& To, const FPlane4f InPlaneFrom, const FPlane4f InPlaneTo);
-	struct FStalkerAIMapNode*	FindNeighbour			(UWorld* InWorld, struct FStalkerAIMapNode* Node,int32 ID, bool bIgnoreConstraints = false);
-	struct FStalkerAIMapNode*	FindNode				(UWorld* InWorld, const FVector& InPosition);
-	void						AutoLink				(UWorld* InWorld, struct FStalkerAIMapNode* Node, bool bIgnoreConstraints = false);
+	void						AutoLink				(UWorld* InWorld, int32 Node, bool bIgnoreConstraints = false);
 	void						Generate				(UWorld* InWorld, bool bSelectedOnly = false);
-	struct FStalkerAIMapNode*	BuildNode				(UWorld* InWorld, struct FStalkerAIMapNode* Node, int32 ID, bool bSelectedOnly);
+	// Generates from the current nodes once with world traces and once with the collision snapshot and compares the results node for node.
+	// Counts and links must match exactly, positions only within Tolerance: the snapshot does not share the physics engine's ray arithmetic.
+	bool						CompareCollisionSnapshot(UWorld* InWorld, float Tolerance = 1.f);
 	void						Smooth					(UWorld* InWorld, bool bSelectedOnly = false);
 	void						Reset					(UWorld* InWorld, bool bSelectedOnly = false);
 	void						Build					();
+	// Compresses the editor nodes into the level graph vertices, AABB and header of the AI map
+	static void					BuildLevelGraph			(class UStalkerAIMap* AIMap);
 	void						BuildIfNeeded			();
+
+	static bool					CreateNode				(struct FStalkerAIMapNode& Result, const struct FStalkerEditorAIMapSettings& Settings, const class FStalkerEditorAIMapQuery& Query, const FVector& InPossition, bool bIgnoreConstraints = false);
+	static bool					CanTravel				(const struct FStalkerEditorAIMapSettings& Settings, const class FStalkerEditorAIMapQuery& Query, const FVector& From, const FVector& To, const FPlane4f InPlaneFrom, const FPlane4f InPlaneTo);
 private:
+	friend class FStalkerEditorAIMapWavefrontTest;
+	static class UStalkerAIMap*	GetSettings				(UWorld* InWorld, struct FStalkerEditorAIMapSettings& OutSettings);
+	static bool					CanLink					(const struct FStalkerEditorAIMapSettings& Settings, const class FStalkerEditorAIMapQuery& Query, const class FStalkerAIMapNodes& Nodes, int32 Node, int32 Neighbour, bool bIgnoreConstraints);
+	void						AutoLink				(class UStalkerAIMap* StalkerAIMap, const struct FStalkerEditorAIMapSettings& Settings, const class FStalkerEditorAIMapQuery& Query, int32 Node, bool bIgnoreConstraints = false);
+	bool						GatherGenerateBounds	(UWorld* InWorld);
+	void						Generate				(class UStalkerAIMap* StalkerAIMap, const struct FStalkerEditorAIMapSettings& Settings, const class FStalkerEditorAIMapQuery& Query, bool bSelectedOnly);
+	void						BuildCandidate			(FStalkerEditorAIMapCandidate& Candidate, const class FStalkerAIMapNodes& Nodes, const struct FStalkerEditorAIMapSettings& Settings, const class FStalkerEditorAIMapQuery& Query) const;
+	int32						BuildNode				(class UStalkerAIMap* StalkerAIMap, const struct FStalkerEditorAIMapSettings& Settings, const class FStalkerEditorAIMapQuery& Query, const FStalkerEditorAIMapCandidate& Candidate);
+	bool						IsInsideGenerateBounds	(const FVector3f& Position) const;
+
 	TSharedPtr< FUICommandList>	AIMapCommands;
 	FBox3f						GenerateAABB;
 	TArray<FBox3f>				GenerateAABBs;
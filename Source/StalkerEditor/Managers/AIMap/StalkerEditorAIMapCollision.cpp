@@ -0,0 +1,289 @@
+#include "StalkerEditorAIMapCollision.h"
+#include "Resources/CFrom/StalkerCForm.h"
+#include "../CFrom/StalkerEditorCForm.h"
+#include "../../StalkerEditorManager.h"
+
+namespace
+{
+	constexpr int32 AIMapCollisionMaxCells = 2048;
+
+	bool SegmentTriangleIntersection(const FVector& Start, const FVector& Direction, const FVector(&Vertices)[3], double& OutTime)
+	{
+		const FVector Edge1 = Vertices[1] - Vertices[0];
+		const FVector Edge2 = Vertices[2] - Vertices[0];
+		const FVector P = Direction ^ Edge2;
+		const double Det = Edge1 | P;
+		if (FMath::Abs(Det) < UE_DOUBLE_SMALL_NUMBER)
+		{
+			return false;
+		}
+		const double InvDet = 1.0 / Det;
+		const FVector T = Start - Vertices[0];
+		const double U = (T | P) * InvDet;
+		if (U < 0.0 || U > 1.0)
+		{
+			return false;
+		}
+		const FVector Q = T ^ Edge1;
+		const double V = (Direction | Q) * InvDet;
+		if (V < 0.0 || U + V > 1.0)
+		{
+			return false;
+		}
+		OutTime = (Edge2 | Q) * InvDet;
+		return OutTime >= 0.0 && OutTime <= 1.0;
+	}
+
+	bool TriangleBoxOverlap(const FVector& Center, const FVector& Extent, const FVector(&Vertices)[3])
+	{
+		const FVector V[3] = { Vertices[0] - Center, Vertices[1] - Center, Vertices[2] - Center };
+		const FVector Edges[3] = { V[1] - V[0], V[2] - V[1], V[0] - V[2] };
+
+		auto IsSeparated = [&V, &Extent](const FVector& Axis)
+		{
+			const double P0 = V[0] | Axis;
+			const double P1 = V[1] | Axis;
+			const double P2 = V[2] | Axis;
+			const double R = Extent.X * FMath::Abs(Axis.X) + Extent.Y * FMath::Abs(Axis.Y) + Extent.Z * FMath::Abs(Axis.Z);
+			return FMath::Min3(P0, P1, P2) > R || FMath::Max3(P0, P1, P2) < -R;
+		};
+
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			if (FMath::Min3(V[0][Axis], V[1][Axis], V[2][Axis]) > Extent[Axis] || FMath::Max3(V[0][Axis], V[1][Axis], V[2][Axis]) < -Extent[Axis])
+			{
+				return false;
+			}
+		}
+
+		const FVector BoxAxes[3] = { FVector(1, 0, 0), FVector(0, 1, 0), FVector(0, 0, 1) };
+		for (const FVector& Edge : Edges)
+		{
+			for (const FVector& BoxAxis : BoxAxes)
+			{
+				if (IsSeparated(BoxAxis ^ Edge))
+				{
+					return false;
+				}
+			}
+		}
+		return !IsSeparated(Edges[0] ^ Edges[1]);
+	}
+}
+
+FStalkerEditorAIMapWorldQuery::FStalkerEditorAIMapWorldQuery(UWorld* InWorld):World(InWorld)
+{
+	CollisionQueryParams.bTraceComplex = true;
+}
+
+bool FStalkerEditorAIMapWorldQuery::LineTrace(const FVector& Start, const FVector& End, FVector& OutLocation, FVector& OutNormal) const
+{
+	FHitResult HitResult;
+	if (World->LineTraceSingleByChannel(HitResult, Start, End, ECC_WorldStatic, CollisionQueryParams, FCollisionResponseParams(ECR_Block)))
+	{
+		OutLocation = HitResult.Location;
+		OutNormal = HitResult.Normal;
+		return true;
+	}
+	return false;
+}
+
+bool FStalkerEditorAIMapWorldQuery::OverlapBox(const FVector& Center, const FVector& Extent) const
+{
+	TArray<FHitResult> HitResults;
+	World->SweepMultiByChannel(HitResults, Center, Center, FQuat::Identity, ECC_WorldStatic, FCollisionShape::MakeBox(Extent), CollisionQueryParams, FCollisionResponseParams(ECR_Block));
+	for (FHitResult& HitResult : HitResults)
+	{
+		if (HitResult.bBlockingHit)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void FStalkerEditorAIMapWorldQuery::DrawBlockedBox(const FVector& Center, const FVector& Extent) const
+{
+	DrawDebugBox(World, Center, Extent, FColor::Red, true, 10.f);
+}
+
+void FStalkerEditorAIMapCollision::Build(UWorld* InWorld, float NodeSize)
+{
+	TArray<FVector3f> WorldVertices;
+	TArray<FStalkerCFormTriangle> WorldTriangles;
+	TArray<EStalkerEditorCFormTriangleFlags> WorldFlags;
+	FBox3f WorldAABB(ForceInit);
+	FStalkerEditorCFormCollectOptions Options;
+	Options.QueryBlockingOnly = true;
+	Options.ExpandInstances = true;
+	Options.OutFlags = &WorldFlags;
+	GStalkerEditorManager->EditorCFrom->CollectGeometry(InWorld, WorldVertices, WorldTriangles, WorldAABB, 0, Options);
+	Build(WorldVertices, WorldTriangles, WorldFlags, NodeSize);
+}
+
+void FStalkerEditorAIMapCollision::Build(const TArray<FVector3f>& InVertices, const TArray<FStalkerCFormTriangle>& InTriangles, const TArray<EStalkerEditorCFormTriangleFlags>& InFlags, float NodeSize)
+{
+	check(InFlags.Num() == InTriangles.Num());
+	Triangles.Empty(InTriangles.Num());
+	Bounds = FBox(ForceInit);
+	for (int32 TriangleIndex = 0; TriangleIndex < InTriangles.Num(); TriangleIndex++)
+	{
+		const FStalkerCFormTriangle& InTriangle = InTriangles[TriangleIndex];
+		FTriangle& Triangle = Triangles.AddDefaulted_GetRef();
+		Triangle.Vertices[0] = FVector(InVertices[InTriangle.VertexIndex0]);
+		Triangle.Vertices[1] = FVector(InVertices[InTriangle.VertexIndex1]);
+		Triangle.Vertices[2] = FVector(InVertices[InTriangle.VertexIndex2]);
+		Triangle.Normal = ((Triangle.Vertices[1] - Triangle.Vertices[0]) ^ (Triangle.Vertices[2] - Triangle.Vertices[0])).GetSafeNormal();
+		if (EnumHasAnyFlags(InFlags[TriangleIndex], EStalkerEditorCFormTriangleFlags::Mirrored))
+		{
+			Triangle.Normal = -Triangle.Normal;
+		}
+		Triangle.DoubleSided = EnumHasAnyFlags(InFlags[TriangleIndex], EStalkerEditorCFormTriangleFlags::DoubleSided);
+		Triangle.Bounds = FBox(Triangle.Vertices, 3);
+		Bounds += Triangle.Bounds;
+	}
+
+	CellStart.Reset();
+	CellTriangles.Reset();
+	CellCountX = CellCountY = 0;
+	if (!Triangles.Num())
+	{
+		return;
+	}
+
+	CellSize = FMath::Max(NodeSize * 2.0, 1.0);
+	const FVector Size = Bounds.GetSize();
+	while (Size.X / CellSize >= AIMapCollisionMaxCells || Size.Y / CellSize >= AIMapCollisionMaxCells)
+	{
+		CellSize *= 2.0;
+	}
+	CellCountX = FMath::FloorToInt32(Size.X / CellSize) + 1;
+	CellCountY = FMath::FloorToInt32(Size.Y / CellSize) + 1;
+
+	CellStart.SetNumZeroed(CellCountX * CellCountY + 1);
+	for (const FTriangle& Triangle : Triangles)
+	{
+		int32 MinX, MinY, MaxX, MaxY;
+		verify(GetCellRange(Triangle.Bounds, MinX, MinY, MaxX, MaxY));
+		for (int32 y = MinY; y <= MaxY; y++)
+		{
+			for (int32 x = MinX; x <= MaxX; x++)
+			{
+				CellStart[y * CellCountX + x + 1]++;
+			}
+		}
+	}
+	for (int32 i = 1; i < CellStart.Num(); i++)
+	{
+		CellStart[i] += CellStart[i - 1];
+	}
+
+	TArray<int32> CellFill;
+	CellFill.Append(CellStart.GetData(), CellStart.Num() - 1);
+	CellTriangles.SetNumUninitialized(CellStart.Last());
+	for (int32 TriangleIndex = 0; TriangleIndex < Triangles.Num(); TriangleIndex++)
+	{
+		int32 MinX, MinY, MaxX, MaxY;
+		GetCellRange(Triangles[TriangleIndex].Bounds, MinX, MinY, MaxX, MaxY);
+		for (int32 y = MinY; y <= MaxY; y++)
+		{
+			for (int32 x = MinX; x <= MaxX; x++)
+			{
+				CellTriangles[CellFill[y * CellCountX + x]++] = TriangleIndex;
+			}
+		}
+	}
+}
+
+bool FStalkerEditorAIMapCollision::LineTrace(const FVector& Start, const FVector& End, FVector& OutLocation, FVector& OutNormal) const
+{
+	int32 MinX, MinY, MaxX, MaxY;
+	FBox SegmentBounds(ForceInit);
+	SegmentBounds += Start;
+	SegmentBounds += End;
+	if (!GetCellRange(SegmentBounds, MinX, MinY, MaxX, MaxY))
+	{
+		return false;
+	}
+
+	const FVector Direction = End - Start;
+	double BestTime = 2.0;
+	int32 BestTriangle = INDEX_NONE;
+	for (int32 y = MinY; y <= MaxY; y++)
+	{
+		for (int32 x = MinX; x <= MaxX; x++)
+		{
+			const int32 Cell = y * CellCountX + x;
+			for (int32 i = CellStart[Cell]; i < CellStart[Cell + 1]; i++)
+			{
+				const FTriangle& Triangle = Triangles[CellTriangles[i]];
+				if (!Triangle.DoubleSided && (Triangle.Normal | Direction) >= 0)
+				{
+					continue;
+				}
+				double Time;
+				if (Triangle.Bounds.Intersect(SegmentBounds) && SegmentTriangleIntersection(Start, Direction, Triangle.Vertices, Time))
+				{
+					// Ties resolve to the lowest triangle index so results do not depend on cell order
+					if (Time < BestTime || (Time == BestTime && CellTriangles[i] < BestTriangle))
+					{
+						BestTime = Time;
+						BestTriangle = CellTriangles[i];
+					}
+				}
+			}
+		}
+	}
+	if (BestTriangle == INDEX_NONE)
+	{
+		return false;
+	}
+
+	OutLocation = Start + Direction * BestTime;
+	OutNormal = Triangles[BestTriangle].Normal;
+	if ((OutNormal | Direction) > 0)
+	{
+		OutNormal = -OutNormal;
+	}
+	return true;
+}
+
+bool FStalkerEditorAIMapCollision::OverlapBox(const FVector& Center, const FVector& Extent) const
+{
+	int32 MinX, MinY, MaxX, MaxY;
+	const FBox Box(Center - Extent, Center + Extent);
+	if (!GetCellRange(Box, MinX, MinY, MaxX, MaxY))
+	{
+		return false;
+	}
+
+	for (int32 y = MinY; y <= MaxY; y++)
+	{
+		for (int32 x = MinX; x <= MaxX; x++)
+		{
+			const int32 Cell = y * CellCountX + x;
+			for (int32 i = CellStart[Cell]; i < CellStart[Cell + 1]; i++)
+			{
+				const FTriangle& Triangle = Triangles[CellTriangles[i]];
+				if (Triangle.Bounds.Intersect(Box) && TriangleBoxOverlap(Center, Extent, Triangle.Vertices))
+				{
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+bool FStalkerEditorAIMapCollision::GetCellRange(const FBox& Box, int32& MinX, int32& MinY, int32& MaxX, int32& MaxY) const
+{
+	if (!CellCountX || !CellCountY || !Box.Intersect(Bounds))
+	{
+		return false;
+	}
+	MinX = FMath::Clamp(FMath::FloorToInt32((Box.Min.X - Bounds.Min.X) / CellSize), 0, CellCountX - 1);
+	MinY = FMath::Clamp(FMath::FloorToInt32((Box.Min.Y - Bounds.Min.Y) / CellSize), 0, CellCountY - 1);
+	MaxX = FMath::Clamp(FMath::FloorToInt32((Box.Max.X - Bounds.Min.X) / CellSize), 0, CellCountX - 1);
+	MaxY = FMath::Clamp(FMath::FloorToInt32((Box.Max.Y - Bounds.Min.Y) / CellSize), 0, CellCountY - 1);
+	return true;
+}
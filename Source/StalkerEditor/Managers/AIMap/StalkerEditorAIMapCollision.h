@@ -0,0 +1,62 @@
+#pragma once
+enum class EStalkerEditorCFormTriangleFlags : uint8;
+
+struct FStalkerEditorAIMapSettings
+{
+	float NodeSize		= 70.f;
+	float CanUP			= 150.f;
+	float CanDOWN		= 400.f;
+	float TestHeight	= 150.f;
+};
+
+class FStalkerEditorAIMapQuery
+{
+public:
+	virtual					~FStalkerEditorAIMapQuery	() {}
+	virtual bool			LineTrace					(const FVector& Start, const FVector& End, FVector& OutLocation, FVector& OutNormal) const = 0;
+	virtual bool			OverlapBox					(const FVector& Center, const FVector& Extent) const = 0;
+	virtual bool			IsThreadSafe				() const { return false; }
+	virtual void			DrawBlockedBox				(const FVector& Center, const FVector& Extent) const {}
+};
+
+class FStalkerEditorAIMapWorldQuery : public FStalkerEditorAIMapQuery
+{
+public:
+							FStalkerEditorAIMapWorldQuery(UWorld* InWorld);
+	bool					LineTrace					(const FVector& Start, const FVector& End, FVector& OutLocation, FVector& OutNormal) const override;
+	bool					OverlapBox					(const FVector& Center, const FVector& Extent) const override;
+	void					DrawBlockedBox				(const FVector& Center, const FVector& Extent) const override;
+private:
+	UWorld*					World;
+	FCollisionQueryParams	CollisionQueryParams;
+};
+
+// Immutable triangle snapshot of the static level geometry that blocks ECC_WorldStatic, safe to query from any thread after Build.
+// Line traces hit single sided triangles from the front only, as the complex world trace does.
+class FStalkerEditorAIMapCollision : public FStalkerEditorAIMapQuery
+{
+public:
+	void					Build						(UWorld* InWorld, float NodeSize);
+	void					Build						(const TArray<FVector3f>& InVertices, const TArray<struct FStalkerCFormTriangle>& InTriangles, const TArray<EStalkerEditorCFormTriangleFlags>& InFlags, float NodeSize);
+	bool					LineTrace					(const FVector& Start, const FVector& End, FVector& OutLocation, FVector& OutNormal) const override;
+	bool					OverlapBox					(const FVector& Center, const FVector& Extent) const override;
+	bool					IsThreadSafe				() const override { return true; }
+	inline int32			GetTrianglesNum				() const { return Triangles.Num(); }
+private:
+	bool					GetCellRange				(const FBox& Box, int32& MinX, int32& MinY, int32& MaxX, int32& MaxY) const;
+
+	struct FTriangle
+	{
+		FVector				Vertices[3];
+		FVector				Normal;
+		FBox				Bounds;
+		bool				DoubleSided;
+	};
+	TArray<FTriangle>		Triangles;
+	TArray<int32>			CellStart;
+	TArray<int32>			CellTriangles;
+	FBox					Bounds;
+	double					CellSize = 0;
+	int32					CellCountX = 0;
+	int32					CellCountY = 0;
+};
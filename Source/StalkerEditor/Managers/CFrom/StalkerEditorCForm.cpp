@@ -7,6 +7,8 @@
 #include "Kernel/StalkerEngineManager.h"
 #include "Components/BrushComponent.h"
 #include "Components/StaticMeshComponent.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "PhysicsEngine/BodySetup.h"
 #include "Resources/PhysicalMaterial/StalkerPhysicalMaterial.h"
 #include "LandscapeDataAccess.h"
 #include "LandscapeProxy.h"
@@ -66,11 +68,37 @@ void UStalkerEditorCForm::Build()
 	int32 DefaultID = GStalkerEngineManager->GetPhysicalMaterialsManager()->PhysicalMaterials.IndexOfByKey(GStalkerEngineManager->GetPhysicalMaterialsManager()->DefaultPhysicalMaterial);
 	check(DefaultID != INDEX_NONE);
 
+	CollectGeometry(World, CForm->Vertices, CForm->Triangles, CForm->AABB, DefaultID);
+
+	PhysicalMaterial2ID.Empty(PhysicalMaterial2ID.Num());
+
+
+	GStalkerEngineManager->GetPhysicalMaterialsManager()->Clear();
+	CForm->Modify();
+	if (CForm->Triangles.Num() == 0)
+	{
+		UE_LOG(LogStalkerEditor,Warning,TEXT("CFrom is empty in world %s"),*World->GetPathName())
+	}
+}
+
+void UStalkerEditorCForm::CollectGeometry(UWorld* World, TArray<FVector3f>& OutVertices, TArray<FStalkerCFormTriangle>& OutTriangles, FBox3f& OutAABB, int32 DefaultID, const FStalkerEditorCFormCollectOptions& Options)
+{
+	auto FillFlags = [&Options, &OutTriangles](EStalkerEditorCFormTriangleFlags Flags)
+	{
+		if (Options.OutFlags)
+		{
+			while (Options.OutFlags->Num() < OutTriangles.Num())
+			{
+				Options.OutFlags->Add(Flags);
+			}
+		}
+	};
+
 	const int32 TerrainExportLOD = 0;
 	for (auto& WorldVertex : World->GetModel()->Points)
 	{
-		CForm->Vertices.Add(WorldVertex);
-		CForm->AABB += WorldVertex;
+		OutVertices.Add(WorldVertex);
+		OutAABB += WorldVertex;
 	}
 	
 	for (auto& WorldNode : World->GetModel()->Nodes)
@@ -96,12 +124,15 @@ void UStalkerEditorCForm::Build()
 			Triangle.VertexIndex0 = Index0;
 			Triangle.VertexIndex1 = Index1;
 			Triangle.VertexIndex2 = Index2;
-			CForm->Triangles.Add(Triangle);
+			OutTriangles.Add(Triangle);
 			Index1 = Index2;
 		}
 	}
+	FillFlags(EStalkerEditorCFormTriangleFlags::DoubleSided);
+
 	FTriMeshCollisionData MeshColisionData = {};
 	TArray<UStaticMeshComponent*>StaticMeshComponents;
+	TArray<FTransform, TInlineAllocator<1>> Transforms;
 	for (TActorIterator<AActor> AactorItr(World); AactorItr; ++AactorItr)
 	{
 		
@@ -113,44 +144,76 @@ void UStalkerEditorCForm::Build()
 				StaticMeshComponent->GetStaticMesh()->HasValidRenderData()
 				)
 			{
+				if (Options.QueryBlockingOnly && !(CollisionEnabledHasQuery(StaticMeshComponent->GetCollisionEnabled()) && StaticMeshComponent->GetCollisionResponseToChannel(ECC_WorldStatic) == ECR_Block))
+				{
+					continue;
+				}
 
-				FStaticMeshLODResources& LODModel = StaticMeshComponent->GetStaticMesh()->GetRenderData()->LODResources[0];
-				FIndexArrayView Indices = LODModel.IndexBuffer.GetArrayView();
 				MeshColisionData.UVs.Reset();
 				MeshColisionData.Vertices.Reset();
 				MeshColisionData.Indices.Reset();
 				MeshColisionData.MaterialIndices.Reset();
 				StaticMeshComponent->GetStaticMesh()->GetPhysicsTriMeshData(&MeshColisionData, false);
 
-				int32 StartVertexIdx = CForm->Vertices.Num();
-
-				for (FVector3f& InVertex : MeshColisionData.Vertices)
+				Transforms.Reset();
+				UInstancedStaticMeshComponent* InstancedStaticMeshComponent = Options.ExpandInstances ? Cast<UInstancedStaticMeshComponent>(StaticMeshComponent) : nullptr;
+				if (InstancedStaticMeshComponent)
 				{
-					FVector3f Vertex = FVector3f(StaticMeshComponent->GetComponentTransform().TransformPosition(FVector(InVertex)));
-					CForm->Vertices.Add(Vertex);
+					for (int32 InstanceIndex = 0; InstanceIndex < InstancedStaticMeshComponent->GetInstanceCount(); InstanceIndex++)
+					{
+						InstancedStaticMeshComponent->GetInstanceTransform(InstanceIndex, Transforms.AddDefaulted_GetRef(), true);
+					}
+				}
+				else
+				{
+					Transforms.Add(StaticMeshComponent->GetComponentTransform());
 				}
 
-				for (int32 i = 0; i < MeshColisionData.Indices.Num(); ++i)
+				const UBodySetup* BodySetup = StaticMeshComponent->GetStaticMesh()->GetBodySetup();
+				const bool DoubleSided = BodySetup && BodySetup->bDoubleSidedGeometry;
+				for (const FTransform& Transform : Transforms)
 				{
-					UMaterialInterface* Material = StaticMeshComponent->GetMaterial(MeshColisionData.MaterialIndices[i]);
+					int32 StartVertexIdx = OutVertices.Num();
 
-					UPhysicalMaterial* PhysMaterial = Material ? Material->GetPhysicalMaterial() : nullptr;
-					int32* IndexMaterial = PhysicalMaterial2ID.Find(Cast<UStalkerPhysicalMaterial>(PhysMaterial));
-					FStalkerCFormTriangle Triangle;
-					Triangle.MaterialIndex = IndexMaterial ? static_cast<uint32>(*IndexMaterial) : DefaultID;
+					for (FVector3f& InVertex : MeshColisionData.Vertices)
+					{
+						FVector3f Vertex = FVector3f(Transform.TransformPosition(FVector(InVertex)));
+						OutVertices.Add(Vertex);
+					}
 
-					Triangle.VertexIndex0 = StartVertexIdx + MeshColisionData.Indices[i].v0;
-					Triangle.VertexIndex1 = StartVertexIdx + MeshColisionData.Indices[i].v2;
-					Triangle.VertexIndex2 = StartVertexIdx + MeshColisionData.Indices[i].v1;
-					CForm->Triangles.Add(Triangle);
-		
+					for (int32 i = 0; i < MeshColisionData.Indices.Num(); ++i)
+					{
+						UMaterialInterface* Material = StaticMeshComponent->GetMaterial(MeshColisionData.MaterialIndices[i]);
+
+						UPhysicalMaterial* PhysMaterial = Material ? Material->GetPhysicalMaterial() : nullptr;
+						int32* IndexMaterial = PhysicalMaterial2ID.Find(Cast<UStalkerPhysicalMaterial>(PhysMaterial));
+						FStalkerCFormTriangle Triangle;
+						Triangle.MaterialIndex = IndexMaterial ? static_cast<uint32>(*IndexMaterial) : DefaultID;
+
+						Triangle.VertexIndex0 = StartVertexIdx + MeshColisionData.Indices[i].v0;
+						Triangle.VertexIndex1 = StartVertexIdx + MeshColisionData.Indices[i].v2;
+						Triangle.VertexIndex2 = StartVertexIdx + MeshColisionData.Indices[i].v1;
+						OutTriangles.Add(Triangle);
+			
+					}
+
+					EStalkerEditorCFormTriangleFlags Flags = DoubleSided ? EStalkerEditorCFormTriangleFlags::DoubleSided : EStalkerEditorCFormTriangleFlags::None;
+					if (Transform.GetDeterminant() < 0)
+					{
+						Flags |= EStalkerEditorCFormTriangleFlags::Mirrored;
+					}
+					FillFlags(Flags);
 				}
 
-				CForm->AABB +=	FBox3f(StaticMeshComponent->Bounds.GetBox());
+				OutAABB +=	FBox3f(StaticMeshComponent->Bounds.GetBox());
 			}
 
 		}
 		ALandscapeProxy* LandscapeProxy = Cast<ALandscapeProxy>(*AactorItr);
+		if (LandscapeProxy && Options.QueryBlockingOnly && !(CollisionEnabledHasQuery(LandscapeProxy->BodyInstance.GetCollisionEnabled()) && LandscapeProxy->BodyInstance.GetResponseToChannel(ECC_WorldStatic) == ECR_Block))
+		{
+			LandscapeProxy = nullptr;
+		}
 		if (LandscapeProxy)
 		{
 			const int32 ComponentSizeQuads = ((LandscapeProxy->ComponentSizeQuads + 1) >> TerrainExportLOD) - 1;
@@ -187,11 +250,11 @@ void UStalkerEditorCForm::Build()
 				{
 					for (auto x = 0; x < LandscapeComponent->ComponentSizeQuads; ++x)
 					{
-						auto StartIndex = CForm->Vertices.Num();
-						CForm->Vertices.Add(FVector3f(CDI.GetWorldVertex(x, y)));
-						CForm->Vertices.Add(FVector3f(CDI.GetWorldVertex(x, y + 1)));
-						CForm->Vertices.Add(FVector3f(CDI.GetWorldVertex(x + 1, y + 1)));
-						CForm->Vertices.Add(FVector3f(CDI.GetWorldVertex(x + 1, y)));
+						auto StartIndex = OutVertices.Num();
+						OutVertices.Add(FVector3f(CDI.GetWorldVertex(x, y)));
+						OutVertices.Add(FVector3f(CDI.GetWorldVertex(x, y + 1)));
+						OutVertices.Add(FVector3f(CDI.GetWorldVertex(x + 1, y + 1)));
+						OutVertices.Add(FVector3f(CDI.GetWorldVertex(x + 1, y)));
 
 
 						FVector2D TextureUV0 = FVector2D(x * ScaleFactor + LandscapeComponent->GetSectionBase().X, y * ScaleFactor + LandscapeComponent->GetSectionBase().Y);
@@ -225,7 +288,7 @@ void UStalkerEditorCForm::Build()
 						Triangle.VertexIndex0 = StartIndex;
 						Triangle.VertexIndex2 = StartIndex + 2;
 						Triangle.VertexIndex1 = StartIndex + 3;
-						CForm->Triangles.Add(Triangle);
+						OutTriangles.Add(Triangle);
 
 						FVector2D TextureUV_T1 = (((TextureUV0 + TextureUV1 + TextureUV2) / 3.f) - FVector2D(MinX, MinY)) * UVScale;
 
@@ -247,23 +310,14 @@ void UStalkerEditorCForm::Build()
 						Triangle.VertexIndex0 = StartIndex;
 						Triangle.VertexIndex2 = StartIndex + 1;
 						Triangle.VertexIndex1 = StartIndex + 2;
-						CForm->Triangles.Add(Triangle);
+						OutTriangles.Add(Triangle);
 
 					}
 				}
-				CForm->AABB += FBox3f(LandscapeComponent->Bounds.GetBox());
+				OutAABB += FBox3f(LandscapeComponent->Bounds.GetBox());
 			}
+			FillFlags(EStalkerEditorCFormTriangleFlags::None);
 		}
 		
 	}
-
-	PhysicalMaterial2ID.Empty(PhysicalMaterial2ID.Num());
-
-
-	GStalkerEngineManager->GetPhysicalMaterialsManager()->Clear();
-	CForm->Modify();
-	if (CForm->Triangles.Num() == 0)
-	{
-		UE_LOG(LogStalkerEditor,Warning,TEXT("CFrom is empty in world %s"),*World->GetPathName())
-	}
 }
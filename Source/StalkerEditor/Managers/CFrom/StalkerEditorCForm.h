@@ -1,5 +1,26 @@
 #pragma once
 #include "StalkerEditorCForm.generated.h"
+
+enum class EStalkerEditorCFormTriangleFlags : uint8
+{
+	None		= 0,
+	// Collision queries hit both sides of the triangle
+	DoubleSided	= 1 << 0,
+	// Added with a mirroring transform, the front side is opposite to the winding
+	Mirrored	= 1 << 1,
+};
+ENUM_CLASS_FLAGS(EStalkerEditorCFormTriangleFlags);
+
+struct FStalkerEditorCFormCollectOptions
+{
+	// Skip geometry that does not block ECC_WorldStatic queries
+	bool										QueryBlockingOnly = false;
+	// Add every instance of instanced static mesh components instead of the component transform alone
+	bool										ExpandInstances = false;
+	// Receives the flags of every collected triangle when set
+	TArray<EStalkerEditorCFormTriangleFlags>*	OutFlags = nullptr;
+};
+
 UCLASS()
 class UStalkerEditorCForm : public UObject
 {
@@ -8,6 +29,8 @@ public:
 	void	Initialize				();
 	void	Destroy					();
 	void	Build					();
+	// Collects static level geometry (BSP, static meshes, landscapes) as triangles, materials not found in PhysicalMaterial2ID get DefaultID
+	void	CollectGeometry			(UWorld* World, TArray<FVector3f>& OutVertices, TArray<struct FStalkerCFormTriangle>& OutTriangles, FBox3f& OutAABB, int32 DefaultID = 0, const FStalkerEditorCFormCollectOptions& Options = FStalkerEditorCFormCollectOptions());
 private:
 	//void	OnGetOnScreenMessages	(FCoreDelegates::FSeverityMessageMap& Out);
 
@@ -46,6 +46,8 @@ bool CGameSpawnConstructor::load_spawns	(UStalkerGameSpawn* GameSpawn, TArray<US
 	m_spawn_graph						= new SPAWN_GRAPH;
 	m_patrol_path_storage				= new CPatrolPathStorage;
 	m_game_graph						= &GameSpawn->GameGraph;
+	m_game_spawn						= GameSpawn;
+	check								(GameSpawn->LevelsInfo.Num() == LevelsSpawns.Num());
 	
 	for (UStalkerLevelSpawn* LevelsSpawn : LevelsSpawns)
 	{
@@ -62,22 +64,49 @@ bool CGameSpawnConstructor::load_spawns	(UStalkerGameSpawn* GameSpawn, TArray<US
 
 bool CGameSpawnConstructor::process_spawns	()
 {
-	LEVEL_SPAWN_STORAGE::iterator		I = m_level_spawns.begin();
-	LEVEL_SPAWN_STORAGE::iterator		E = m_level_spawns.end();
-	for (CLevelSpawnConstructor*Level: m_level_spawns)
+	TArray<double>						BuildTimes;
+	TArray<double>						UpdateTimes;
+	TArray<bool>						Cached;
+	BuildTimes.AddZeroed				(int32(m_level_spawns.size()));
+	UpdateTimes.AddZeroed				(int32(m_level_spawns.size()));
+	Cached.AddZeroed					(int32(m_level_spawns.size()));
+	for (int32 i = 0; i < int32(m_level_spawns.size()); i++)
 	{
-		if (!Level->build())
+		// a level only carries built objects when its content is unchanged since they were saved
+		FStalkerGameSpawnLevelInfo&		LevelInfo = m_game_spawn->LevelsInfo[i];
+		Cached[i]						= LevelInfo.BuiltSpawns.Num() != 0;
+		const double					StartTime = FPlatformTime::Seconds();
+		if (Cached[i])
 		{
-			return false;
+			if (!m_level_spawns[i]->build_cached(LevelInfo))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			if (!m_level_spawns[i]->build())
+			{
+				return false;
+			}
+			m_level_spawns[i]->save_build(LevelInfo);
 		}
+		BuildTimes[i]					= FPlatformTime::Seconds() - StartTime;
 	}
 
-	for (CLevelSpawnConstructor* Level : m_level_spawns)
+	for (int32 i = 0; i < int32(m_level_spawns.size()); i++)
 	{
-		if (!Level->update())
+		const double					StartTime = FPlatformTime::Seconds();
+		if (!m_level_spawns[i]->update())
 		{
 			return false;
 		}
+		UpdateTimes[i]					= FPlatformTime::Seconds() - StartTime;
+	}
+
+	for (int32 i = 0; i < int32(m_level_spawns.size()); i++)
+	{
+		UE_LOG(LogXRayGameSpawnConstructor, Log, TEXT("Level %s : %s in %.3f s, update %.3f s"), *m_game_spawn->LevelsInfo[i].Name, Cached[i] ? TEXT("reused") : TEXT("built"), BuildTimes[i], UpdateTimes[i]);
 	}
 
 	if (!verify_level_changers())
@@ -232,6 +261,7 @@ bool CGameSpawnConstructor::process_actor			()
 
 CGameSpawnConstructor::CGameSpawnConstructor()
 {
+	m_game_spawn					= nullptr;
 }
 
 bool CGameSpawnConstructor::build(UStalkerGameSpawn* GameSpawn, TArray<UStalkerLevelSpawn*>& LevelsSpawn, bool no_separator_check)
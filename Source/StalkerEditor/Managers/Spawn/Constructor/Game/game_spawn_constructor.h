@@ -71,6 +71,7 @@ private:
 
 private:
 	IGameGraph						*m_game_graph;
+	class UStalkerGameSpawn			*m_game_spawn;
 	SPAWN_GRAPH						*m_spawn_graph;
 	CPatrolPathStorage				*m_patrol_path_storage;
 	//CInifile						*m_game_info;
@@ -9,12 +9,14 @@
 #include "level_spawn_constructor.h"
 #include "../Game/game_spawn_constructor.h"
 #include "../PatrolPaths/Storage/patrol_path_storage.h"
-#include "../../Graph/Engine/graph_engine_editor.h"
+#include "../../Graph/Engine/graph_engine_editor_pool.h"
+#include "../../Graph/Index/graph_point_index.h"
 #include "../../../../StalkerEditorManager.h"
 #include "../../../SEFactory/StalkerSEFactoryManager.h"
 #include "Resources/AIMap/StalkerAIMap.h"
 #include "SpaceRestrictorWrapper/space_restrictor_wrapper.h"
 #include "Kernel/Unreal/GameSettings/StalkerGameSettings.h"
+#include "Resources/Spawn/StalkerGameSpawn.h"
 THIRD_PARTY_INCLUDES_START
 #include "xrServerEntities/xrMessages.h"
 #include "xrServerEntities/clsid_game.h"
@@ -38,7 +40,7 @@ CLevelSpawnConstructor::~CLevelSpawnConstructor					()
 	}
 	checkSlow					(!m_level_graph);
 	checkSlow					(!m_cross_table);
-	checkSlow					(!m_graph_engine);
+	checkSlow					(!m_graph_engines);
 }
 
 IC	const IGameGraph &CLevelSpawnConstructor::game_graph		() const
@@ -66,9 +68,9 @@ IC	const IGameLevelCrossTable &CLevelSpawnConstructor::cross_table	() const
 	return					(*m_cross_table);
 }
 
-IC	CGraphEngineEditor &CLevelSpawnConstructor::graph_engine			() const
+IC	CGraphEngineEditorPool &CLevelSpawnConstructor::graph_engines		() const
 {
-	return					(*m_graph_engine);
+	return					(*m_graph_engines);
 }
 
 void CLevelSpawnConstructor::init								()
@@ -307,110 +309,180 @@ struct remove_too_far_predicate {
 };
 
 
-void CLevelSpawnConstructor::generate_artefact_spawn_positions	()
+void CLevelSpawnConstructor::shuffle_artefact_spawn_vertices	(xr_vector<u32> &level_vertices, u32 level_seed, LPCSTR zone_name)
 {
-	checkSlow(!m_graph_engine);
-	m_graph_engine = new CGraphEngineEditor(m_level_graph->header().vertex_count());
-	// create graph engine
-
-	UE_LOG(LogXRayLevelSpawnConstructor,Log,TEXT("Generate artefact spawn positions ..."));
-	
-	FCriticalSection GenerateArtefactSpawnMutex;
-	FCriticalSection GenerateArtefactSpawnLevelPointsMutex;
-	ParallelFor(m_spawns.size(), [this,&GenerateArtefactSpawnMutex,&GenerateArtefactSpawnLevelPointsMutex](int32 Index)
+	// seeded by the zone name, so the choice does not depend on the build order or thread count
+	FRandomStream						RandomStream(int32(HashCombine(level_seed, FCrc::StrCrc32(zone_name))));
+	for (int32 i = level_vertices.size() - 1; i > 0; --i)
 	{
+		Swap(level_vertices[i], level_vertices[RandomStream.RandRange(0, i)]);
+	}
+}
 
-		ISE_ALifeObject* Object = m_spawns[Index];
-		ISE_ALifeAnomalousZone* zone = Object->CastALifeAnomalousZone();
-		if (!zone)
-			return;
-		ISE_Abstract* Abstract = Object->CastAbstract();
-		Object->m_tNodeID = level_graph().vertex(Object->m_tNodeID, Abstract->o_Position);
-		if (!level_graph().valid_vertex_position(Abstract->o_Position) || !level_graph().inside(Object->m_tNodeID, Abstract->o_Position))
-			Object->m_tNodeID = level_graph().vertex(u32(-1), Abstract->o_Position);
-
-		const IGameLevelCrossTable::CCell& cell = cross_table().vertex(Object->m_tNodeID);
-		Object->m_tGraphID = cell.game_vertex_id();
-		Object->m_fDistance = cell.distance();
+void CLevelSpawnConstructor::find_artefact_spawn_positions	(const ILevelGraph &level_graph, const IGameLevelCrossTable &cross_table, CGraphEngineEditorPool &graph_engines, u32 level_seed, ARTEFACT_SPAWN_ZONES &zones, LEVEL_POINT_STORAGE &level_points)
+{
+	// every zone floods with its own engine and keeps its points apart, they are appended in zone order afterwards
+	xr_vector<LEVEL_POINT_STORAGE>		zone_level_points(zones.size());
+	graph_engines.parallel_for(u32(zones.size()), [&level_graph,&cross_table,level_seed,&zones,&zone_level_points](u32 Index, CGraphEngineEditor& GraphEngine)
+	{
+		SArtefactSpawnZone&					zone = zones[Index];
+		zone.level_vertex_id = level_graph.vertex(zone.level_vertex_id, zone.position);
+		if (!level_graph.valid_vertex_position(zone.position) || !level_graph.inside(zone.level_vertex_id, zone.position))
+			zone.level_vertex_id = level_graph.vertex(u32(-1), zone.position);
 
 		xr_vector<u32>						l_tpaStack;
 		l_tpaStack.reserve(1024);
 
-		{
-			FScopeLock lock(&GenerateArtefactSpawnMutex);
-			graph_engine().search(level_graph(),Object->m_tNodeID,Object->m_tNodeID,&l_tpaStack,SFlooder<float,u32,u32>(zone->m_offline_interactive_radius,	u32(-1),u32(-1)));
-		}
+		GraphEngine.search(level_graph,zone.level_vertex_id,zone.level_vertex_id,&l_tpaStack,SFlooder<float,u32,u32>(zone.radius,	u32(-1),u32(-1)));
 		
-		l_tpaStack.erase(std::remove_if(l_tpaStack.begin(),l_tpaStack.end(),remove_too_far_predicate(&level_graph(),Abstract->o_Position,zone->m_offline_interactive_radius)),l_tpaStack.end());
+		l_tpaStack.erase(std::remove_if(l_tpaStack.begin(),l_tpaStack.end(),remove_too_far_predicate(&level_graph,zone.position,zone.radius)),l_tpaStack.end());
 
-		if (zone->m_artefact_spawn_count >= l_tpaStack.size())
+		if (zone.artefact_spawn_count >= l_tpaStack.size())
 		{
-			zone->m_artefact_spawn_count = l_tpaStack.size();
+			zone.artefact_spawn_count = l_tpaStack.size();
 		}
 		else
 		{
-			for (int32 i = l_tpaStack.size() - 1; i > 0; --i)
-			{
-				Swap(l_tpaStack[i], l_tpaStack[FMath::Rand() % (i + 1)]);
-			}
+			shuffle_artefact_spawn_vertices(l_tpaStack, level_seed, zone.name);
 		}
-		LEVEL_POINT_STORAGE					LevelPoints;
-		LevelPoints.resize(zone->m_artefact_spawn_count);
+		LEVEL_POINT_STORAGE&				LevelPoints = zone_level_points[Index];
+		LevelPoints.resize(zone.artefact_spawn_count);
 
-		for (int32 i=0;i< zone->m_artefact_spawn_count;i++)
+		for (u32 i=0;i< zone.artefact_spawn_count;i++)
 		{
 			LevelPoints[i].tNodeID = l_tpaStack[i];
-			LevelPoints[i].tPoint = level_graph().vertex_position(l_tpaStack[i]);
-			LevelPoints[i].fDistance = cross_table().vertex(l_tpaStack[i]).distance();
+			LevelPoints[i].tPoint = level_graph.vertex_position(l_tpaStack[i]);
+			LevelPoints[i].fDistance = cross_table.vertex(l_tpaStack[i]).distance();
 		}
+	});
+
+	for (u32 Index = 0; Index < u32(zones.size()); Index++)
+	{
+		zones[Index].artefact_position_offset = level_points.size();
+		level_points.insert(level_points.end(), zone_level_points[Index].begin(), zone_level_points[Index].end());
+	}
+}
+
+void CLevelSpawnConstructor::generate_artefact_spawn_positions	()
+{
+	checkSlow(!m_graph_engines);
+	m_graph_engines = new CGraphEngineEditorPool(m_level_graph->header().vertex_count());
+	// create graph engines
 
+	UE_LOG(LogXRayLevelSpawnConstructor,Log,TEXT("Generate artefact spawn positions ..."));
+	
+	ARTEFACT_SPAWN_ZONES				zones;
+	SPAWN_STORAGE						zone_objects;
+	for (ISE_ALifeObject* Object : m_spawns)
+	{
+		ISE_ALifeAnomalousZone* zone = Object->CastALifeAnomalousZone();
+		if (!zone)
+			continue;
+		ISE_Abstract* Abstract = Object->CastAbstract();
+		zones.push_back({ Abstract->name_replace(), Abstract->o_Position, zone->m_offline_interactive_radius, Object->m_tNodeID, u32(zone->m_artefact_spawn_count), 0 });
+		zone_objects.push_back(Object);
+	}
+
+	const uint32						LevelSeed = HashCombine(GetTypeHash(GetDefault<UStalkerGameSettings>()->ArtefactSpawnSeed), GetTypeHash(LevelSpawn->LevelID));
+	find_artefact_spawn_positions(level_graph(), cross_table(), graph_engines(), LevelSeed, zones, m_level_points);
+
+	for (u32 Index = 0; Index < u32(zones.size()); Index++)
+	{
+		ISE_ALifeObject* Object = zone_objects[Index];
+		ISE_ALifeAnomalousZone* zone = Object->CastALifeAnomalousZone();
+		Object->m_tNodeID = zones[Index].level_vertex_id;
+		const IGameLevelCrossTable::CCell& cell = cross_table().vertex(Object->m_tNodeID);
+		Object->m_tGraphID = cell.game_vertex_id();
+		Object->m_fDistance = cell.distance();
+		zone->m_artefact_spawn_count = static_cast<decltype(zone->m_artefact_spawn_count)>(zones[Index].artefact_spawn_count);
+		zone->m_artefact_position_offset = zones[Index].artefact_position_offset;
+	}
+	UE_LOG(LogXRayLevelSpawnConstructor, Log, TEXT("* Completed gnerate artefact spawn positions"));
+}
+
+void CLevelSpawnConstructor::resolve_level_changer_targets	(const NAMED_POINTS &graph_points, const xr_vector<std::pair<u32,Fvector>> &game_vertices, const xr_vector<shared_str> &targets, xr_vector<std::pair<u32,u32>> &results)
+{
+	// first graph point with a name wins, as the level changers used to take the first match
+	TMap<shared_str,u32>				graph_point_names;
+	graph_point_names.Reserve			(graph_points.size());
+	for (u32 i=0, n=u32(graph_points.size()); i<n; ++i)
+	{
+		if (!graph_point_names.Contains(graph_points[i].name))
+			graph_point_names.Add		(graph_points[i].name,i);
+	}
+
+	CGraphPointIndex					vertices(.001f);
+	for (u32 i=0, n=u32(game_vertices.size()); i<n; ++i)
+		vertices.add					(game_vertices[i].second,i);
+
+	results.resize						(targets.size());
+	for (u32 i=0, n=u32(targets.size()); i<n; ++i)
+	{
+		const u32*						graph_point = graph_point_names.Find(targets[i]);
+		if (!graph_point)
 		{
-			FScopeLock lock(&GenerateArtefactSpawnLevelPointsMutex);
-			zone->m_artefact_position_offset = m_level_points.size();
-			m_level_points.insert(m_level_points.end(), LevelPoints.begin(), LevelPoints.end());
+			results[i]					= std::make_pair(u32(-1),u32(-1));
+			continue;
 		}
-	});
-	UE_LOG(LogXRayLevelSpawnConstructor, Log, TEXT("* Completed gnerate artefact spawn positions"));
+
+		const Fvector&					position = graph_points[*graph_point].position;
+		u32								vertex = vertices.find(position,[&game_vertices,&position](u32 vertex)
+		{
+			return						(game_vertices[vertex].second.similar(position,.001f));
+		});
+		results[i]						= std::make_pair(*graph_point,vertex == u32(-1) ? u32(-1) : game_vertices[vertex].first);
+	}
 }
 
 void CLevelSpawnConstructor::fill_level_changers				()
 {
-	for (u32 i=0, n=(u32)level_changers().size(); i<n; ++i) {
-		if (level_id(level_changers()[i]->m_caLevelToChange) != LevelSpawn->LevelID)
+	NAMED_POINTS						graph_points;
+	graph_points.reserve				(m_graph_points.size());
+	for (ISE_ALifeGraphPoint* graph_point : m_graph_points)
+		graph_points.push_back			({ graph_point->CastAbstract()->name_replace(), graph_point->CastAbstract()->o_Position });
+
+	xr_vector<std::pair<u32,Fvector>>	game_vertices;
+	for (u32 ii=0, nn = game_graph().header().vertex_count(); ii<nn; ++ii)
+		if (game_graph().vertex(ii)->level_id() == LevelSpawn->LevelID)
+			game_vertices.push_back		(std::make_pair(ii,game_graph().vertex(ii)->level_point()));
+
+	xr_vector<shared_str>				targets;
+	for (ISE_ALifeLevelChanger* level_changer : level_changers())
+		targets.push_back				(level_changer->m_caLevelPointToChange);
+
+	xr_vector<std::pair<u32,u32>>		results;
+	resolve_level_changer_targets		(graph_points,game_vertices,targets,results);
+
+	// changers into this level with a graph point are resolved and leave the list, in one pass keeping the order of the rest
+	u32									kept = 0;
+	for (u32 i=0, n=u32(level_changers().size()); i<n; ++i)
+	{
+		ISE_ALifeLevelChanger*			level_changer = level_changers()[i];
+		if (level_id(level_changer->m_caLevelToChange) != LevelSpawn->LevelID)
+		{
+			level_changers()[kept++]	= level_changer;
 			continue;
+		}
 
-		bool found = false;
-		GRAPH_POINT_STORAGE::const_iterator I = m_graph_points.begin();
-		GRAPH_POINT_STORAGE::const_iterator E = m_graph_points.end();
-		for ( ; I != E; ++I)
-			if (!xr_strcmp(*level_changers()[i]->m_caLevelPointToChange,(*I)->CastAbstract()->name_replace())) {
-				bool ok = false;
-				for (u32 ii=0, nn = game_graph().header().vertex_count(); ii<nn; ++ii) 
-				{
-					if ((game_graph().vertex(ii)->level_id() != LevelSpawn->LevelID) || !game_graph().vertex(ii)->level_point().similar((*I)->CastAbstract()->o_Position,.001f))
-						continue;
-					level_changers()[i]->m_tNextGraphID		= (GameGraph::_GRAPH_ID)ii;
-					level_changers()[i]->m_tNextPosition	= (*I)->CastAbstract()->o_Position;
-					level_changers()[i]->m_tAngles			= (*I)->CastAbstract()->o_Angle;
-					level_changers()[i]->m_dwNextNodeID		= game_graph().vertex(ii)->level_vertex_id();
-					ok										= true;
-					break;
-				}
-
-				check					(ok);//,"Cannot find a correspndance between graph and graph points from level editor! Rebuild graph for the level ",*level_changers()[i]->m_caLevelToChange
-
-				level_changers().erase		(level_changers().begin() + i);
-				--i;
-				--n;
-				found		= true;
-				break;
-			}
+		if (results[i].first == u32(-1)) 
+		{
+			UE_LOG(LogXRayLevelSpawnConstructor, Warning, TEXT("Graph point %S not found (level changer %S)"), *level_changer->m_caLevelPointToChange, level_changer->CastAbstract()->name_replace());
+			level_changers()[kept++]	= level_changer;
+			continue;
+		}
 
-		if (!found) 
+		const u32						ii = results[i].second;
+		check							(ii != u32(-1));//,"Cannot find a correspndance between graph and graph points from level editor! Rebuild graph for the level ",*level_changers()[i]->m_caLevelToChange
+		if (ii != u32(-1))
 		{
-			UE_LOG(LogXRayLevelSpawnConstructor, Warning, TEXT("Graph point %S not found (level changer %S)"), *level_changers()[i]->m_caLevelPointToChange, level_changers()[i]->CastAbstract()->name_replace());
+			ISE_Abstract*				graph_point = m_graph_points[results[i].first]->CastAbstract();
+			level_changer->m_tNextGraphID	= (GameGraph::_GRAPH_ID)ii;
+			level_changer->m_tNextPosition	= graph_point->o_Position;
+			level_changer->m_tAngles		= graph_point->o_Angle;
+			level_changer->m_dwNextNodeID	= game_graph().vertex(ii)->level_vertex_id();
 		}
 	}
+	level_changers().resize				(kept);
 }
 
 void CLevelSpawnConstructor::update_artefact_spawn_positions	()
@@ -434,23 +506,36 @@ void CLevelSpawnConstructor::update_artefact_spawn_positions	()
 	m_game_spawn_constructor->add_level_points	(m_level_points);
 }
 
+u32 CLevelSpawnConstructor::level_vertex_offset					() const
+{
+	for (u32 i=0; i<game_graph().header().vertex_count(); ++i)
+		if (game_graph().vertex(i)->level_id() == LevelSpawn->LevelID)
+			return			(i);
+	return					(u32(-1));
+}
+
+void CLevelSpawnConstructor::release_level						()
+{
+	m_cross_table						= 0;
+	m_level_graph						= 0;
+	delete								m_graph_engines;
+	m_graph_engines						= 0;
+}
+
 bool CLevelSpawnConstructor::build							()
 {
 	UE_LOG(LogXRayLevelSpawnConstructor, Log,TEXT("Start build spawn in level %S[%s]"), game_graph().header().level(LevelSpawn->LevelID).name().c_str(), *LevelSpawn->Map.ToString());
+	const double						StartTime = FPlatformTime::Seconds();
 	if (!load_objects(LevelSpawn->Spawns))
 	{
-		m_cross_table = 0;
-		m_level_graph = 0;
-		delete m_graph_engine;
+		release_level					();
 		return false;
 	}
 	init								();
 	
 	if (!correct_objects())
 	{
-		m_cross_table = 0;
-		m_level_graph = 0;
-		delete m_graph_engine;
+		release_level					();
 		return false;
 	}
 	generate_artefact_spawn_positions	();
@@ -458,13 +543,84 @@ bool CLevelSpawnConstructor::build							()
 	if (!verify_space_restrictors())
 		return false;
 	
-	m_cross_table						= 0;
-	m_level_graph = 0;
-	delete							m_graph_engine;
-	UE_LOG(LogXRayLevelSpawnConstructor, Log, TEXT("Spawn build completed"));
+	release_level						();
+	UE_LOG(LogXRayLevelSpawnConstructor, Log, TEXT("Spawn build of level %S completed in %.3f s"), game_graph().header().level(LevelSpawn->LevelID).name().c_str(), FPlatformTime::Seconds() - StartTime);
 	return true;
 }
 
+bool CLevelSpawnConstructor::build_cached						(const FStalkerGameSpawnLevelInfo &level_info)
+{
+	UE_LOG(LogXRayLevelSpawnConstructor, Log,TEXT("Load built spawn of level %S[%s]"), game_graph().header().level(LevelSpawn->LevelID).name().c_str(), *LevelSpawn->Map.ToString());
+	const double						StartTime = FPlatformTime::Seconds();
+	if (!load_objects(level_info.BuiltSpawns))
+	{
+		release_level					();
+		return false;
+	}
+	// patrol paths go to the shared storage, they are loaded as in the full build
+	init								();
+
+	const u32							vertex_offset = level_vertex_offset();
+	if (vertex_offset == u32(-1))
+	{
+		UE_LOG(LogXRayLevelSpawnConstructor, Error, TEXT("There are no graph vertices in the game graph for the level '%S' !"), game_graph().header().level(LevelSpawn->LevelID).name().c_str());
+		release_level					();
+		return false;
+	}
+	// levels before this one may have gained or lost vertices since the objects were corrected
+	const s32							graph_id_shift = s32(vertex_offset) - level_info.BuiltVertexOffset;
+	for (ISE_ALifeObject* Object : m_spawns)
+	{
+		Object->m_tGraphID				= (GameGraph::_GRAPH_ID)(s32(Object->m_tGraphID) + graph_id_shift);
+	}
+
+	m_level_points.clear				();
+	m_level_points.reserve				(level_info.BuiltLevelPoints.Num());
+	for (const FStalkerGameSpawnLevelPoint& Point : level_info.BuiltLevelPoints)
+	{
+		IGameGraph::CLevelPoint&		LevelPoint = m_level_points.emplace_back();
+		LevelPoint.tPoint.set			(Point.Position.X, Point.Position.Y, Point.Position.Z);
+		LevelPoint.tNodeID				= Point.NodeID;
+		LevelPoint.fDistance			= Point.Distance;
+	}
+
+	// the separators were verified when the objects were built
+	delete_data							(m_space_restrictors);
+	release_level						();
+	UE_LOG(LogXRayLevelSpawnConstructor, Log, TEXT("Spawn of level %S loaded from the previous build in %.3f s"), game_graph().header().level(LevelSpawn->LevelID).name().c_str(), FPlatformTime::Seconds() - StartTime);
+	return true;
+}
+
+void CLevelSpawnConstructor::save_build							(FStalkerGameSpawnLevelInfo &level_info) const
+{
+	auto Save = [&level_info](ISE_Abstract* abstract)
+	{
+		NET_Packet						net_packet;
+		abstract->Spawn_Write			(net_packet, TRUE);
+		level_info.BuiltSpawns.AddDefaulted_GetRef().SpawnData.Append(net_packet.B.data, net_packet.B.count);
+	};
+	// objects first, spawn ids are handed out in this order on load
+	level_info.BuiltSpawns.Empty		(m_spawns.size() + m_graph_points.size());
+	for (ISE_ALifeObject* Object : m_spawns)
+	{
+		Save							(Object->CastAbstract());
+	}
+	for (ISE_ALifeGraphPoint* GraphPoint : m_graph_points)
+	{
+		Save							(GraphPoint->CastAbstract());
+	}
+
+	level_info.BuiltLevelPoints.Empty	(m_level_points.size());
+	for (const IGameGraph::CLevelPoint& LevelPoint : m_level_points)
+	{
+		FStalkerGameSpawnLevelPoint&	Point = level_info.BuiltLevelPoints.AddDefaulted_GetRef();
+		Point.Position					= FVector3f(LevelPoint.tPoint.x, LevelPoint.tPoint.y, LevelPoint.tPoint.z);
+		Point.NodeID					= LevelPoint.tNodeID;
+		Point.Distance					= LevelPoint.fDistance;
+	}
+	level_info.BuiltVertexOffset		= s32(level_vertex_offset());
+}
+
 bool CLevelSpawnConstructor::update								()
 {
 	fill_level_changers					();
@@ -485,6 +641,7 @@ bool CLevelSpawnConstructor::verify_space_restrictors			()
 	SPACE_RESTRICTORS::iterator			I = m_space_restrictors.begin();
 	SPACE_RESTRICTORS::iterator			E = m_space_restrictors.end();
 	bool bResult = true;
+	CGraphEngineEditor*					GraphEngine = graph_engines().acquire();
 	for ( ; I != E; ++I) 
 	{
 		checkSlow							(*I);
@@ -492,9 +649,10 @@ bool CLevelSpawnConstructor::verify_space_restrictors			()
 		if ((*I)->object().m_space_restrictor_type == RestrictionSpace::eRestrictorTypeNone)
 			continue;
 
-		if (!(*I)->Verify(*m_level_graph, *m_graph_engine, m_no_separator_check))
+		if (!(*I)->Verify(*m_level_graph, *GraphEngine, m_no_separator_check))
 			bResult = false;
 	}
+	graph_engines().release				(GraphEngine);
 
 	delete_data							(m_space_restrictors);
 
@@ -14,7 +14,7 @@ class ILevelGraph;
 class IGameLevelCrossTable;
 class CGameSpawnConstructor;
 class ISE_ALifeCreatureActor;
-class CGraphEngineEditor;
+class CGraphEngineEditorPool;
 class ISE_Abstract;
 class ISE_ALifeObject;
 class ISE_ALifeGraphPoint;
@@ -23,6 +23,7 @@ class ISE_ALifeAnomalousZone;
 class CSpaceRestrictorWrapper;
 class CPatrolPathStorage;
 class ISE_ALifeDynamicObject;
+struct FStalkerGameSpawnLevelInfo;
 
 class CLevelSpawnConstructor  {
 public:
@@ -35,6 +36,26 @@ public:
 //	typedef xr_map<shared_str,GROUP_OBJECTS*>					SPAWN_GRPOUP_OBJECTS;
 //	typedef xr_map<shared_str,ISE_SpawnGroup*>					SPAWN_GROUPS;
 
+	// One anomalous zone of the artefact spawn position search, the vertex and count are corrected in place
+	struct SArtefactSpawnZone
+	{
+		LPCSTR							name;
+		Fvector							position;
+		float							radius;
+		u32								level_vertex_id;
+		u32								artefact_spawn_count;
+		u32								artefact_position_offset;
+	};
+	typedef xr_vector<SArtefactSpawnZone>						ARTEFACT_SPAWN_ZONES;
+
+	// Named position of a graph point or game vertex for the level changer resolution
+	struct SNamedPoint
+	{
+		shared_str						name;
+		Fvector							position;
+	};
+	typedef xr_vector<SNamedPoint>								NAMED_POINTS;
+
 private:
 	SPAWN_STORAGE						m_spawns;
 	LEVEL_POINT_STORAGE					m_level_points;
@@ -45,7 +66,7 @@ private:
 	CGameSpawnConstructor				*m_game_spawn_constructor;
 	ISE_ALifeCreatureActor				*m_actor;
 	ILevelGraph							*m_level_graph;
-	CGraphEngineEditor					*m_graph_engine;
+	CGraphEngineEditorPool				*m_graph_engines;
 	LEVEL_CHANGER_STORAGE				m_level_changers;
 	bool								m_no_separator_check;
 
@@ -60,6 +81,8 @@ protected:
 			void						generate_artefact_spawn_positions	();
 			void						correct_level_changers				();
 			bool						verify_space_restrictors			();
+			u32							level_vertex_offset					() const;
+			void						release_level						();
 			void						fill_level_changers					();
 			void						add_graph_point						(ISE_Abstract			*abstract);
 			void						add_story_object					(ISE_ALifeDynamicObject *dynamic_object);
@@ -70,7 +93,7 @@ protected:
 	IC		const IGameGraph			&game_graph							() const;
 	IC		const ILevelGraph			&level_graph						() const;
 	IC		const IGameLevelCrossTable	&cross_table						() const;
-	IC		CGraphEngineEditor			&graph_engine						() const;
+	IC		CGraphEngineEditorPool		&graph_engines						() const;
 	IC		LEVEL_CHANGER_STORAGE		&level_changers						() const;
 	IC		u32							level_id							(shared_str level_name) const;
 
@@ -78,10 +101,17 @@ public:
 	IC									CLevelSpawnConstructor				(class UStalkerLevelSpawn* LevelSpawn, CGameSpawnConstructor *game_spawn_constructor, bool no_separator_check);
 	virtual								~CLevelSpawnConstructor				();
 	virtual bool						build								();
+	// Loads the objects corrected by a previous build of the unchanged level instead of correcting them again
+			bool						build_cached						(const FStalkerGameSpawnLevelInfo &level_info);
+			void						save_build							(FStalkerGameSpawnLevelInfo &level_info) const;
 	IC		ISE_ALifeCreatureActor		*actor								() const;
 	IC		const IGameGraph::SLevel	&level								() const;
 			bool						update								();
 	IC		CGameSpawnConstructor		&game_spawn_constructor				() const;
+	static	void						shuffle_artefact_spawn_vertices		(xr_vector<u32> &level_vertices, u32 level_seed, LPCSTR zone_name);
+	// For every target name the first graph point with that name and the id of the first game vertex at its position, u32(-1) where there is none
+	static	void						resolve_level_changer_targets		(const NAMED_POINTS &graph_points, const xr_vector<std::pair<u32,Fvector>> &game_vertices, const xr_vector<shared_str> &targets, xr_vector<std::pair<u32,u32>> &results);
+	static	void						find_artefact_spawn_positions		(const ILevelGraph &level_graph, const IGameLevelCrossTable &cross_table, CGraphEngineEditorPool &graph_engines, u32 level_seed, ARTEFACT_SPAWN_ZONES &zones, LEVEL_POINT_STORAGE &level_points);
 };
 DECLARE_LOG_CATEGORY_EXTERN(LogXRayLevelSpawnConstructor, Log, All);
 #include "level_spawn_constructor_inline.h"
\ No newline at end of file
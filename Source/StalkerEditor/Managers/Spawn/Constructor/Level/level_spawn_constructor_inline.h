@@ -17,7 +17,7 @@ IC	CLevelSpawnConstructor::CLevelSpawnConstructor			(class UStalkerLevelSpawn* I
 	m_actor						= 0;
 	m_level_graph				= 0;
 	m_cross_table				= 0;
-	m_graph_engine				= 0;
+	m_graph_engines				= 0;
 }
 
 IC	ISE_ALifeCreatureActor *CLevelSpawnConstructor::actor	() const
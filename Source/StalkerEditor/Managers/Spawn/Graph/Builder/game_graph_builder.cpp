@@ -7,8 +7,9 @@
 ////////////////////////////////////////////////////////////////////////////
 
 #include "game_graph_builder.h"
-#include "../Engine/graph_engine_editor.h"
+#include "../Engine/graph_engine_editor_pool.h"
 #include "../Engine/graph_engine_editor_space.h"
+#include "../Index/graph_point_index.h"
 #include "../../PathManager/Params/path_manager_params.h"
 #include "../../PathManager/Params/path_manager_params_straight_line.h"
 #include "Resources/Spawn/StalkerLevelSpawn.h"
@@ -17,13 +18,16 @@
 DEFINE_LOG_CATEGORY(LogXRayGameGraphBuilder);
 CGameGraphBuilder::CGameGraphBuilder		(ILevelGraph* LevelGraph)
 {
+	m_graph_point_positions	= new CGraphPointIndex(_sqrt(EPS_L));
 	m_graph					= new graph_type();
 	m_level_graph           = LevelGraph;
+	m_graph_engines			= 0;
 }
 
 CGameGraphBuilder::~CGameGraphBuilder		()
 {
 	delete m_graph;
+	delete m_graph_point_positions;
 }
 
 
@@ -39,14 +43,14 @@ void CGameGraphBuilder::load_graph_point	(class UStalkerLevelSpawn* LevelSpawn,
 	vertex.tLocalPoint		= entity->o_Position;
 	// check for duplicate graph point positions
 	{
-		graph_type::const_vertex_iterator	I = graph().vertices().begin();
-		graph_type::const_vertex_iterator	E = graph().vertices().end();
-		for ( ; I != E; ++I) {
-			if ((*I).second->data().tLocalPoint.distance_to_sqr(vertex.tLocalPoint) < EPS_L) {
-				UE_LOG(LogXRayGameGraphBuilder, Warning, TEXT("! removing graph point [%s][%f][%f][%f] because it is too close to the another graph point" ), ANSI_TO_TCHAR(entity->name_replace()),VPUSH(entity->o_Position));
+		u32					vertex_id = m_graph_point_positions->find(vertex.tLocalPoint,[this,&vertex](u32 vertex_id)
+		{
+			return			(graph().vertex(vertex_id)->data().tLocalPoint.distance_to_sqr(vertex.tLocalPoint) < EPS_L);
+		});
+		if (vertex_id != u32(-1)) {
+			UE_LOG(LogXRayGameGraphBuilder, Warning, TEXT("! removing graph point [%s][%f][%f][%f] because it is too close to the another graph point" ), ANSI_TO_TCHAR(entity->name_replace()),VPUSH(entity->o_Position));
 			
-				return;
-			}
+			return;
 		}
 	}
 
@@ -58,16 +62,10 @@ void CGameGraphBuilder::load_graph_point	(class UStalkerLevelSpawn* LevelSpawn,
 		return;
 	}
 
-	{
-		graph_type::const_vertex_iterator	I = graph().vertices().begin();
-		graph_type::const_vertex_iterator	E = graph().vertices().end();
-		for ( ; I != E; ++I) {
-			if ((*I).second->data().tNodeID == vertex.tNodeID) {
-				UE_LOG(LogXRayGameGraphBuilder, Warning, TEXT("removing graph point [%s][%f][%f][%f] because it has the same AI node as another graph point"),ANSI_TO_TCHAR(entity->name_replace()),VPUSH(entity->o_Position));
-			
-				return;
-			}
-		}
+	if (m_graph_point_nodes.Contains(vertex.tNodeID)) {
+		UE_LOG(LogXRayGameGraphBuilder, Warning, TEXT("removing graph point [%s][%f][%f][%f] because it has the same AI node as another graph point"),ANSI_TO_TCHAR(entity->name_replace()),VPUSH(entity->o_Position));
+		
+		return;
 	}
 
 	vertex.tNeighbourCount	= 0;
@@ -80,6 +78,8 @@ void CGameGraphBuilder::load_graph_point	(class UStalkerLevelSpawn* LevelSpawn,
 	Conection.Name = entity->name_replace();
 	Conection.ConnectionLevelName = graph_point->m_caConnectionLevelName.c_str();
 	Conection.ConnectionPointName = graph_point->m_caConnectionPointName.c_str();
+	m_graph_point_positions->add(vertex.tLocalPoint,graph().vertices().size());
+	m_graph_point_nodes.Add	(vertex.tNodeID);
 	graph().add_vertex		(vertex,graph().vertices().size());
 }
 
@@ -96,145 +96,26 @@ IC	bool sort_predicate_greater(const T &first, const T &second)
 	return					(first.first > second.first);
 }
 
-void CGameGraphBuilder::mark_vertices		(u32 level_vertex_id)
-{
-	ILevelGraph::const_iterator			I, E;
-	m_mark_stack.reserve				(8192);
-	m_mark_stack.push_back				(level_vertex_id);
-
-	for ( ; !m_mark_stack.empty(); ) {
-		level_vertex_id					= m_mark_stack.back();
-		m_mark_stack.resize				(m_mark_stack.size() - 1);
-		const ILevelGraph::CVertex			*node = level_graph().vertex(level_vertex_id);
-		level_graph().begin				(level_vertex_id,I,E);
-		m_marks[level_vertex_id]		= true;
-		for ( ; I != E; ++I) {
-			u32							next_level_vertex_id = node->link(I);
-			if (!level_graph().valid_vertex_id(next_level_vertex_id))
-				continue;
-			
-			if (!m_marks[next_level_vertex_id])
-				m_mark_stack.push_back	(next_level_vertex_id);
-		}
-	}
-}
-
-void CGameGraphBuilder::fill_marks			()
+void CGameGraphBuilder::build_cross_table	(class UStalkerLevelSpawn* LevelSpawn)
 {
+	UE_LOG(LogXRayGameGraphBuilder, Log, TEXT("Building cross table"));
 
-	m_marks.assign						(level_graph().header().vertex_count(),false);
-	graph_type::const_vertex_iterator	I = graph().vertices().begin();
-	graph_type::const_vertex_iterator	E = graph().vertices().end();
-	for ( ; I != E; ++I)
-		mark_vertices					((*I).second->data().level_vertex_id());
-	m_marks.flip						();
-	
-}
-
-void CGameGraphBuilder::fill_distances		()
-{
+	xr_vector<u32>			graph_points(graph().vertices().size());
+	for (u32 i=0, n=(u32)graph_points.size(); i<n; ++i)
+		graph_points[i]		= graph().vertex(i)->data().level_vertex_id();
 
-	m_distances.resize					(graph().vertices().size());
+	ILevelGraph				&level = level_graph();
+	nearest_graph_points	(level.header().vertex_count(),graph_points,[&level](u32 level_vertex_id, const auto &visit)
 	{
-		DISTANCES::iterator				I = m_distances.begin();
-		DISTANCES::iterator				E = m_distances.end();
-		for ( ; I != E; I++) {
-			(*I).resize					(level_graph().header().vertex_count());
-			xr_vector<u32>::iterator	i = (*I).begin();
-			xr_vector<u32>::iterator	e = (*I).end();
-			for ( ; i != e; i++)
-				*i						= u32(-1);
-		}
-	}
-}
-
-void CGameGraphBuilder::recursive_update	(const u32 &game_vertex_id)
-{
-
-	u32							level_vertex_id = graph().vertex(game_vertex_id)->data().level_vertex_id();
-	xr_vector<u32>				&distances = m_distances[game_vertex_id];
-	m_distances[m_results[level_vertex_id]][level_vertex_id]	= u32(-1);
-
-	m_current_fringe.reserve	(distances.size());
-	m_next_fringe.reserve		(distances.size());
-	distances.assign			(distances.size(),u32(-1));
-	m_current_fringe.push_back	(level_vertex_id);
-	u32							curr_dist = 0;
-	u32							total_count = 0;
-
-	u32							vertex_count = graph().header().vertex_count();
-
-
-	for ( ; !m_current_fringe.empty(); ) {
-		xr_vector<u32>::iterator			I = m_current_fringe.begin();
-		xr_vector<u32>::iterator			E = m_current_fringe.end();
-		for ( ; I != E; ++I) {
-			u32								*result = &m_results[*I];
-			check							(curr_dist < m_distances[*result][*I]);
-			*result							= game_vertex_id;
-
-			distances[*I]					= curr_dist;
-			ILevelGraph::const_iterator		i, e;
-			const ILevelGraph::CVertex			*node = level_graph().vertex(*I);
-			level_graph().begin				(*I,i,e);
-			for ( ; i != e; ++i) {
-				u32							dwNexNodeID = node->link(i);
-				if (!level_graph().valid_vertex_id(dwNexNodeID))
-					continue;
-				
-				if (m_marks[dwNexNodeID])
-					continue;
-				
-				if (distances[dwNexNodeID] <= curr_dist)
-					continue;
-
-				if (m_distances[m_results[dwNexNodeID]][dwNexNodeID] <= (curr_dist + 1))
-					continue;
-
-				m_next_fringe.push_back		(dwNexNodeID);
-				m_marks[dwNexNodeID]		= true;
-			}
-		}
-		
-		I = m_current_fringe.begin();
-		E = m_current_fringe.end();
-		for ( ; I != E; ++I)
-			m_marks[*I]		= false;
-
-		total_count			+= m_current_fringe.size();
-		m_current_fringe	= m_next_fringe;
-		m_next_fringe.clear	();
-		++curr_dist;
-
-	}
-
-}
-
-void CGameGraphBuilder::iterate_distances	()
-{
-
-	m_results.assign					(level_graph().header().vertex_count(),0);
-	
-	for (int i=0, n=(int)graph().vertices().size(); i<n; ++i) {
-		if (i) {
-			for (int k=0, kn=(int)level_graph().header().vertex_count(); k<kn; ++k)
-				m_distances[i][k]		= m_distances[i - 1][k];
+		ILevelGraph::const_iterator	i, e;
+		const ILevelGraph::CVertex	*node = level.vertex(level_vertex_id);
+		level.begin			(level_vertex_id,i,e);
+		for ( ; i != e; ++i) {
+			u32						next_level_vertex_id = node->link(i);
+			if (level.valid_vertex_id(next_level_vertex_id))
+				visit				(next_level_vertex_id);
 		}
-
-		recursive_update				(i);
-	}
-
-}
-
-
-
-void CGameGraphBuilder::build_cross_table	(class UStalkerLevelSpawn* LevelSpawn)
-{
-	UE_LOG(LogXRayGameGraphBuilder, Log, TEXT("Building cross table"));
-
-	fill_marks				();
-	fill_distances			();
-	iterate_distances		();
+	},m_results,m_distances,m_current_fringe,m_next_fringe);
 
 	//IGameLevelCrossTable::CHeader&tCrossTableHeader = LevelSpawn->GameCrossTableHeader;
 	//tCrossTableHeader.dwVersion = XRAI_CURRENT_VERSION;
@@ -249,7 +130,7 @@ void CGameGraphBuilder::build_cross_table	(class UStalkerLevelSpawn* LevelSpawn)
 		IGameLevelCrossTable::CCell& tCrossTableCell = LevelSpawn->GameCrossTableCells[i];
 		tCrossTableCell.tGraphIndex = (GameGraph::_GRAPH_ID)m_results[i];
 		check(graph().header().vertex_count() > tCrossTableCell.tGraphIndex);
-		tCrossTableCell.fDistance = float(m_distances[tCrossTableCell.tGraphIndex][i]) * level_graph().header().cell_size();
+		tCrossTableCell.fDistance = float(m_distances[i]) * level_graph().header().cell_size();
 	}
 
 }
@@ -257,27 +138,28 @@ void CGameGraphBuilder::build_cross_table	(class UStalkerLevelSpawn* LevelSpawn)
 
 void CGameGraphBuilder::fill_neighbours		(class UStalkerLevelSpawn* LevelSpawn,const u32 &game_vertex_id)
 {
-	m_marks.assign						(level_graph().header().vertex_count(),false);
 	m_current_fringe.clear				();
 
 	u32									level_vertex_id = graph().vertex(game_vertex_id)->data().level_vertex_id();
 
+	// only vertices owned by game_vertex_id are visited, so m_visited needs no reset between graph points
+	check								(m_visited.size() == level_graph().header().vertex_count());
 	ILevelGraph::const_iterator			I, E;
-	m_mark_stack.reserve				(8192);
-	m_mark_stack.push_back				(level_vertex_id);
+	m_next_fringe.clear					();
+	m_next_fringe.push_back				(level_vertex_id);
 
-	for ( ; !m_mark_stack.empty(); ) {
-		level_vertex_id					= m_mark_stack.back();
-		m_mark_stack.resize				(m_mark_stack.size() - 1);
+	for ( ; !m_next_fringe.empty(); ) {
+		level_vertex_id					= m_next_fringe.back();
+		m_next_fringe.pop_back			();
 		const ILevelGraph::CVertex		*node = level_graph().vertex(level_vertex_id);
 		level_graph().begin				(level_vertex_id,I,E);
-		m_marks[level_vertex_id]		= true;
+		m_visited[level_vertex_id]		= game_vertex_id;
 		for ( ; I != E; ++I) {
 			u32							next_level_vertex_id = node->link(I);
 			if (!level_graph().valid_vertex_id(next_level_vertex_id))
 				continue;
 			
-			if (m_marks[next_level_vertex_id])
+			if (m_visited[next_level_vertex_id] == game_vertex_id)
 				continue;
 
 			GameGraph::_GRAPH_ID		next_game_vertex_id = LevelSpawn->GameCrossTableCells[next_level_vertex_id].game_vertex_id();
@@ -296,12 +178,12 @@ void CGameGraphBuilder::fill_neighbours		(class UStalkerLevelSpawn* LevelSpawn,c
 				continue;
 			}
 
-			m_mark_stack.push_back		(next_level_vertex_id);
+			m_next_fringe.push_back		(next_level_vertex_id);
 		}
 	}
 }
 
-float CGameGraphBuilder::path_distance		(const u32 &game_vertex_id0, const u32 &game_vertex_id1)
+float CGameGraphBuilder::path_distance		(CGraphEngineEditor &graph_engine, xr_vector<u32> &path, const u32 &game_vertex_id0, const u32 &game_vertex_id1)
 {
 
 
@@ -319,11 +201,11 @@ float CGameGraphBuilder::path_distance		(const u32 &game_vertex_id0, const u32 &
 		return				(pure_distance);
 
 	bool					successfull = 
-		m_graph_engine->search(
+		graph_engine.search(
 			level_graph(),
 			vertex0.data().level_vertex_id(),
 			vertex1.data().level_vertex_id(),
-			&m_path,
+			&path,
 			parameters
 		);
 
@@ -338,15 +220,10 @@ float CGameGraphBuilder::path_distance		(const u32 &game_vertex_id0, const u32 &
 
 void CGameGraphBuilder::generate_edges		(const u32 &game_vertex_id)
 {
-	graph_type::CVertex		*vertex = graph().vertex(game_vertex_id);
-
 	xr_vector<u32>::const_iterator	I = m_current_fringe.begin();
 	xr_vector<u32>::const_iterator	E = m_current_fringe.end();
-	for ( ; I != E; ++I) {
-		check				(!vertex->edge(*I));
-		float				distance = path_distance(game_vertex_id,*I);
-		graph().add_edge	(game_vertex_id,*I,distance);
-	}
+	for ( ; I != E; ++I)
+		m_edges.push_back	(std::make_pair(game_vertex_id,*I));
 }
 
 void CGameGraphBuilder::generate_edges		(class UStalkerLevelSpawn* LevelSpawn)
@@ -355,6 +232,9 @@ void CGameGraphBuilder::generate_edges		(class UStalkerLevelSpawn* LevelSpawn)
 
 	UE_LOG(LogXRayGameGraphBuilder, Log, TEXT("Generating edges"));
 	
+	m_edges.clear			();
+	m_visited.assign		(level_graph().header().vertex_count(),u32(-1));
+
 	graph_type::const_vertex_iterator	I = graph().vertices().begin();
 	graph_type::const_vertex_iterator	E = graph().vertices().end();
 	for ( ; I != E; ++I) {
@@ -362,6 +242,21 @@ void CGameGraphBuilder::generate_edges		(class UStalkerLevelSpawn* LevelSpawn)
 		generate_edges		((*I).second->vertex_id());
 	}
 
+	// searches are independent, every distance goes to its own slot and edges are added in the serial order
+	xr_vector<float>		distances(m_edges.size());
+	m_graph_engines->parallel_for(u32(m_edges.size()),[this,&distances](u32 index, CGraphEngineEditor &graph_engine)
+	{
+		xr_vector<u32>		path;
+		distances[index]	= path_distance(graph_engine,path,m_edges[index].first,m_edges[index].second);
+	});
+
+	for (u32 i = 0, n = u32(m_edges.size()); i < n; ++i) {
+		check				(!graph().vertex(m_edges[i].first)->edge(m_edges[i].second));
+		graph().add_edge	(m_edges[i].first,m_edges[i].second,distances[i]);
+	}
+
+	m_edges.clear			();
+
 	UE_LOG(LogXRayGameGraphBuilder, Log, TEXT("%d edges built"),graph().edge_count());
 
 }
@@ -469,11 +364,12 @@ void CGameGraphBuilder::build_game_graph(class UStalkerLevelSpawn* LevelSpawn)
 	CTimer					timer;
 	timer.Start				();
 
-	m_graph_engine			= new CGraphEngineEditor(level_graph().header().vertex_count());
+	m_graph_engines			= new CGraphEngineEditorPool(level_graph().header().vertex_count());
 
 	generate_edges			(LevelSpawn);
 
-	delete					m_graph_engine;
+	delete					m_graph_engines;
+	m_graph_engines			= 0;
 
 	connectivity_check		();
 	optimize_graph			();
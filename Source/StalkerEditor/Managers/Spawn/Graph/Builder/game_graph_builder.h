@@ -18,13 +18,14 @@ THIRD_PARTY_INCLUDES_END
 class ILevelGraph;
 class IGameLevelCrossTable;
 class CGraphEngineEditor;
+class CGraphEngineEditorPool;
+class CGraphPointIndex;
 
 class CGameGraphBuilder 
 {
 private:
 	typedef GameGraph::CVertex						vertex_type;
 	typedef CGraphAbstract<vertex_type,float,u32>	graph_type;
-	typedef xr_vector<xr_vector<u32> >				DISTANCES;
 	typedef std::pair<u32,u32>						PAIR;
 	typedef std::pair<float,PAIR>					TRIPPLE;
 	typedef xr_vector<TRIPPLE>						TRIPPLES;
@@ -39,31 +40,30 @@ private:
 private:
 	ILevelGraph			*			m_level_graph;
 	graph_type			*			m_graph;
+	// graph point duplicate checks
+	CGraphPointIndex	*			m_graph_point_positions;
+	TSet<u32>						m_graph_point_nodes;
 	// cross table generation stuff
-	xr_vector<bool>					m_marks;
-	xr_vector<u32>					m_mark_stack;
-	DISTANCES						m_distances;
+	xr_vector<u32>					m_distances;
 	xr_vector<u32>					m_current_fringe;
 	xr_vector<u32>					m_next_fringe;
 	xr_vector<u32>					m_results;
+	// game vertex id that last visited a level vertex in fill_neighbours
+	xr_vector<u32>					m_visited;
 	// cross table itself
 	TRIPPLES						m_tripples;
-	xr_vector<u32>					m_path;
-	CGraphEngineEditor	*			m_graph_engine;
+	// edge generation stuff
+	xr_vector<PAIR>					m_edges;
+	CGraphEngineEditorPool	*		m_graph_engines;
 
 private:
 
 private:
-			void					mark_vertices		(u32 level_vertex_id);
-			void					fill_marks			();
-			void					fill_distances		();
-			void					recursive_update	(const u32 &index);
-			void					iterate_distances	();
 			void					build_cross_table	(class UStalkerLevelSpawn* LevelSpawn);
 	
 private:
 			void					fill_neighbours		(class UStalkerLevelSpawn* LevelSpawn,const u32 &game_vertex_id);
-			float					path_distance		(const u32 &game_vertex_id0, const u32 &game_vertex_id1);
+			float					path_distance		(CGraphEngineEditor &graph_engine, xr_vector<u32> &path, const u32 &game_vertex_id0, const u32 &game_vertex_id1);
 			void					generate_edges		(const u32 &vertex_id);
 			void					generate_edges		(class UStalkerLevelSpawn* LevelSpawn);
 			void					connectivity_check	();
@@ -81,6 +81,11 @@ public:
 									~CGameGraphBuilder	();
 			void					load_graph_point	(class UStalkerLevelSpawn* LevelSpawn,ISE_Abstract* entity);
 			bool					build_graph			(class UStalkerLevelSpawn*LevelSpawn);
+
+	// Owning graph point and hop distance of every level vertex, graph_points holds the level vertex of each graph point
+	// in id order and for_each_link(level_vertex_id, visit) calls visit for every valid neighbour. Unreached vertices get 0 and u32(-1).
+	template <typename _for_each_link>
+	static	void					nearest_graph_points(u32 vertex_count, const xr_vector<u32> &graph_points, const _for_each_link &for_each_link, xr_vector<u32> &results, xr_vector<u32> &distances, xr_vector<u32> &current_fringe, xr_vector<u32> &next_fringe);
 };
 DECLARE_LOG_CATEGORY_EXTERN(LogXRayGameGraphBuilder, Log, All);
 #include "game_graph_builder_inline.h"
\ No newline at end of file
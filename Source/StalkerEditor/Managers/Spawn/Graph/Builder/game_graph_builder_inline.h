@@ -18,3 +18,44 @@ IC	CGameGraphBuilder::graph_type &CGameGraphBuilder::graph	() const
 	return	(*m_graph);
 }
 
+// Multi-source BFS seeded with every graph point in id order. A fringe stays ordered by game vertex id,
+// so the first claim of a level vertex comes from the lowest id at the smallest distance, which is the
+// same owner the former per-graph-point BFS over a dense distance matrix ended up with.
+template <typename _for_each_link>
+void CGameGraphBuilder::nearest_graph_points(u32 vertex_count, const xr_vector<u32> &graph_points, const _for_each_link &for_each_link, xr_vector<u32> &results, xr_vector<u32> &distances, xr_vector<u32> &current_fringe, xr_vector<u32> &next_fringe)
+{
+	results.assign						(vertex_count,0);
+	distances.assign					(vertex_count,u32(-1));
+	current_fringe.clear				();
+	next_fringe.clear					();
+	current_fringe.reserve				(vertex_count);
+	next_fringe.reserve					(vertex_count);
+
+	for (u32 i=0, n=(u32)graph_points.size(); i<n; ++i) {
+		u32								level_vertex_id = graph_points[i];
+		if (distances[level_vertex_id] == u32(-1))
+			current_fringe.push_back	(level_vertex_id);
+		results[level_vertex_id]		= i;
+		distances[level_vertex_id]		= 0;
+	}
+
+	u32									curr_dist = 0;
+	for ( ; !current_fringe.empty(); ) {
+		for (u32 level_vertex_id : current_fringe) {
+			u32							game_vertex_id = results[level_vertex_id];
+			for_each_link				(level_vertex_id,[&](u32 next_level_vertex_id)
+			{
+				if (distances[next_level_vertex_id] != u32(-1))
+					return;
+
+				distances[next_level_vertex_id]	= curr_dist + 1;
+				results[next_level_vertex_id]	= game_vertex_id;
+				next_fringe.push_back			(next_level_vertex_id);
+			});
+		}
+
+		current_fringe.swap				(next_fringe);
+		next_fringe.clear				();
+		++curr_dist;
+	}
+}
@@ -0,0 +1,36 @@
+////////////////////////////////////////////////////////////////////////////
+//	Module 		: graph_engine_editor_pool.h
+//	Description : Pool of graph engines for parallel searches
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+#include "graph_engine_editor.h"
+
+// Every engine owns its own search storage, so searches run concurrently as long as each one
+// uses an engine taken from the pool. Engines are created on demand up to max_engine_count.
+class CGraphEngineEditorPool
+{
+public:
+	// every engine preallocates storage for 2M search vertices, so the default count stays small
+	enum { default_max_engine_count = 4 };
+
+	IC						CGraphEngineEditorPool		(u32 max_vertex_count, u32 max_engine_count = 0);
+	IC						~CGraphEngineEditorPool		();
+
+	IC	CGraphEngineEditor	*acquire					();
+	IC	void				release						(CGraphEngineEditor *engine);
+
+	// Calls function(index, engine) for every index in [0, count). Indices are split over at most
+	// max_engine_count workers that keep one engine each, results must be written per index.
+	template <typename _Function>
+	IC	void				parallel_for				(u32 count, const _Function &function);
+
+private:
+	u32						m_max_vertex_count;
+	u32						m_max_engine_count;
+	FCriticalSection		m_lock;
+	xr_vector<CGraphEngineEditor*>	m_engines;
+	xr_vector<CGraphEngineEditor*>	m_free_engines;
+};
+
+#include "graph_engine_editor_pool_inline.h"
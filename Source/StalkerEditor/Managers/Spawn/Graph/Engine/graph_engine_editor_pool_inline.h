@@ -0,0 +1,53 @@
+////////////////////////////////////////////////////////////////////////////
+//	Module 		: graph_engine_editor_pool_inline.h
+//	Description : Pool of graph engines for parallel searches inline functions
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+IC	CGraphEngineEditorPool::CGraphEngineEditorPool		(u32 max_vertex_count, u32 max_engine_count)
+{
+	m_max_vertex_count	= max_vertex_count;
+	m_max_engine_count	= max_engine_count ? max_engine_count : _min(u32(FTaskGraphInterface::Get().GetNumWorkerThreads() + 1), u32(default_max_engine_count));
+}
+
+IC	CGraphEngineEditorPool::~CGraphEngineEditorPool		()
+{
+	check				(m_free_engines.size() == m_engines.size());
+	for (CGraphEngineEditor *engine : m_engines)
+		delete			engine;
+}
+
+IC	CGraphEngineEditor *CGraphEngineEditorPool::acquire	()
+{
+	FScopeLock			lock(&m_lock);
+	if (m_free_engines.empty()) {
+		m_engines.push_back	(new CGraphEngineEditor(m_max_vertex_count));
+		return			(m_engines.back());
+	}
+	CGraphEngineEditor	*engine = m_free_engines.back();
+	m_free_engines.pop_back();
+	return				(engine);
+}
+
+IC	void CGraphEngineEditorPool::release				(CGraphEngineEditor *engine)
+{
+	FScopeLock			lock(&m_lock);
+	m_free_engines.push_back(engine);
+}
+
+template <typename _Function>
+IC	void CGraphEngineEditorPool::parallel_for			(u32 count, const _Function &function)
+{
+	if (!count)
+		return;
+
+	const u32			worker_count = _min(count, m_max_engine_count);
+	ParallelFor			(worker_count, [this, count, worker_count, &function](int32 worker)
+	{
+		CGraphEngineEditor	*engine = acquire();
+		for (u32 index = u32(worker); index < count; index += worker_count)
+			function	(index, *engine);
+		release			(engine);
+	});
+}
@@ -0,0 +1,28 @@
+////////////////////////////////////////////////////////////////////////////
+//	Module 		: graph_point_index.h
+//	Description : Position index of graph points
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// Ids bucketed by a cubic cell of cell_size, lookups visit the 27 cells around the position,
+// so tolerances of the predicates passed to find must not exceed cell_size
+class CGraphPointIndex
+{
+public:
+	IC						CGraphPointIndex	(float cell_size);
+	IC	void				clear				();
+	IC	void				add					(const Fvector &position, u32 id);
+	// lowest added id that satisfies predicate(id), u32(-1) otherwise
+	template <typename _Predicate>
+	IC	u32					find				(const Fvector &position, const _Predicate &predicate) const;
+
+private:
+	IC	FIntVector			cell				(const Fvector &position) const;
+
+private:
+	float					m_cell_size;
+	TMap<FIntVector,xr_vector<u32>>	m_cells;
+};
+
+#include "graph_point_index_inline.h"
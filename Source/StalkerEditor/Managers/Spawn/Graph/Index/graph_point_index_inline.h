@@ -0,0 +1,45 @@
+////////////////////////////////////////////////////////////////////////////
+//	Module 		: graph_point_index_inline.h
+//	Description : Position index of graph points inline functions
+////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+IC	CGraphPointIndex::CGraphPointIndex	(float cell_size)
+{
+	check				(cell_size > 0.f);
+	m_cell_size			= cell_size;
+}
+
+IC	void CGraphPointIndex::clear		()
+{
+	m_cells.Reset		();
+}
+
+IC	void CGraphPointIndex::add			(const Fvector &position, u32 id)
+{
+	m_cells.FindOrAdd	(cell(position)).push_back(id);
+}
+
+template <typename _Predicate>
+IC	u32 CGraphPointIndex::find			(const Fvector &position, const _Predicate &predicate) const
+{
+	const FIntVector	center = cell(position);
+	u32					result = u32(-1);
+	for (int32 x = -1; x <= 1; ++x)
+		for (int32 y = -1; y <= 1; ++y)
+			for (int32 z = -1; z <= 1; ++z) {
+				const xr_vector<u32>	*ids = m_cells.Find(center + FIntVector(x,y,z));
+				if (!ids)
+					continue;
+				for (u32 id : *ids)
+					if ((id < result) && predicate(id))
+						result	= id;
+			}
+	return				(result);
+}
+
+IC	FIntVector CGraphPointIndex::cell	(const Fvector &position) const
+{
+	return				(FIntVector(FMath::FloorToInt32(position.x/m_cell_size),FMath::FloorToInt32(position.y/m_cell_size),FMath::FloorToInt32(position.z/m_cell_size)));
+}
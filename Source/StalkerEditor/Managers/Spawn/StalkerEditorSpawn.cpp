@@ -208,6 +208,10 @@ class UStalkerLevelSpawn* UStalkerEditorSpawn::BuildLevelSpawn()
 		{
 			Spawn->Spawns.Last().SpawnData[i] = Packet.B.data[i];
 		}
+		if (AactorItr->XRayEntity->visual() && AactorItr->XRayEntity->visual()->visual_name.size())
+		{
+			Spawn->Visuals.AddUnique(ANSI_TO_TCHAR(AactorItr->XRayEntity->visual()->visual_name.c_str()));
+		}
 		GameGraphBuilder.load_graph_point(Spawn,AactorItr->XRayEntity);
 	}
 	if (!Spawn->Spawns.Num())
@@ -307,13 +311,15 @@ bool UStalkerEditorSpawn::BuildGameSpawn(UStalkerLevelSpawn* OnlyIt, bool IfNeed
 			GameSpawnLevelInfo.Name = LevelName;
 			GameSpawnLevelInfo.Map = OnlyIt->Map;
 			GameSpawnLevelInfo.LevelSpawnGuid = OnlyIt->SpawnGuid;
+			GameSpawnLevelInfo.Visuals = OnlyIt->Visuals;
 		}
 		LevelSpawns.Add(OnlyIt);
 	}
 	else
 	{
 		
-		int32 CountLevel = 0;
+		// queue every level spawn package first, so they are loaded concurrently instead of one by one
+		TArray<TPair<FName, FString>> LevelSpawnPaths;
 		for (auto& [Name,Level] : Levels)
 		{
 			if (!Level.IncludeInBuildSpawn &&! IgnoreIncludeInBuild &&! SGSettings->IgnoreIncludeInBuildSpawn)
@@ -321,6 +327,19 @@ bool UStalkerEditorSpawn::BuildGameSpawn(UStalkerLevelSpawn* OnlyIt, bool IfNeed
 				continue;
 			}
 			const FString ParentPackageName = FPaths::GetPath(Level.Map.ToString()) / FPaths::GetBaseFilename(Level.Map.ToString()) + TEXT("_Spawn");
+			LevelSpawnPaths.Emplace(Name, ParentPackageName);
+			if (!FindPackage(nullptr, *ParentPackageName) && FPackageName::DoesPackageExist(ParentPackageName))
+			{
+				LoadPackageAsync(ParentPackageName);
+			}
+		}
+		const double LoadStartTime = FPlatformTime::Seconds();
+		FlushAsyncLoading();
+		UE_LOG(LogXRayGameSpawnConstructor, Log, TEXT("Loaded %d level spawns in %.3f s"), LevelSpawnPaths.Num(), FPlatformTime::Seconds() - LoadStartTime);
+
+		int32 CountLevel = 0;
+		for (auto& [Name, ParentPackageName] : LevelSpawnPaths)
+		{
 			const FString ParentObjectPath = ParentPackageName + TEXT(".") + FPaths::GetBaseFilename(ParentPackageName);
 			UStalkerLevelSpawn* CurrentLevelSpawn =  LoadObject<UStalkerLevelSpawn>(nullptr, *ParentObjectPath, nullptr, LOAD_NoWarn);
 			if (CurrentLevelSpawn)
@@ -346,6 +365,7 @@ bool UStalkerEditorSpawn::BuildGameSpawn(UStalkerLevelSpawn* OnlyIt, bool IfNeed
 				GameSpawnLevelInfo.LeveID = CurrentLevelSpawn->LevelID = CountLevel++;
 				GameSpawnLevelInfo.Name = Name.ToString().ToLower();
 				GameSpawnLevelInfo.Map = CurrentLevelSpawn->Map;
+				GameSpawnLevelInfo.Visuals = CurrentLevelSpawn->Visuals;
 				LevelSpawns.Add(CurrentLevelSpawn);
 			}
 			else
@@ -358,6 +378,10 @@ bool UStalkerEditorSpawn::BuildGameSpawn(UStalkerLevelSpawn* OnlyIt, bool IfNeed
 		}
 		
 	}
+	ParallelFor(LevelSpawns.Num(), [this, &NewLevelsInfo](int32 Index)
+	{
+		NewLevelsInfo[Index].ContentHash = LevelSpawns[Index]->CalculateContentHash();
+	});
 	for (UStalkerLevelSpawn* LevelSpawn : LevelSpawns)
 	{
 		if (!LevelSpawn->SpawnGuid.IsValid())
@@ -375,44 +399,72 @@ bool UStalkerEditorSpawn::BuildGameSpawn(UStalkerLevelSpawn* OnlyIt, bool IfNeed
 			return false;
 		}
 	}
+	// the artefact positions and the separator check of a level depend on these as well
+	const uint32 BuildSettingsHash = HashCombine(GetTypeHash(SGSettings->ArtefactSpawnSeed), GetTypeHash(SGSettings->VerifySpaceRestrictorBorders));
+	for (FStalkerGameSpawnLevelInfo& LevelInfo : NewLevelsInfo)
+	{
+		LevelInfo.BuildSettingsHash = BuildSettingsHash;
+	}
 	if (IfNeededRebuild)
 	{
-		if (GameSpawn->GameSpawnGuid.IsValid()&& GameSpawn->LevelsInfo.Num() == NewLevelsInfo.Num())
+		if (GameSpawn->GameSpawnGuid.IsValid())
 		{
-			bool NeedRebuild = false;
-			for (int32 i = 0; i < GameSpawn->LevelsInfo.Num(); i++)
+			bool NeedRebuild = GameSpawn->LevelsInfo.Num() != NewLevelsInfo.Num();
+			TBitArray<> UpToDate(false, NewLevelsInfo.Num());
+			for (int32 i = 0; i < NewLevelsInfo.Num(); i++)
 			{
-				if (GameSpawn->LevelsInfo[i].LevelSpawnGuid != NewLevelsInfo[i].LevelSpawnGuid)
-				{
-					NeedRebuild = true;
-				}
-				else if (GameSpawn->LevelsInfo[i].Name != NewLevelsInfo[i].Name)
-				{
-					NeedRebuild = true;
-				}
-				else if (GameSpawn->LevelsInfo[i].Map != NewLevelsInfo[i].Map)
-				{
-					NeedRebuild = true;
-				}
+				// level spawn guid changes on every level rebuild, the content hash only when the result does
+				const bool LevelChanged = !GameSpawn->LevelsInfo.IsValidIndex(i)
+					|| GameSpawn->LevelsInfo[i].ContentHash != NewLevelsInfo[i].ContentHash
+					|| GameSpawn->LevelsInfo[i].Name != NewLevelsInfo[i].Name
+					|| GameSpawn->LevelsInfo[i].Map != NewLevelsInfo[i].Map
+					|| GameSpawn->LevelsInfo[i].LeveID != NewLevelsInfo[i].LeveID
+					|| GameSpawn->LevelsInfo[i].BuildSettingsHash != NewLevelsInfo[i].BuildSettingsHash;
+				UE_LOG(LogXRayGameSpawnConstructor, Log, TEXT("Level %s : %s"), *NewLevelsInfo[i].Name, LevelChanged ? TEXT("changed") : TEXT("up to date"));
+				NeedRebuild |= LevelChanged;
+				UpToDate[i] = !LevelChanged;
 			}
 			if (!NeedRebuild)
 			{
+				// game spawns built before visuals were recorded pick them up without a rebuild
+				for (int32 i = 0; i < GameSpawn->LevelsInfo.Num(); i++)
+				{
+					if (GameSpawn->LevelsInfo[i].Visuals != NewLevelsInfo[i].Visuals)
+					{
+						GameSpawn->LevelsInfo[i].Visuals = NewLevelsInfo[i].Visuals;
+						GameSpawn->Modify();
+					}
+				}
 				UE_LOG(LogXRayGameSpawnConstructor, Log, TEXT("This GameSpawn not needed rebuild!"));
 				LevelSpawns.Empty();
 				return true;
 			}
+			// unchanged levels keep the objects of the previous build, only changed ones are corrected again
+			for (int32 i = 0; i < NewLevelsInfo.Num(); i++)
+			{
+				if (UpToDate[i])
+				{
+					NewLevelsInfo[i].BuiltSpawns = MoveTemp(GameSpawn->LevelsInfo[i].BuiltSpawns);
+					NewLevelsInfo[i].BuiltLevelPoints = MoveTemp(GameSpawn->LevelsInfo[i].BuiltLevelPoints);
+					NewLevelsInfo[i].BuiltVertexOffset = GameSpawn->LevelsInfo[i].BuiltVertexOffset;
+				}
+			}
 		}
 	}
 	GameSpawn->InvalidGameSpawn();
-	GameSpawn->LevelsInfo =	NewLevelsInfo;
+	GameSpawn->LevelsInfo =	MoveTemp(NewLevelsInfo);
 	GameSpawn->GameSpawnGuid = FGuid::NewGuid();
+	const double GraphStartTime = FPlatformTime::Seconds();
 	BuildGameGraph(GameSpawn);
+	UE_LOG(LogXRayGameSpawnConstructor, Log, TEXT("Merged game graph in %.3f s"), FPlatformTime::Seconds() - GraphStartTime);
 	{
+		const double SpawnStartTime = FPlatformTime::Seconds();
 		CGameSpawnConstructor GameSpawnConstructor;
 		if (!GameSpawnConstructor.build(GameSpawn, LevelSpawns))
 		{
 			GameSpawn->InvalidGameSpawn();
 		}
+		UE_LOG(LogXRayGameSpawnConstructor, Log, TEXT("Built game spawn in %.3f s"), FPlatformTime::Seconds() - SpawnStartTime);
 	}
 	LevelSpawns.Empty();
 	GameSpawn->Modify();
@@ -423,11 +475,17 @@ bool UStalkerEditorSpawn::BuildGameSpawn(UStalkerLevelSpawn* OnlyIt, bool IfNeed
 void UStalkerEditorSpawn::BuildGameGraph(UStalkerGameSpawn* GameSpawn)
 {
 	UE_LOG(LogXRayGameSpawnConstructor, Log, TEXT("Start merge game graph!"));
-	TMap< FStalkerLevelGraphPointConnection* ,int32>				ConnectiontoID;
-	TMap<int32, FStalkerLevelGraphPointConnection*>					IDtoConnection;
-	TMap<int32, TMap<FString, FStalkerLevelGraphPointConnection*>>	LevelAndNameToConnection;
+	TArray<const FStalkerLevelGraphPointConnection*>		VertexConnections;
+	TMap<int32, TMap<FString, int32>>						LevelAndNameToVertex;
+	TMap<FString, int32>									NameToLevel;
+	for (const FStalkerGameSpawnLevelInfo& LevelInfo : GameSpawn->LevelsInfo)
+	{
+		NameToLevel.FindOrAdd(LevelInfo.Name, LevelInfo.LeveID);
+	}
 	GameSpawn->GameGraph.CrossTables.AddDefaulted(LevelSpawns.Num());
 	TArray<IGameGraph::CEdge> TempEdges;
+	TArray<int32>	VertexNodeOffsets;
+	TArray<uint32>	VertexNodes;
 	for (UStalkerLevelSpawn* LevelSpawn : LevelSpawns)
 	{
 
@@ -441,19 +499,22 @@ void UStalkerEditorSpawn::BuildGameGraph(UStalkerGameSpawn* GameSpawn)
 			Header.dwGraphPointCount = LevelSpawn->GameGraphVertices.Num();
 			Header.dwVersion = XRAI_CURRENT_VERSION;
 		}
+		CrossTables.Cells.Reserve(LevelSpawn->GameCrossTableCells.Num());
 		for (IGameLevelCrossTable::CCell& InCell : LevelSpawn->GameCrossTableCells)
 		{
 			IGameLevelCrossTable::CCell&Cell = CrossTables.Cells.AddDefaulted_GetRef();
 			Cell.tGraphIndex = InCell.tGraphIndex + VertexOffset;
 			Cell.fDistance = InCell.fDistance;
 		}
+		LevelSpawn->BuildGameVertexNodes(VertexNodeOffsets, VertexNodes);
+		TMap<FString, int32>& NameToVertex = LevelAndNameToVertex.FindOrAdd(LevelSpawn->LevelID);
 		for (int32 InVertexID=0; InVertexID< LevelSpawn->GameGraphVertices.Num(); InVertexID++)
 		{
 			IGameGraph::CVertex& InVertex = LevelSpawn->GameGraphVertices[InVertexID];
 			int32 VertexID = GameSpawn->GameGraph.Vertices.Num();
-			ConnectiontoID.Add(&LevelSpawn->GameGraphConnection[InVertexID], VertexID);
-			IDtoConnection.Add(VertexID,&LevelSpawn->GameGraphConnection[InVertexID]);
-			LevelAndNameToConnection.FindOrAdd(LevelSpawn->LevelID).Add(LevelSpawn->GameGraphConnection[InVertexID].Name,&LevelSpawn->GameGraphConnection[InVertexID]);
+			const FStalkerLevelGraphPointConnection& Connection = LevelSpawn->GameGraphConnection[InVertexID];
+			VertexConnections.Add(&Connection);
+			NameToVertex.Add(Connection.Name, VertexID);
 			IGameGraph::CVertex&Vertex = GameSpawn->GameGraph.Vertices.AddDefaulted_GetRef();
 			Vertex.tLocalPoint = InVertex.tLocalPoint;
 			Vertex.tGlobalPoint = InVertex.tGlobalPoint;
@@ -471,17 +532,12 @@ void UStalkerEditorSpawn::BuildGameGraph(UStalkerGameSpawn* GameSpawn)
 				Edge.m_path_distance = InEdge.m_path_distance;
 			}
 			
-			TArray<u32>		Nodes;
-			for (u32 i = 0; i < static_cast<u32>(CrossTables.Cells.Num()); i++)
-			{
-				if(CrossTables.Cells[i].tGraphIndex == VertexID)
-				{
-					Nodes.Add(i);
-				}
-			}
+			TArray<u32>		Nodes(VertexNodes.GetData() + VertexNodeOffsets[InVertexID], VertexNodeOffsets[InVertexID + 1] - VertexNodeOffsets[InVertexID]);
+			// seeded by the level and the vertex, so death points are the same in every build
+			FRandomStream	RandomStream(HashCombine(GetTypeHash(LevelSpawn->LevelID), GetTypeHash(InVertexID)));
 			for (int32 i = Nodes.Num() - 1; i > 0; --i)
 			{
-				Swap(Nodes[i], Nodes[FMath::Rand() % (i + 1)]);
+				Swap(Nodes[i], Nodes[RandomStream.RandRange(0, i)]);
 			}
 			int32 LevelCount = FMath::Min(Nodes.Num(), 255);
 			for (int32 LevelPointID = 0; LevelPointID < LevelCount; LevelPointID++)
@@ -508,28 +564,29 @@ void UStalkerEditorSpawn::BuildGameGraph(UStalkerGameSpawn* GameSpawn)
 			Edge.m_vertex_id =			InEdge.m_vertex_id;
 			Edge.m_path_distance =		InEdge.m_path_distance;
 		}
-		if (IDtoConnection[static_cast<uint32>(InVertexID)]->ConnectionLevelName.Len())
+		const FStalkerLevelGraphPointConnection* Connection = VertexConnections[InVertexID];
+		if (Connection->ConnectionLevelName.Len())
 		{
-			FStalkerGameSpawnLevelInfo* LevelInfo = GameSpawn->LevelsInfo.FindByPredicate([&IDtoConnection, InVertexID](const FStalkerGameSpawnLevelInfo& LevelInfo) {return LevelInfo.Name == IDtoConnection[static_cast<uint32>(InVertexID)]->ConnectionLevelName; });
-			if (!LevelInfo)
+			const int32* LevelID = NameToLevel.Find(Connection->ConnectionLevelName);
+			if (!LevelID)
 			{
-				UE_LOG(LogXRayGameSpawnConstructor, Warning, TEXT("Invalid level conection %s in graph point %s in level %s!"), *IDtoConnection[static_cast<uint32>(InVertexID)]->ConnectionLevelName, *IDtoConnection[static_cast<uint32>(InVertexID)]->Name, *GameSpawn->LevelsInfo[InVertex.level_id()].Name);
+				UE_LOG(LogXRayGameSpawnConstructor, Warning, TEXT("Invalid level conection %s in graph point %s in level %s!"), *Connection->ConnectionLevelName, *Connection->Name, *GameSpawn->LevelsInfo[InVertex.level_id()].Name);
 			}
 			else
 			{
-				TMap<FString, FStalkerLevelGraphPointConnection*>& NameToConnection = LevelAndNameToConnection[LevelInfo->LeveID];
-				FStalkerLevelGraphPointConnection** Connection = NameToConnection.Find(IDtoConnection[static_cast<uint32>(InVertexID)]->ConnectionPointName);
-				if (!Connection)
+				const TMap<FString, int32>* NameToVertex = LevelAndNameToVertex.Find(*LevelID);
+				const int32* ConnectionVertexID = NameToVertex ? NameToVertex->Find(Connection->ConnectionPointName) : nullptr;
+				if (!ConnectionVertexID)
 				{
-					UE_LOG(LogXRayGameSpawnConstructor, Warning, TEXT("Invalid point conection %s in graph point %s in level %s!"), *IDtoConnection[static_cast<uint32>(InVertexID)]->ConnectionPointName, *IDtoConnection[static_cast<uint32>(InVertexID)]->Name, *GameSpawn->LevelsInfo[InVertex.level_id()].Name);
+					UE_LOG(LogXRayGameSpawnConstructor, Warning, TEXT("Invalid point conection %s in graph point %s in level %s!"), *Connection->ConnectionPointName, *Connection->Name, *GameSpawn->LevelsInfo[InVertex.level_id()].Name);
 				}
 				else
 				{
 					InVertex.tNeighbourCount++;
 					IGameGraph::CEdge& Edge = GameSpawn->GameGraph.Edges.AddDefaulted_GetRef();
-					Edge.m_vertex_id = ConnectiontoID[*Connection];
+					Edge.m_vertex_id = *ConnectionVertexID;
 					Edge.m_path_distance = 250;
-					UE_LOG(LogXRayGameSpawnConstructor, Log, TEXT("Added conection for graph point %s in level %s to point %s in level %s!"), *IDtoConnection[static_cast<uint32>(InVertexID)]->Name, *GameSpawn->LevelsInfo[InVertex.level_id()].Name, *IDtoConnection[static_cast<uint32>(InVertexID)]->ConnectionPointName, *IDtoConnection[static_cast<uint32>(InVertexID)]->ConnectionLevelName);
+					UE_LOG(LogXRayGameSpawnConstructor, Log, TEXT("Added conection for graph point %s in level %s to point %s in level %s!"), *Connection->Name, *GameSpawn->LevelsInfo[InVertex.level_id()].Name, *Connection->ConnectionPointName, *Connection->ConnectionLevelName);
 				}
 
 			}
@@ -0,0 +1,195 @@
+#include "Misc/AutomationTest.h"
+#include "Kernel/Unreal/WorldSettings/StalkerWorldSettings.h"
+#include "Resources/AIMap/StalkerAIMap.h"
+#include "../Managers/AIMap/StalkerEditorAIMap.h"
+#include "../Managers/AIMap/StalkerEditorAIMapCollision.h"
+#include "../Managers/CFrom/StalkerEditorCForm.h"
+#include "Resources/CFrom/StalkerCForm.h"
+#include "../Entities/Tools/AIMapBoundsVolume/StalkerAIMapBoundsVolume.h"
+#include "../StalkerEditorManager.h"
+#include "ActorFactories/ActorFactory.h"
+#include "Builders/CubeBuilder.h"
+#include "Components/InstancedStaticMeshComponent.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerEditorAIMapCollisionSnapshotTest, "Stalker.Editor.AIMap.CollisionSnapshot", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStalkerEditorAIMapCollisionSnapshotTest::RunTest(const FString& Parameters)
+{
+	UStaticMesh* Cube = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+	UStaticMesh* Plane = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Plane.Plane"));
+	if (!TestNotNull(TEXT("Cube mesh"), Cube) || !TestNotNull(TEXT("Plane mesh"), Plane))
+	{
+		return false;
+	}
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Editor, false);
+	AStalkerWorldSettings* StalkerWorldSettings = Cast<AStalkerWorldSettings>(World->GetWorldSettings());
+	if (!TestNotNull(TEXT("Stalker world settings"), StalkerWorldSettings))
+	{
+		World->DestroyWorld(false);
+		return false;
+	}
+
+	auto SpawnMesh = [World](UStaticMesh* Mesh, const FTransform& Transform, ECollisionEnabled::Type CollisionEnabled)
+	{
+		AStaticMeshActor* Actor = World->SpawnActor<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Transform);
+		Actor->GetStaticMeshComponent()->SetStaticMesh(Mesh);
+		Actor->GetStaticMeshComponent()->SetCollisionEnabled(CollisionEnabled);
+	};
+	// Floor with its top at zero, a wall, a mesh without collision and a plane facing down that traces from above pass through
+	SpawnMesh(Cube, FTransform(FQuat::Identity, FVector(0, 0, -10), FVector(20, 20, 0.2)), ECollisionEnabled::QueryAndPhysics);
+	SpawnMesh(Cube, FTransform(FQuat::Identity, FVector(300, 0, 100), FVector(1, 4, 2)), ECollisionEnabled::QueryAndPhysics);
+	SpawnMesh(Cube, FTransform(FQuat::Identity, FVector(-300, 0, 50), FVector(2, 2, 1)), ECollisionEnabled::NoCollision);
+	SpawnMesh(Plane, FTransform(FRotator(0, 0, 180).Quaternion(), FVector(-300, 300, 80), FVector(2, 2, 1)), ECollisionEnabled::QueryAndPhysics);
+
+	AActor* InstancesActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity);
+	UInstancedStaticMeshComponent* Instances = NewObject<UInstancedStaticMeshComponent>(InstancesActor);
+	InstancesActor->SetRootComponent(Instances);
+	Instances->SetMobility(EComponentMobility::Static);
+	Instances->SetStaticMesh(Cube);
+	Instances->RegisterComponent();
+	Instances->AddInstance(FTransform(FVector(0, 400, 50)), true);
+	Instances->AddInstance(FTransform(FVector(400, 400, 50)), true);
+
+	AStalkerAIMapBoundsVolume* BoundsVolume = World->SpawnActor<AStalkerAIMapBoundsVolume>(AStalkerAIMapBoundsVolume::StaticClass(), FTransform(FVector(0, 0, 100)));
+	UCubeBuilder* CubeBuilder = NewObject<UCubeBuilder>();
+	CubeBuilder->X = 1800;
+	CubeBuilder->Y = 1800;
+	CubeBuilder->Z = 600;
+	UActorFactory::CreateBrushForVolumeActor(BoundsVolume, CubeBuilder);
+	World->UpdateWorldComponents(true, false);
+
+	UStalkerEditorAIMap* EditorAIMap = GStalkerEditorManager->EditorAIMap;
+	UStalkerAIMap* StalkerAIMap = StalkerWorldSettings->GetOrCreateAIMap();
+	FStalkerAIMapNode Seed;
+	if (TestTrue(TEXT("Seed node"), EditorAIMap->CreateNode(Seed, World, FVector(0, 0, 50))))
+	{
+		const int32 SeedNode = StalkerAIMap->FindOrCreateNode(Seed.Position, 50.f, true);
+		StalkerAIMap->Nodes.Planes[SeedNode] = Seed.Plane;
+		TestTrue(TEXT("Collision snapshot generates the same nodes as world traces"), EditorAIMap->CompareCollisionSnapshot(World));
+	}
+
+	StalkerAIMap->ClearFlags(RF_Standalone);
+	World->DestroyWorld(false);
+	return true;
+}
+
+namespace StalkerEditorAIMapTest
+{
+	// Runs the same geometry queries one at a time, which makes Generate build every candidate serially
+	class FSerialQuery : public FStalkerEditorAIMapQuery
+	{
+	public:
+		FSerialQuery(const FStalkerEditorAIMapQuery& InQuery) :Query(InQuery) {}
+		bool LineTrace(const FVector& Start, const FVector& End, FVector& OutLocation, FVector& OutNormal) const override { return Query.LineTrace(Start, End, OutLocation, OutNormal); }
+		bool OverlapBox(const FVector& Center, const FVector& Extent) const override { return Query.OverlapBox(Center, Extent); }
+	private:
+		const FStalkerEditorAIMapQuery& Query;
+	};
+
+	// Rolling floor with a double sided box on it, built straight into the snapshot without a world
+	void BuildScene(FStalkerEditorAIMapCollision& Collision, float NodeSize)
+	{
+		TArray<FVector3f> Vertices;
+		TArray<FStalkerCFormTriangle> Triangles;
+		TArray<EStalkerEditorCFormTriangleFlags> Flags;
+		auto AddTriangle = [&](const FVector3f& A, const FVector3f& B, const FVector3f& C, EStalkerEditorCFormTriangleFlags TriangleFlags)
+		{
+			const uint32 First = Vertices.Num();
+			Vertices.Add(A);
+			Vertices.Add(B);
+			Vertices.Add(C);
+			Triangles.Add({ First, First + 1, First + 2, 0 });
+			Flags.Add(TriangleFlags);
+		};
+		auto AddQuad = [&](const FVector3f& A, const FVector3f& B, const FVector3f& C, const FVector3f& D, EStalkerEditorCFormTriangleFlags TriangleFlags)
+		{
+			AddTriangle(A, B, D, TriangleFlags);
+			AddTriangle(B, C, D, TriangleFlags);
+		};
+
+		constexpr int32 FloorCells = 16;
+		constexpr float FloorCellSize = 100.f;
+		auto FloorPoint = [](int32 x, int32 y)
+		{
+			const float X = (x - FloorCells / 2) * FloorCellSize;
+			const float Y = (y - FloorCells / 2) * FloorCellSize;
+			return FVector3f(X, Y, 20.f * FMath::Sin(X / 300.f) + 10.f * FMath::Cos(Y / 200.f));
+		};
+		for (int32 y = 0; y < FloorCells; y++)
+		{
+			for (int32 x = 0; x < FloorCells; x++)
+			{
+				AddQuad(FloorPoint(x, y), FloorPoint(x + 1, y), FloorPoint(x + 1, y + 1), FloorPoint(x, y + 1), EStalkerEditorCFormTriangleFlags::None);
+			}
+		}
+
+		const FBox3f Box(FVector3f(250.f, -300.f, -50.f), FVector3f(350.f, 300.f, 200.f));
+		const FVector3f P[8] =
+		{
+			FVector3f(Box.Min.X, Box.Min.Y, Box.Min.Z), FVector3f(Box.Max.X, Box.Min.Y, Box.Min.Z), FVector3f(Box.Max.X, Box.Max.Y, Box.Min.Z), FVector3f(Box.Min.X, Box.Max.Y, Box.Min.Z),
+			FVector3f(Box.Min.X, Box.Min.Y, Box.Max.Z), FVector3f(Box.Max.X, Box.Min.Y, Box.Max.Z), FVector3f(Box.Max.X, Box.Max.Y, Box.Max.Z), FVector3f(Box.Min.X, Box.Max.Y, Box.Max.Z),
+		};
+		AddQuad(P[4], P[5], P[6], P[7], EStalkerEditorCFormTriangleFlags::DoubleSided);
+		AddQuad(P[0], P[1], P[5], P[4], EStalkerEditorCFormTriangleFlags::DoubleSided);
+		AddQuad(P[1], P[2], P[6], P[5], EStalkerEditorCFormTriangleFlags::DoubleSided);
+		AddQuad(P[2], P[3], P[7], P[6], EStalkerEditorCFormTriangleFlags::DoubleSided);
+		AddQuad(P[3], P[0], P[4], P[7], EStalkerEditorCFormTriangleFlags::DoubleSided);
+
+		Collision.Build(Vertices, Triangles, Flags, NodeSize);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerEditorAIMapWavefrontTest, "Stalker.Editor.AIMap.Wavefront", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStalkerEditorAIMapWavefrontTest::RunTest(const FString& Parameters)
+{
+	FStalkerEditorAIMapSettings Settings;
+	FStalkerEditorAIMapCollision Collision;
+	StalkerEditorAIMapTest::BuildScene(Collision, Settings.NodeSize);
+
+	FStalkerAIMapNode Seed;
+	if (!TestTrue(TEXT("Seed node"), UStalkerEditorAIMap::CreateNode(Seed, Settings, Collision, FVector(0, 0, 50))))
+	{
+		return false;
+	}
+
+	// Parallel wavefronts must produce the serial node set bit for bit, on every run
+	UStalkerEditorAIMap* EditorAIMap = NewObject<UStalkerEditorAIMap>(GetTransientPackage());
+	EditorAIMap->GenerateAABB = FBox3f(FVector3f(-700.f, -700.f, -300.f), FVector3f(700.f, 700.f, 300.f));
+	auto GenerateFromSeed = [EditorAIMap, &Settings, &Seed](const FStalkerEditorAIMapQuery& Query)
+	{
+		UStalkerAIMap* AIMap = NewObject<UStalkerAIMap>(GetTransientPackage());
+		AIMap->NodeSize = Settings.NodeSize;
+		AIMap->HashFill(EditorAIMap->GenerateAABB);
+		const int32 SeedNode = AIMap->FindOrCreateNode(Seed.Position, 50.f, true);
+		AIMap->Nodes.Planes[SeedNode] = Seed.Plane;
+		EditorAIMap->Generate(AIMap, Settings, Query, false);
+		return AIMap;
+	};
+	auto IsSame = [](const FStalkerAIMapNodes& A, const FStalkerAIMapNodes& B)
+	{
+		return A.Num() == B.Num()
+			&& FMemory::Memcmp(A.Positions.GetData(), B.Positions.GetData(), A.Positions.Num() * A.Positions.GetTypeSize()) == 0
+			&& FMemory::Memcmp(A.Planes.GetData(), B.Planes.GetData(), A.Planes.Num() * A.Planes.GetTypeSize()) == 0
+			&& FMemory::Memcmp(A.Links.GetData(), B.Links.GetData(), A.Links.Num() * A.Links.GetTypeSize()) == 0;
+	};
+
+	const FStalkerAIMapNodes& Serial = GenerateFromSeed(StalkerEditorAIMapTest::FSerialQuery(Collision))->Nodes;
+	TestTrue(TEXT("Floor is flooded"), Serial.Num() > 100);
+	for (int32 Run = 0; Run < 4; Run++)
+	{
+		TestTrue(FString::Printf(TEXT("Parallel run %d matches the serial one"), Run), IsSame(GenerateFromSeed(Collision)->Nodes, Serial));
+	}
+
+	const bool bNodeInBox = Serial.Positions.ContainsByPredicate([](const FVector3f& Position)
+	{
+		return Position.X > 250.f && Position.X < 350.f && Position.Y > -300.f && Position.Y < 300.f;
+	});
+	TestFalse(TEXT("No node inside the box"), bNodeInBox);
+	return true;
+}
+
+#endif
@@ -0,0 +1,485 @@
+#include "Misc/AutomationTest.h"
+#include "../Managers/Spawn/Constructor/Level/level_spawn_constructor.h"
+#include "../Managers/Spawn/Graph/Index/graph_point_index.h"
+#include "../Managers/Spawn/Graph/Builder/game_graph_builder.h"
+#include "../Managers/Spawn/Graph/Engine/graph_engine_editor_pool.h"
+#include "../Managers/AIMap/StalkerEditorAIMap.h"
+#include "Resources/AIMap/StalkerAIMap.h"
+#include "Resources/Spawn/StalkerGameLevelCrossTable.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerEditorArtefactSpawnShuffleTest, "Stalker.Editor.Spawn.ArtefactSpawnShuffle", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStalkerEditorArtefactSpawnShuffleTest::RunTest(const FString& Parameters)
+{
+	xr_vector<u32> Vertices(512);
+	for (u32 i = 0; i < Vertices.size(); i++)
+	{
+		Vertices[i] = i * 3;
+	}
+	LPCSTR ZoneNames[] = { "zone_mine_field_0000", "zone_mine_field_0001", "zone_radioactive_0000", "zone_mosquito_bald_0007" };
+	const int32 ZoneCount = UE_ARRAY_COUNT(ZoneNames);
+
+	// The same zone shuffled on several workers at once must come out identical every time
+	constexpr int32 Repeats = 8;
+	TArray<xr_vector<u32>> Shuffled;
+	Shuffled.SetNum(ZoneCount * Repeats);
+	ParallelFor(Shuffled.Num(), [&](int32 Index)
+	{
+		Shuffled[Index] = Vertices;
+		CLevelSpawnConstructor::shuffle_artefact_spawn_vertices(Shuffled[Index], 17, ZoneNames[Index % ZoneCount]);
+	});
+
+	for (int32 Zone = 0; Zone < ZoneCount; Zone++)
+	{
+		const xr_vector<u32>& First = Shuffled[Zone];
+		for (int32 Repeat = 1; Repeat < Repeats; Repeat++)
+		{
+			TestTrue(FString::Printf(TEXT("%s shuffles the same on every run"), ANSI_TO_TCHAR(ZoneNames[Zone])), Shuffled[Repeat * ZoneCount + Zone] == First);
+		}
+		xr_vector<u32> Sorted = First;
+		std::sort(Sorted.begin(), Sorted.end());
+		TestTrue(FString::Printf(TEXT("%s shuffle is a permutation"), ANSI_TO_TCHAR(ZoneNames[Zone])), Sorted == Vertices);
+		TestFalse(FString::Printf(TEXT("%s shuffle reorders"), ANSI_TO_TCHAR(ZoneNames[Zone])), First == Vertices);
+		for (int32 Other = 0; Other < Zone; Other++)
+		{
+			TestFalse(FString::Printf(TEXT("%s and %s get their own streams"), ANSI_TO_TCHAR(ZoneNames[Zone]), ANSI_TO_TCHAR(ZoneNames[Other])), First == Shuffled[Other]);
+		}
+	}
+
+	xr_vector<u32> OtherLevel = Vertices;
+	CLevelSpawnConstructor::shuffle_artefact_spawn_vertices(OtherLevel, 18, ZoneNames[0]);
+	TestFalse(TEXT("Level seed changes the shuffle"), OtherLevel == Shuffled[0]);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerEditorArtefactSpawnPositionsTest, "Stalker.Editor.Spawn.ArtefactSpawnPositions", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStalkerEditorArtefactSpawnPositionsTest::RunTest(const FString& Parameters)
+{
+	// Linked 64 x 64 grid with uneven heights as the level graph
+	UStalkerAIMap* AIMap = NewObject<UStalkerAIMap>(GetTransientPackage());
+	AIMap->HashClear();
+	FRandomStream Random(29);
+	for (int32 y = 0; y < 64; y++)
+	{
+		for (int32 x = 0; x < 64; x++)
+		{
+			const FVector3f Position(x * AIMap->NodeSize, y * AIMap->NodeSize, Random.FRandRange(0.f, 30.f));
+			const int32 Node = AIMap->FindOrCreateNode(Position, 1.f, true);
+			AIMap->Nodes.Planes[Node] = FPlane4f(Position, FVector3f(0, 0, 1));
+		}
+	}
+	for (int32 Node = 0; Node < AIMap->Nodes.Num(); Node++)
+	{
+		AIMap->AutoLink(Node, 50.f, 50.f);
+	}
+	UStalkerEditorAIMap::BuildLevelGraph(AIMap);
+	const u32 VertexCount = AIMap->header().vertex_count();
+	if (!TestEqual(TEXT("Level graph vertices"), VertexCount, u32(64 * 64)))
+	{
+		return false;
+	}
+
+	StalkerGameLevelCrossTable CrossTable;
+	CrossTable.Cells.AddDefaulted(VertexCount);
+	for (u32 Vertex = 0; Vertex < VertexCount; Vertex++)
+	{
+		CrossTable.Cells[Vertex].tGraphIndex = GameGraph::_GRAPH_ID(Vertex % 5);
+		CrossTable.Cells[Vertex].fDistance = float(Vertex % 13);
+	}
+
+	// Zones with overlapping radii, some asking for more positions than they cover
+	xr_vector<shared_str> Names;
+	CLevelSpawnConstructor::ARTEFACT_SPAWN_ZONES Zones;
+	for (int32 i = 0; i < 48; i++)
+	{
+		Names.push_back(shared_str(TCHAR_TO_ANSI(*FString::Printf(TEXT("zone_test_%04d"), i))));
+		const FVector3f Position(Random.FRandRange(0.f, 63.f) * AIMap->NodeSize, Random.FRandRange(0.f, 63.f) * AIMap->NodeSize, 15.f);
+		Zones.push_back({ *Names.back(), StalkerMath::UnrealLocationToXRay(Position), Random.FRandRange(1.f, 8.f), u32(-1), u32(Random.RandRange(1, 60)), 0 });
+	}
+
+	// Everything the zones hand to the game spawn: level points in order, per zone vertex, count and offset
+	auto Hash = [](const CLevelSpawnConstructor::ARTEFACT_SPAWN_ZONES& InZones, const CLevelSpawnConstructor::LEVEL_POINT_STORAGE& LevelPoints)
+	{
+		uint32 Result = 0;
+		for (const IGameGraph::CLevelPoint& LevelPoint : LevelPoints)
+		{
+			Result = FCrc::MemCrc32(&LevelPoint.tPoint, sizeof(LevelPoint.tPoint), Result);
+			Result = FCrc::MemCrc32(&LevelPoint.tNodeID, sizeof(LevelPoint.tNodeID), Result);
+			Result = FCrc::MemCrc32(&LevelPoint.fDistance, sizeof(LevelPoint.fDistance), Result);
+		}
+		for (const CLevelSpawnConstructor::SArtefactSpawnZone& Zone : InZones)
+		{
+			Result = FCrc::MemCrc32(&Zone.level_vertex_id, sizeof(Zone.level_vertex_id), Result);
+			Result = FCrc::MemCrc32(&Zone.artefact_spawn_count, sizeof(Zone.artefact_spawn_count), Result);
+			Result = FCrc::MemCrc32(&Zone.artefact_position_offset, sizeof(Zone.artefact_position_offset), Result);
+		}
+		return Result;
+	};
+
+	uint32 Expected = 0;
+	for (u32 EngineCount : { 1u, 2u, 3u, 8u, 8u })
+	{
+		CGraphEngineEditorPool GraphEngines(VertexCount, EngineCount);
+		CLevelSpawnConstructor::ARTEFACT_SPAWN_ZONES Result = Zones;
+		CLevelSpawnConstructor::LEVEL_POINT_STORAGE LevelPoints;
+		CLevelSpawnConstructor::find_artefact_spawn_positions(*AIMap, CrossTable, GraphEngines, 17, Result, LevelPoints);
+		const uint32 ResultHash = Hash(Result, LevelPoints);
+		if (EngineCount == 1)
+		{
+			Expected = ResultHash;
+			TestTrue(TEXT("Zones get positions"), LevelPoints.size() > Zones.size());
+			bool bClamped = false;
+			for (u32 Zone = 0; Zone < u32(Zones.size()); Zone++)
+			{
+				bClamped |= Result[Zone].artefact_spawn_count < Zones[Zone].artefact_spawn_count;
+			}
+			TestTrue(TEXT("Counts are clamped to the flooded area"), bClamped);
+			continue;
+		}
+		TestEqual(FString::Printf(TEXT("Spawn data with %u engines"), EngineCount), ResultHash, Expected);
+	}
+
+	CGraphEngineEditorPool GraphEngines(VertexCount, 4);
+	CLevelSpawnConstructor::ARTEFACT_SPAWN_ZONES Result = Zones;
+	CLevelSpawnConstructor::LEVEL_POINT_STORAGE LevelPoints;
+	CLevelSpawnConstructor::find_artefact_spawn_positions(*AIMap, CrossTable, GraphEngines, 18, Result, LevelPoints);
+	TestNotEqual(TEXT("Level seed changes the spawn data"), Hash(Result, LevelPoints), Expected);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerEditorGraphPointIndexTest, "Stalker.Editor.Spawn.GraphPointIndex", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStalkerEditorGraphPointIndexTest::RunTest(const FString& Parameters)
+{
+	// Random points with duplicates and near misses around cell borders, compared against the linear scan the index replaces
+	constexpr float Tolerance = 0.5f;
+	FRandomStream Random(11);
+	xr_vector<Fvector> Points;
+	for (int32 i = 0; i < 2000; i++)
+	{
+		Fvector Point;
+		if (Points.size() && Random.FRand() < 0.3f)
+		{
+			Point = Points[Random.RandHelper(Points.size())];
+			Point.x += Random.FRandRange(-2.f * Tolerance, 2.f * Tolerance);
+		}
+		else
+		{
+			Point.set(Random.RandRange(-40, 40) * Tolerance, Random.RandRange(-4, 4) * Tolerance, Random.RandRange(-40, 40) * Tolerance);
+		}
+		Points.push_back(Point);
+	}
+
+	CGraphPointIndex Index(Tolerance);
+	bool Mismatch = false;
+	for (u32 Id = 0; Id < Points.size(); Id++)
+	{
+		const Fvector& Point = Points[Id];
+		auto Predicate = [&Points, &Point, Tolerance](u32 Other) { return Points[Other].similar(Point, Tolerance); };
+		u32 Expected = u32(-1);
+		for (u32 Other = 0; Other < Id; Other++)
+		{
+			if (Predicate(Other))
+			{
+				Expected = Other;
+				break;
+			}
+		}
+		const u32 Found = Index.find(Point, Predicate);
+		if (Found != Expected)
+		{
+			AddError(FString::Printf(TEXT("Point %u found %d, linear scan found %d"), Id, int32(Found), int32(Expected)));
+			Mismatch = true;
+		}
+		Index.add(Point, Id);
+	}
+	TestFalse(TEXT("Index matches the linear scan"), Mismatch);
+
+	Index.clear();
+	TestEqual(TEXT("Cleared index finds nothing"), Index.find(Points[0], [](u32) { return true; }), u32(-1));
+	return true;
+}
+
+namespace StalkerEditorSpawnTest
+{
+	// The nested scans the level changer resolution used before the indices
+	void ResolveLevelChangerTargetsReference(const CLevelSpawnConstructor::NAMED_POINTS& GraphPoints, const xr_vector<std::pair<u32, Fvector>>& GameVertices, const xr_vector<shared_str>& Targets, xr_vector<std::pair<u32, u32>>& Results)
+	{
+		Results.assign(Targets.size(), std::make_pair(u32(-1), u32(-1)));
+		for (u32 Target = 0; Target < Targets.size(); Target++)
+		{
+			for (u32 GraphPoint = 0; GraphPoint < GraphPoints.size(); GraphPoint++)
+			{
+				if (xr_strcmp(GraphPoints[GraphPoint].name, Targets[Target]))
+				{
+					continue;
+				}
+				Results[Target].first = GraphPoint;
+				for (const std::pair<u32, Fvector>& GameVertex : GameVertices)
+				{
+					if (GameVertex.second.similar(GraphPoints[GraphPoint].position, .001f))
+					{
+						Results[Target].second = GameVertex.first;
+						break;
+					}
+				}
+				break;
+			}
+		}
+	}
+
+	// The per graph point BFS over a dense distance matrix that the cross table used before the multi-source BFS
+	void NearestGraphPointsReference(const TArray<TArray<u32>>& Links, const xr_vector<u32>& GraphPoints, xr_vector<u32>& Results, xr_vector<u32>& Distances)
+	{
+		const u32 VertexCount = Links.Num();
+		xr_vector<bool> Marks(VertexCount, false);
+		for (u32 GraphPoint : GraphPoints)
+		{
+			xr_vector<u32> Stack = { GraphPoint };
+			while (!Stack.empty())
+			{
+				const u32 Vertex = Stack.back();
+				Stack.pop_back();
+				Marks[Vertex] = true;
+				for (u32 Next : Links[Vertex])
+				{
+					if (!Marks[Next])
+					{
+						Stack.push_back(Next);
+					}
+				}
+			}
+		}
+		Marks.flip();
+
+		xr_vector<xr_vector<u32>> Matrix(GraphPoints.size(), xr_vector<u32>(VertexCount, u32(-1)));
+		Results.assign(VertexCount, 0);
+		for (u32 GameVertex = 0; GameVertex < GraphPoints.size(); GameVertex++)
+		{
+			xr_vector<u32>& Row = Matrix[GameVertex];
+			Matrix[Results[GraphPoints[GameVertex]]][GraphPoints[GameVertex]] = u32(-1);
+			xr_vector<u32> Current = { GraphPoints[GameVertex] };
+			xr_vector<u32> Next;
+			for (u32 Distance = 0; !Current.empty(); Distance++)
+			{
+				for (u32 Vertex : Current)
+				{
+					check(Distance < Matrix[Results[Vertex]][Vertex]);
+					Results[Vertex] = GameVertex;
+					Row[Vertex] = Distance;
+					for (u32 Neighbour : Links[Vertex])
+					{
+						if (Marks[Neighbour] || Row[Neighbour] <= Distance || Matrix[Results[Neighbour]][Neighbour] <= Distance + 1)
+						{
+							continue;
+						}
+						Next.push_back(Neighbour);
+						Marks[Neighbour] = true;
+					}
+				}
+				for (u32 Vertex : Current)
+				{
+					Marks[Vertex] = false;
+				}
+				Current = Next;
+				Next.clear();
+			}
+		}
+
+		Distances.resize(VertexCount);
+		for (u32 Vertex = 0; Vertex < VertexCount; Vertex++)
+		{
+			Distances[Vertex] = Matrix[Results[Vertex]][Vertex];
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerEditorCrossTableTest, "Stalker.Editor.Spawn.CrossTable", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStalkerEditorCrossTableTest::RunTest(const FString& Parameters)
+{
+	// 4-connected grid with holes and a walled off island, graph points on a lattice so that many vertices are equally far from two or more of them
+	constexpr int32 Size = 48;
+	FRandomStream Random(23);
+	TArray<int32> VertexIds;
+	VertexIds.Init(INDEX_NONE, Size * Size);
+	TArray<TArray<u32>> Links;
+	for (int32 y = 0; y < Size; y++)
+	{
+		for (int32 x = 0; x < Size; x++)
+		{
+			if (Random.FRand() < 0.1f || x == Size - 8)
+			{
+				continue;
+			}
+			VertexIds[y * Size + x] = Links.Num();
+			Links.AddDefaulted();
+		}
+	}
+	for (int32 y = 0; y < Size; y++)
+	{
+		for (int32 x = 0; x < Size; x++)
+		{
+			const int32 Vertex = VertexIds[y * Size + x];
+			if (Vertex == INDEX_NONE)
+			{
+				continue;
+			}
+			const int32 Neighbours[4] = { x + 1 < Size ? VertexIds[y * Size + x + 1] : INDEX_NONE, y + 1 < Size ? VertexIds[(y + 1) * Size + x] : INDEX_NONE, x > 0 ? VertexIds[y * Size + x - 1] : INDEX_NONE, y > 0 ? VertexIds[(y - 1) * Size + x] : INDEX_NONE };
+			for (int32 Neighbour : Neighbours)
+			{
+				if (Neighbour != INDEX_NONE)
+				{
+					Links[Vertex].Add(Neighbour);
+				}
+			}
+		}
+	}
+
+	xr_vector<u32> GraphPoints;
+	for (int32 y = 4; y < Size; y += 10)
+	{
+		for (int32 x = 4; x < Size - 8; x += 10)
+		{
+			if (VertexIds[y * Size + x] != INDEX_NONE)
+			{
+				GraphPoints.push_back(VertexIds[y * Size + x]);
+			}
+		}
+	}
+	// Ids out of spatial order so ties are not always won by the graph point on the left
+	std::reverse(GraphPoints.begin() + GraphPoints.size() / 2, GraphPoints.end());
+
+	xr_vector<u32> ExpectedResults, ExpectedDistances;
+	StalkerEditorSpawnTest::NearestGraphPointsReference(Links, GraphPoints, ExpectedResults, ExpectedDistances);
+
+	xr_vector<u32> Results, Distances, CurrentFringe, NextFringe;
+	CGameGraphBuilder::nearest_graph_points(Links.Num(), GraphPoints, [&Links](u32 Vertex, const auto& Visit)
+	{
+		for (u32 Next : Links[Vertex])
+		{
+			Visit(Next);
+		}
+	}, Results, Distances, CurrentFringe, NextFringe);
+
+	int32 NumTies = 0;
+	for (u32 Vertex = 0; Vertex < u32(Links.Num()); Vertex++)
+	{
+		int32 NumAtDistance = 0;
+		for (u32 Other : Links[Vertex])
+		{
+			NumAtDistance += Distances[Other] + 1 == Distances[Vertex] && Results[Other] != Results[Vertex];
+		}
+		NumTies += NumAtDistance > 0;
+	}
+
+	TestTrue(TEXT("Graph has equal distance ties"), NumTies > 0);
+	TestTrue(TEXT("Graph has unreached vertices"), std::find(Distances.begin(), Distances.end(), u32(-1)) != Distances.end());
+	TestTrue(TEXT("Owners are identical"), Results == ExpectedResults);
+	TestTrue(TEXT("Distances are identical"), Distances == ExpectedDistances);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerEditorLevelChangerTargetsTest, "Stalker.Editor.Spawn.LevelChangerTargets", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FStalkerEditorLevelChangerTargetsTest::RunTest(const FString& Parameters)
+{
+	const Fvector PositionA = { 1.f, 0.f, 1.f };
+	const Fvector PositionB = { 5.f, 0.f, 1.f };
+	const Fvector PositionA2 = { 9.f, 0.f, 1.f };
+	const Fvector PositionC = { 13.f, 0.f, 1.f };
+	const CLevelSpawnConstructor::NAMED_POINTS GraphPoints = { { "point_a", PositionA }, { "point_b", PositionB }, { "point_a", PositionA2 }, { "point_c", PositionC } };
+	// Two vertices at the first position, the earlier one wins even with the higher id
+	const xr_vector<std::pair<u32, Fvector>> GameVertices = { { 7, PositionA2 }, { 12, PositionA }, { 3, PositionA }, { 9, Fvector().set(5.0004f, 0.f, 1.f) } };
+	const xr_vector<shared_str> Targets = { "point_a", "point_b", "point_c", "point_d", "point_a" };
+
+	xr_vector<std::pair<u32, u32>> Results;
+	CLevelSpawnConstructor::resolve_level_changer_targets(GraphPoints, GameVertices, Targets, Results);
+	if (!TestEqual(TEXT("Result count"), u32(Results.size()), u32(Targets.size())))
+	{
+		return false;
+	}
+	TestEqual(TEXT("First graph point with a duplicated name wins"), Results[0].first, 0u);
+	TestEqual(TEXT("First game vertex at the position wins"), Results[0].second, 12u);
+	TestEqual(TEXT("Graph point b"), Results[1].first, 1u);
+	TestEqual(TEXT("Game vertex within the tolerance"), Results[1].second, 9u);
+	TestEqual(TEXT("Graph point without a game vertex"), Results[2].first, 3u);
+	TestEqual(TEXT("Missing game vertex"), Results[2].second, u32(-1));
+	TestEqual(TEXT("Missing graph point"), Results[3].first, u32(-1));
+	TestTrue(TEXT("Repeated target resolves the same"), Results[4] == Results[0]);
+
+	xr_vector<std::pair<u32, u32>> Expected;
+	StalkerEditorSpawnTest::ResolveLevelChangerTargetsReference(GraphPoints, GameVertices, Targets, Expected);
+	TestTrue(TEXT("Index matches the nested scans"), Results == Expected);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStalkerEditorLevelChangerTargetsBenchmark, "Stalker.Editor.Spawn.LevelChangerTargetsBenchmark", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+bool FStalkerEditorLevelChangerTargetsBenchmark::RunTest(const FString& Parameters)
+{
+	// 10k graph points with a game vertex each, 2k changers of which every tenth targets a missing point
+	FRandomStream Random(31);
+	CLevelSpawnConstructor::NAMED_POINTS GraphPoints;
+	xr_vector<std::pair<u32, Fvector>> GameVertices;
+	for (u32 i = 0; i < 10000; i++)
+	{
+		const Fvector Position = { Random.FRandRange(-1000.f, 1000.f), Random.FRandRange(-50.f, 50.f), Random.FRandRange(-1000.f, 1000.f) };
+		GraphPoints.push_back({ shared_str(TCHAR_TO_ANSI(*FString::Printf(TEXT("graph_point_%05u"), i))), Position });
+		GameVertices.push_back(std::make_pair(i, Position));
+	}
+	xr_vector<shared_str> Targets;
+	for (u32 i = 0; i < 2000; i++)
+	{
+		const u32 GraphPoint = Random.RandRange(0, 9999);
+		Targets.push_back(i % 10 ? GraphPoints[GraphPoint].name : shared_str(TCHAR_TO_ANSI(*FString::Printf(TEXT("missing_point_%05u"), i))));
+	}
+
+	xr_vector<std::pair<u32, u32>> Results;
+	double StartTime = FPlatformTime::Seconds();
+	CLevelSpawnConstructor::resolve_level_changer_targets(GraphPoints, GameVertices, Targets, Results);
+	const double IndexTime = FPlatformTime::Seconds() - StartTime;
+
+	xr_vector<std::pair<u32, u32>> Expected;
+	StartTime = FPlatformTime::Seconds();
+	StalkerEditorSpawnTest::ResolveLevelChangerTargetsReference(GraphPoints, GameVertices, Targets, Expected);
+	const double ScanTime = FPlatformTime::Seconds() - StartTime;
+
+	// Duplicate checks of load_graph_point, index against the pairwise scan
+	CGraphPointIndex Index(_sqrt(EPS_L));
+	u32 NumIndexDuplicates = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (u32 i = 0; i < GraphPoints.size(); i++)
+	{
+		const Fvector& Position = GraphPoints[i].position;
+		NumIndexDuplicates += Index.find(Position, [&GraphPoints, &Position](u32 Other) { return GraphPoints[Other].position.distance_to_sqr(Position) < EPS_L; }) != u32(-1);
+		Index.add(Position, i);
+	}
+	const double IndexDuplicatesTime = FPlatformTime::Seconds() - StartTime;
+
+	u32 NumScanDuplicates = 0;
+	StartTime = FPlatformTime::Seconds();
+	for (u32 i = 0; i < GraphPoints.size(); i++)
+	{
+		for (u32 Other = 0; Other < i; Other++)
+		{
+			if (GraphPoints[Other].position.distance_to_sqr(GraphPoints[i].position) < EPS_L)
+			{
+				NumScanDuplicates++;
+				break;
+			}
+		}
+	}
+	const double ScanDuplicatesTime = FPlatformTime::Seconds() - StartTime;
+
+	TestTrue(TEXT("Index matches the nested scans"), Results == Expected);
+	TestEqual(TEXT("Duplicate counts match"), NumIndexDuplicates, NumScanDuplicates);
+	AddInfo(FString::Printf(TEXT("%u graph points, %u changers: resolve %.2f ms (scan %.2f ms), duplicate checks %.2f ms (scan %.2f ms)"),
+		u32(GraphPoints.size()), u32(Targets.size()), IndexTime * 1000.0, ScanTime * 1000.0, IndexDuplicatesTime * 1000.0, ScanDuplicatesTime * 1000.0));
+	return true;
+}
+
+#endif
@@ -55,7 +55,7 @@ void FStalkerAIMapEditMode::Render(const FSceneView* View, FViewport* Viewport,
 		return FVector2f(static_cast<float>(Node % 4) * 0.25f, static_cast<float>(Node / 4) * 0.25f);
 	};
 	int32 CountNode =0;
-	auto DrawNode = [View, Viewport, PDI, this, NodeToUV, StalkerWorldSettings, NodeSize, &CountNode](FDynamicMeshBuilder&MeshBuilder,FPlane4f&NodePlane,int32 Node, float x, float y, float z, bool IsSelected)
+	auto DrawNode = [View, Viewport, PDI, this, NodeToUV, StalkerWorldSettings, NodeSize, &CountNode](FDynamicMeshBuilder&MeshBuilder,const FPlane4f&NodePlane,int32 Node, float x, float y, float z, bool IsSelected)
 	{ 
 		const FVector3f PlaneNormalRender = FVector3f(0,0,1);
 		FVector3f Vertex1 = FMath::RayPlaneIntersection(FVector3f(x - NodeSize, y - NodeSize, z), PlaneNormalRender, NodePlane);
@@ -79,35 +79,36 @@ void FStalkerAIMapEditMode::Render(const FSceneView* View, FViewport* Viewport,
 	MeshBuilder.ReserveTriangles(70 * 70 * 2);
 	MeshBuilder.ReserveVertices(70 * 70 * 4);
 	FMeshBatch Mesh;
-	for (FStalkerAIMapNode* Node : StalkerAIMap->Nodes)
+	const FStalkerAIMapNodes& Nodes = StalkerAIMap->Nodes;
+	for (int32 Node = 0; Node < Nodes.Num(); Node++)
 	{
+		const FVector3f& Position = Nodes.Positions[Node];
+		if (FVector::DistXY(View->ViewLocation,FVector(Position)) >= DistanceRenderAIMap * 100.0)
+		{
+			continue;
+		}
+		const FStalkerAIMapNodeLinks& Links = Nodes.Links[Node];
 		int32 NodeLink = 0;
-		if (Node->NodeLeft)
+		if (Links[0] != INDEX_NONE)
 		{
 			NodeLink |= 1 << 2;
 		}
-		if (Node->NodeForward)
+		if (Links[1] != INDEX_NONE)
 		{
 			NodeLink |= 1 << 3;
 		}
-		if (Node->NodeRight)
+		if (Links[2] != INDEX_NONE)
 		{
 			NodeLink |= 1 << 0;
 		}
-		if (Node->NodeBackward)
+		if (Links[3] != INDEX_NONE)
 		{
 			NodeLink |= 1 << 1;
 		}
-		
-		
-		if (FVector::DistXY(View->ViewLocation,FVector(Node->Position)) < DistanceRenderAIMap * 100.0)
-		{
-			DrawNode(MeshBuilder, Node->Plane, NodeLink, Node->Position.X, Node->Position.Y, Node->Position.Z, EnumHasAnyFlags(Node->Flags, EStalkerAIMapNodeFlags::Selected));
-		}
-		
+		DrawNode(MeshBuilder, Nodes.Planes[Node], NodeLink, Position.X, Position.Y, Position.Z, Nodes.IsSelected(Node));
 	}
 
-	PDI->SetHitProxy(new HStalkerAIMapNodeProxy(nullptr));
+	PDI->SetHitProxy(new HStalkerAIMapNodeProxy());
 	MeshBuilder.Draw(PDI, FMatrix::Identity, StalkerWorldSettings->EditorMaterialAIMap->GetRenderProxy(), SDPG_World, true,false);
 	PDI->SetHitProxy(nullptr);
 
@@ -138,14 +139,17 @@ bool FStalkerAIMapEditMode::HandleClick(FEditorViewportClient* InViewportClient,
 
 	const float NodeSize = (StalkerAIMap->NodeSize) * 0.5f;
 
-	auto GetBox = [NodeSize](FStalkerAIMapNode* Node)
+	const FStalkerAIMapNodes& AIMapNodes = StalkerAIMap->Nodes;
+	auto GetBox = [NodeSize, &AIMapNodes](int32 Node)
 	{
 		FBox AABB = FBox(ForceInit);
 		const FVector3f PlaneNormalRender = FVector3f(0, 0, 1);
-		FVector3f Vertex1 = FMath::RayPlaneIntersection(Node->Position + FVector3f(-NodeSize, -NodeSize, -2.f), PlaneNormalRender, Node->Plane);
-		FVector3f Vertex2 = FMath::RayPlaneIntersection(Node->Position + FVector3f(-NodeSize, +NodeSize, 2.f), PlaneNormalRender, Node->Plane);
-		FVector3f Vertex3 = FMath::RayPlaneIntersection(Node->Position + FVector3f(+NodeSize, -NodeSize, -2.f), PlaneNormalRender, Node->Plane);
-		FVector3f Vertex4 = FMath::RayPlaneIntersection(Node->Position + FVector3f(+NodeSize, +NodeSize, 2.f), PlaneNormalRender, Node->Plane);
+		const FVector3f& Position = AIMapNodes.Positions[Node];
+		const FPlane4f& Plane = AIMapNodes.Planes[Node];
+		FVector3f Vertex1 = FMath::RayPlaneIntersection(Position + FVector3f(-NodeSize, -NodeSize, -2.f), PlaneNormalRender, Plane);
+		FVector3f Vertex2 = FMath::RayPlaneIntersection(Position + FVector3f(-NodeSize, +NodeSize, 2.f), PlaneNormalRender, Plane);
+		FVector3f Vertex3 = FMath::RayPlaneIntersection(Position + FVector3f(+NodeSize, -NodeSize, -2.f), PlaneNormalRender, Plane);
+		FVector3f Vertex4 = FMath::RayPlaneIntersection(Position + FVector3f(+NodeSize, +NodeSize, 2.f), PlaneNormalRender, Plane);
 		AABB += FVector(Vertex1);
 		AABB += FVector(Vertex2);
 		AABB += FVector(Vertex3);
@@ -154,21 +158,25 @@ bool FStalkerAIMapEditMode::HandleClick(FEditorViewportClient* InViewportClient,
 	};
 
 
-	FStalkerAIMapNode*ClickNode = nullptr;
+	int32 ClickNode = INDEX_NONE;
 	if (HitProxy && HitProxy->IsA(HStalkerAIMapNodeProxy::StaticGetType()))
 	{
-		ClickNode = StalkerAIMap->FindNode(FVector3f(GEditor->ClickLocation+FVector(StalkerAIMap->NodeSize*0.5f, StalkerAIMap->NodeSize * 0.5f,0)),50.f);
+		ClickNode = StalkerAIMap->Nodes.Resolve(static_cast<HStalkerAIMapNodeProxy*>(HitProxy)->Node);
+		if (ClickNode == INDEX_NONE)
+		{
+			ClickNode = StalkerAIMap->FindNode(FVector3f(GEditor->ClickLocation+FVector(StalkerAIMap->NodeSize*0.5f, StalkerAIMap->NodeSize * 0.5f,0)),50.f);
+		}
 		if (false)
 		{
 			FVector ResultLocation, ResultNormal; float HitTime;
 			FVector EndRay = Click.GetOrigin() + Click.GetDirection() * WORLD_MAX;
 			
-			TArray<FStalkerAIMapNode*>* Nodes = StalkerAIMap->GetEditorHashMap(FVector3f(GEditor->ClickLocation + FVector(StalkerAIMap->NodeSize * 0.5f, StalkerAIMap->NodeSize * 0.5f, 0)));
+			const FStalkerAIMapSpatialIndex::FCell* Nodes = StalkerAIMap->NodesIndex.FindCell(FVector3f(GEditor->ClickLocation + FVector(StalkerAIMap->NodeSize * 0.5f, StalkerAIMap->NodeSize * 0.5f, 0)));
 			if (Nodes)
 			{
-				for (FStalkerAIMapNode* Node : *Nodes)
+				for (int32 Node : *Nodes)
 				{
-					if (FMath::LineSphereIntersection(Click.GetOrigin(), Click.GetDirection(), WORLD_MAX, FVector(Node->Position), double(NodeSize)))
+					if (FMath::LineSphereIntersection(Click.GetOrigin(), Click.GetDirection(), WORLD_MAX, FVector(AIMapNodes.Positions[Node]), double(NodeSize)))
 					{
 						if (FMath::LineExtentBoxIntersection(GetBox(Node), Click.GetOrigin(), EndRay, FVector(0, 0, 0), ResultLocation, ResultNormal, HitTime))
 						{
@@ -183,13 +191,13 @@ bool FStalkerAIMapEditMode::HandleClick(FEditorViewportClient* InViewportClient,
 	}
 	if ((!bIsAddMode && Click.GetKey() == EKeys::LeftMouseButton) || (!bIsSelected  && !Click.IsControlDown() && Click.GetKey() == EKeys::RightMouseButton))
 	{
-		if (ClickNode)
+		if (ClickNode != INDEX_NONE)
 		{
 			if (!Click.IsControlDown())
 			{
 				 ClearSelectionNodes();
 			}
-			if (EnumHasAnyFlags(ClickNode->Flags, EStalkerAIMapNodeFlags::Selected))
+			if (StalkerAIMap->Nodes.IsSelected(ClickNode))
 			{
 				StalkerAIMap->UnSelectNode(ClickNode);
 			}
@@ -223,13 +231,13 @@ bool FStalkerAIMapEditMode::HandleClick(FEditorViewportClient* InViewportClient,
 			{
 				int32 Index = GEditor->BeginTransaction(FText::FromString(TEXT("Add AI Map Node")));
 				StalkerAIMap->PreEditChange(nullptr);
-				FStalkerAIMapNode* NewNode = StalkerAIMap->FindNode(TempNode.Position, 1.f);
-				if (!NewNode)
+				int32 NewNode = StalkerAIMap->FindNode(TempNode.Position, 1.f);
+				if (NewNode == INDEX_NONE)
 				{
-					NewNode = StalkerAIMap->FindOrCreateNode(TempNode.Position, 1.f,false,false);
-					check(NewNode);
+					NewNode = StalkerAIMap->FindOrCreateNode(TempNode.Position, 1.f,false);
+					check(NewNode != INDEX_NONE);
 					StalkerAIMap->MarkPackageDirty();
-					NewNode->Plane = TempNode.Plane;
+					StalkerAIMap->Nodes.Planes[NewNode] = TempNode.Plane;
 					if(bAutoLink)GStalkerEditorManager->EditorAIMap->AutoLink(World, NewNode,bIgnoreConstraints);
 					StalkerAIMap->PostEditChange();
 					GEditor->EndTransaction();
@@ -403,31 +411,31 @@ bool FStalkerAIMapEditMode::BoxSelect(FBox& InBox, bool InSelect /*= true*/)
 			return false;
 		}
 		const float NodeSize = StalkerAIMap->NodeSize;
-		auto GetBox = [NodeSize](FStalkerAIMapNode* Node)
+		auto GetBox = [NodeSize, StalkerAIMap](int32 Node)
 		{
 			FBox AABB = FBox(ForceInit);
-			AABB +=FVector(Node->Position + FVector3f(NodeSize * 0.5f, NodeSize * 0.5f, 2.f));
-			AABB += FVector(Node->Position + FVector3f(-NodeSize * 0.5f, -NodeSize * 0.5f, -2.f));
+			AABB += FVector(StalkerAIMap->Nodes.Positions[Node] + FVector3f(NodeSize * 0.5f, NodeSize * 0.5f, 2.f));
+			AABB += FVector(StalkerAIMap->Nodes.Positions[Node] + FVector3f(-NodeSize * 0.5f, -NodeSize * 0.5f, -2.f));
 			return AABB;
 		};
 
 		bIsAddMode = false;
 		
 		ClearSelectionNodes();
-		for (FStalkerAIMapNode* Node : StalkerAIMap->Nodes)
+		for (int32 Node = 0; Node < StalkerAIMap->Nodes.Num(); Node++)
 		{
 			if (bStrictDragSelection)
 			{
 				if (InBox.IsInside(GetBox(Node)))
 				{
-					Node->Flags |= EStalkerAIMapNodeFlags::Selected;
+					StalkerAIMap->Nodes.Flags[Node] |= EStalkerAIMapNodeFlags::Selected;
 				}
 			}
 			else
 			{
 				if (InBox.Intersect(GetBox(Node)))
 				{
-					Node->Flags |= EStalkerAIMapNodeFlags::Selected;
+					StalkerAIMap->Nodes.Flags[Node] |= EStalkerAIMapNodeFlags::Selected;
 				}
 			}
 			
@@ -466,22 +474,22 @@ bool FStalkerAIMapEditMode::FrustumSelect(const FConvexVolume& InFrustum, FEdito
 			return false;
 		}
 		const float NodeSize = StalkerAIMap->NodeSize;
-		auto GetBox = [NodeSize](FStalkerAIMapNode* Node)
+		auto GetBox = [NodeSize, StalkerAIMap](int32 Node)
 		{
 			FBox AABB = FBox(ForceInit);
-			AABB += FVector(Node->Position + FVector3f(NodeSize * 0.5f, NodeSize * 0.5f, 2.f));
-			AABB += FVector(Node->Position + FVector3f(-NodeSize * 0.5f, -NodeSize * 0.5f, -2.f));
+			AABB += FVector(StalkerAIMap->Nodes.Positions[Node] + FVector3f(NodeSize * 0.5f, NodeSize * 0.5f, 2.f));
+			AABB += FVector(StalkerAIMap->Nodes.Positions[Node] + FVector3f(-NodeSize * 0.5f, -NodeSize * 0.5f, -2.f));
 			return AABB;
 		};
 		ClearSelectionNodes();
-		for (FStalkerAIMapNode* Node : StalkerAIMap->Nodes)
+		for (int32 Node = 0; Node < StalkerAIMap->Nodes.Num(); Node++)
 		{
 			FBox Box = GetBox(Node);
 			bool IsInside = false;
 			bool Intersect = InFrustum.IntersectBox(Box.GetCenter(), Box.GetExtent(), IsInside);
 			if (Intersect && (!bStrictDragSelection || IsInside))
 			{
-				Node->Flags |= EStalkerAIMapNodeFlags::Selected;
+				StalkerAIMap->Nodes.Flags[Node] |= EStalkerAIMapNodeFlags::Selected;
 			}
 		}
 		StalkerAIMap->RefreshHashSelected();
@@ -513,19 +521,20 @@ bool FStalkerAIMapEditMode::InputDelta(FEditorViewportClient* InViewportClient,
 	{
 		return false;
 	}
-	TArray< FStalkerAIMapNode*> Nodes;
+	TArray<int32> Nodes;
 	StalkerAIMap->GetSelectedNodes(Nodes);
-	for (FStalkerAIMapNode* Node : Nodes)
+	for (int32 Node : Nodes)
 	{
 		StalkerAIMap->NeedRebuild = true;
-		Node->Position.Z += InDrag.Z;
-		FVector3f NewNormal = Node->Plane.GetNormal() + (FVector3f(InRot.Quaternion().GetUpVector()) - FVector3f(0, 0, 1));
+		StalkerAIMap->SetNodeHeight(Node, StalkerAIMap->Nodes.Positions[Node].Z + InDrag.Z);
+		FPlane4f& Plane = StalkerAIMap->Nodes.Planes[Node];
+		FVector3f NewNormal = Plane.GetNormal() + (FVector3f(InRot.Quaternion().GetUpVector()) - FVector3f(0, 0, 1));
 		NewNormal.Normalize();
 		if (FMath::RadiansToDegrees(FMath::Acos(NewNormal | FVector3f(0, 0, 1))) > 75.f)
 		{
-			NewNormal = Node->Plane.GetNormal();
+			NewNormal = Plane.GetNormal();
 		}
-		Node->Plane = FPlane4f(Node->Position, NewNormal);
+		Plane = FPlane4f(StalkerAIMap->Nodes.Positions[Node], NewNormal);
 	}
 	return true;
 }
@@ -548,10 +557,10 @@ FVector FStalkerAIMapEditMode::GetWidgetLocation() const
 	{
 		return  FEdMode::GetWidgetLocation();
 	}
-	FStalkerAIMapNode* Node;
+	int32 Node;
 	if (StalkerAIMap->GetFirstSelectedNode(Node))
 	{
-		return FVector(Node->Position);
+		return FVector(StalkerAIMap->Nodes.Positions[Node]);
 	}
 	return FEdMode::GetWidgetLocation();
 }
@@ -585,7 +594,7 @@ bool FStalkerAIMapEditMode::ShouldDrawWidget() const
 	{
 		return false;
 	}
-	FStalkerAIMapNode* Node;
+	int32 Node;
 	if (StalkerAIMap->GetFirstSelectedNode(Node))
 	{
 		return true;
@@ -698,49 +707,50 @@ void FStalkerAIMapEditMode::Link(int32 ID)
 	
 	int32 Link = ConvertV2L(ID);
 
+	FStalkerAIMapNodes& Nodes = StalkerAIMap->Nodes;
 	if (LinkMode == LM_Remove)
 	{
-		for (FStalkerAIMapNode* Node : StalkerAIMap->Nodes)
+		for (int32 Node = 0; Node < Nodes.Num(); Node++)
 		{
-			if (EnumHasAnyFlags(Node->Flags, EStalkerAIMapNodeFlags::Selected))
+			if (Nodes.IsSelected(Node))
 			{
 				StalkerAIMap->NeedRebuild = true;
-				Node->Nodes[Link] = nullptr;
+				Nodes.Links[Node][Link] = INDEX_NONE;
 			}
 		}
 	}
 	if (LinkMode == LM_Add)
 	{
-		for (FStalkerAIMapNode* Node : StalkerAIMap->Nodes)
+		for (int32 Node = 0; Node < Nodes.Num(); Node++)
 		{
 
-			if (EnumHasAnyFlags(Node->Flags, EStalkerAIMapNodeFlags::Selected))
+			if (Nodes.IsSelected(Node))
 			{
 				StalkerAIMap->NeedRebuild = true;
-				if(!Node->Nodes[Link]) 
-					Node->Nodes[Link] = StalkerAIMap->FindNeighbour(Node, Link);
+				if(Nodes.Links[Node][Link] == INDEX_NONE) 
+					Nodes.Links[Node][Link] = StalkerAIMap->FindNeighbour(Node, Link, StalkerWorldSettings->AIMapCanDOWN, StalkerWorldSettings->AIMapCanUP);
 			}
 		}
 	}
 	if (LinkMode == LM_Invert)
 	{
 		static const int32 InvertLink[4] = { 2,3,0,1 };
-		for (FStalkerAIMapNode* Node : StalkerAIMap->Nodes)
+		for (int32 Node = 0; Node < Nodes.Num(); Node++)
 		{
-			if (EnumHasAnyFlags(Node->Flags, EStalkerAIMapNodeFlags::Selected))
+			if (Nodes.IsSelected(Node))
 			{
-				FStalkerAIMapNode* Neighbour = StalkerAIMap->FindNeighbour(Node, Link);
-				if (!Neighbour)
+				const int32 Neighbour = StalkerAIMap->FindNeighbour(Node, Link, StalkerWorldSettings->AIMapCanDOWN, StalkerWorldSettings->AIMapCanUP);
+				if (Neighbour == INDEX_NONE)
 				{
 					continue;
 				}
-				if (!Node->Nodes[Link] || !Neighbour->Nodes[InvertLink[Link]])
+				if (Nodes.Links[Node][Link] == INDEX_NONE || Nodes.Links[Neighbour][InvertLink[Link]] == INDEX_NONE)
 				{
 					StalkerAIMap->NeedRebuild = true;
-					FStalkerAIMapNode* SwapNode1 = Node->Nodes[Link];
-					FStalkerAIMapNode* SwapNode2 = Neighbour->Nodes[InvertLink[Link]];
-					Node->Nodes[Link] = SwapNode2 ? Neighbour : nullptr;
-					Neighbour->Nodes[InvertLink[Link]] = SwapNode1 ? Node : nullptr;
+					const int32 SwapNode1 = Nodes.Links[Node][Link];
+					const int32 SwapNode2 = Nodes.Links[Neighbour][InvertLink[Link]];
+					Nodes.Links[Node][Link] = SwapNode2 != INDEX_NONE ? Neighbour : INDEX_NONE;
+					Nodes.Links[Neighbour][InvertLink[Link]] = SwapNode1 != INDEX_NONE ? Node : INDEX_NONE;
 
 				}
 			}
@@ -788,7 +798,7 @@ bool FStalkerAIMapEditMode::StartTracking(FEditorViewportClient* InViewportClien
 		return  false;
 	}
 	bool NeedBeginTransaction = false;
-	FStalkerAIMapNode* Node;
+	int32 Node;
 	if (StalkerAIMap->GetFirstSelectedNode(Node))
 	{
 		NeedBeginTransaction = true;
@@ -817,7 +827,7 @@ bool FStalkerAIMapEditMode::EndTracking(FEditorViewportClient* InViewportClient,
 		return  false;
 	}
 	bool NeedBeginTransaction = false;
-	FStalkerAIMapNode* Node;
+	int32 Node;
 	if (StalkerAIMap->GetFirstSelectedNode(Node))
 	{
 		NeedBeginTransaction = true;
@@ -916,14 +926,7 @@ bool FStalkerAIMapEditMode::CanRemoveSelectNodes()
 	{
 		return false;
 	}
-	for (FStalkerAIMapNode* Node : StalkerAIMap->Nodes)
-	{
-		if (EnumHasAnyFlags(Node->Flags, EStalkerAIMapNodeFlags::Selected))
-		{
-			return true;
-		}
-	}
-	return false;
+	return StalkerAIMap->HasSelected();
 }
 
 void FStalkerAIMapEditMode::SmoothFull()
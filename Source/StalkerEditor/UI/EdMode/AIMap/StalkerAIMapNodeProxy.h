@@ -4,8 +4,8 @@ struct HStalkerAIMapNodeProxy : public HHitProxy
 {
 	DECLARE_HIT_PROXY();
 
-	HStalkerAIMapNodeProxy(FStalkerAIMapNode* InNode)
+	HStalkerAIMapNodeProxy(FStalkerAIMapNodeHandle InNode = FStalkerAIMapNodeHandle())
 		: HHitProxy(HPP_World),Node(InNode)
 	{}
-	FStalkerAIMapNode*Node;
+	FStalkerAIMapNodeHandle Node;
 };